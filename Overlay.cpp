@@ -27,6 +27,7 @@ SOFTWARE.
 #include <windowsx.h>
 #include "Overlay.h"
 #include "Config.h"
+#include "iracing.h"
 
 #if defined(_DEBUG) or defined(DEBUG_OVERLAY_TIME)
     #include "OverlayDebug.h"
@@ -213,6 +214,7 @@ void Overlay::enable( bool on )
         //
 
         m_enabled = true;
+        m_forceRedraw = true;
         onEnable();
     }
     else if( !on && m_hwnd ) // disable
@@ -246,6 +248,7 @@ void Overlay::enableUiEdit( bool on )
     else
         SetWindowLongPtr(m_hwnd, GWL_EXSTYLE, DefaultStyle);
     
+    m_forceRedraw = true;
     update();
 }
 
@@ -273,19 +276,52 @@ void Overlay::configChanged()
     const int h = g_cfg.getInt(m_name,"window_size_y", (int)defaultSize.y);
     setWindowPosAndSize( x, y, w, h );
 
+    m_forceRedraw = true;
     onConfigChanged();
 }
 
 void Overlay::sessionChanged()
 {
+    m_forceRedraw = true;
     onSessionChanged();
 }
 
+void Overlay::dependsOn( std::initializer_list<irsdkCVar*> vars )
+{
+    m_dependencies.insert( m_dependencies.end(), vars.begin(), vars.end() );
+    m_hasDependencies = true;
+}
+
+bool Overlay::needsRedraw() const
+{
+    if( m_forceRedraw || m_uiEditEnabled || !m_hasDependencies )
+        return true;
+
+    // New session info was swapped in
+    if( m_drawnSessionSeq != g_ir_sessionSeq )
+        return true;
+
+    for( irsdkCVar* var : m_dependencies )
+    {
+        if( var->getChangedAt() > m_drawnUpdateCount )
+            return true;
+    }
+    return false;
+}
+
 void Overlay::update()
 {
     if( !m_enabled )
         return;
 
+    // Nothing we show has changed, so keep what's on screen and skip the Present too
+    if( !needsRedraw() )
+        return;
+
+    m_forceRedraw = false;
+    m_drawnUpdateCount = irsdkClient::instance().getUpdateCount();
+    m_drawnSessionSeq = g_ir_sessionSeq;
+
     const float w = (float)m_width;
     const float h = (float)m_height;
     const float cornerRadius = g_cfg.getFloat( m_name, "corner_radius", m_name=="OverlayInputs"?2.0f:6.0f );
@@ -354,6 +390,7 @@ void Overlay::setWindowPosAndSize( int x, int y, int w, int h, bool callSetWindo
     m_ypos = y;
     m_width = w;
     m_height = h;
+    m_forceRedraw = true;
 
     m_renderTarget.Reset();  // need to release all references to swap chain's back buffers before calling ResizeBuffers
 
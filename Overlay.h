@@ -26,6 +26,8 @@ SOFTWARE.
 
 #include <windows.h>
 #include <string>
+#include <vector>
+#include <initializer_list>
 #include <dxgi1_6.h>
 #include <d3d11_4.h>
 #include <d2d1_3.h>
@@ -38,6 +40,8 @@ SOFTWARE.
     #include <chrono>
 #endif
 
+class irsdkCVar;
+
 class Overlay
 {
     public:
@@ -73,6 +77,12 @@ class Overlay
         virtual float2  getDefaultSize();
         virtual bool    hasCustomBackground();
 
+        // Only redraw when one of these variables changed since the last time we drew, or something
+        // else made it necessary (config, session info, window size, edit mode). Overlays that never
+        // call this redraw every frame.
+        void            dependsOn( std::initializer_list<irsdkCVar*> vars );
+        bool            needsRedraw() const;
+
         std::string     m_name;
         HWND            m_hwnd = 0;
         bool            m_enabled = false;
@@ -81,6 +91,11 @@ class Overlay
         int             m_ypos = 0;
         int             m_width = 0;
         int             m_height = 0;
+        std::vector<irsdkCVar*> m_dependencies;
+        bool            m_hasDependencies = false;
+        bool            m_forceRedraw = true;
+        int             m_drawnUpdateCount = -1;
+        unsigned        m_drawnSessionSeq = ~0u;
 #if defined(_DEBUG) or defined(DEBUG_OVERLAY_TIME)
         std::chrono::steady_clock::time_point debugTimeStart = std::chrono::high_resolution_clock::now();
         std::chrono::steady_clock::time_point debugTimeEnd = debugTimeStart;
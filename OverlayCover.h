@@ -32,5 +32,8 @@ class OverlayCover : public Overlay
 
         OverlayCover(Microsoft::WRL::ComPtr<ID3D11Device> d3dDevice)
             : Overlay("OverlayCover", d3dDevice)
-        {}
+        {
+            // Just a rectangle, only needs drawing when config or window change
+            dependsOn( {} );
+        }
 };
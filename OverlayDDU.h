@@ -40,7 +40,18 @@ class OverlayDDU : public Overlay
 
         OverlayDDU(Microsoft::WRL::ComPtr<ID3D11Device> d3dDevice)
             : Overlay("OverlayDDU", d3dDevice)
-        {}
+        {
+            dependsOn( { &ir_SessionTime, &ir_SessionTimeRemain, &ir_SessionLapsTotal, &ir_SessionLapsRemainEx, &ir_SessionFlags, &ir_SessionState, &ir_PaceMode,
+                         &ir_Gear, &ir_RPM, &ir_Speed, &ir_EngineWarnings, &ir_BrakeABSactive, &ir_dcBrakeBias, &ir_WaterTemp, &ir_OilTemp, &ir_DisplayUnits,
+                         &ir_FuelLevel, &ir_FuelLevelPct, &ir_PitSvFuel, &ir_dpFuelFill,
+                         &ir_dpTireChange, &ir_dpLTireChange, &ir_dpRTireChange, &ir_dpLFTireChange, &ir_dpRFTireChange, &ir_dpLRTireChange, &ir_dpRRTireChange,
+                         &ir_LeftTireSetsAvailable, &ir_RightTireSetsAvailable,
+                         &ir_LFwearL, &ir_LFwearM, &ir_LFwearR, &ir_RFwearL, &ir_RFwearM, &ir_RFwearR,
+                         &ir_LRwearL, &ir_LRwearM, &ir_LRwearR, &ir_RRwearL, &ir_RRwearM, &ir_RRwearR,
+                         &ir_LapLastLapTime, &ir_LapBestLapTime, &ir_LapDeltaToSessionBestLap, &ir_LapDeltaToSessionBestLap_OK, &ir_PlayerCarTeamIncidentCount,
+                         &ir_CarIdxLap, &ir_CarIdxLapCompleted, &ir_CarIdxLapDistPct, &ir_CarIdxOnPitRoad, &ir_CarIdxLastLapTime, &ir_CarIdxBestLapTime,
+                         &ir_CarIdxClassPosition, &ir_CarIdxClass } );
+        }
 
        #ifdef _DEBUG
        virtual bool    canEnableWhileNotDriving() const { return true; }
@@ -257,8 +268,8 @@ class OverlayDDU : public Overlay
             int p1carIdx = -1;
             for( int i=0; i<IR_MAX_CARS; ++i )
             {
-                if (ir_getClassId(i) != selfClassId) continue;
-                if( ir_getPosition(i) == 1 ) {
+                if (g_ir_cars.classId[i] != selfClassId) continue;
+                if( g_ir_cars.position[i] == 1 ) {
                     p1carIdx = i;
                     break;
                 }
@@ -431,7 +442,7 @@ class OverlayDDU : public Overlay
                         if( car.isPaceCar || car.isSpectator || car.userName.empty() )
                             continue;
 
-                        const float best = ir_CarIdxBestLapTime.getFloat(i);
+                        const float best = g_ir_cars.bestLapTime[i];
                         if( best > 0 && best < fastest ) {
                             fastest = best;
                             fastestLapCarIdx = i;
@@ -444,8 +455,10 @@ class OverlayDDU : public Overlay
                 if( t > 0 )
                 {
                     bool vsb = true;
-                    if( t < m_prevBestLapTime && tickCount-m_lastLapChangeTickCount < 5000 )  // blink
+                    if( t < m_prevBestLapTime && tickCount-m_lastLapChangeTickCount < 5000 ) { // blink
                         vsb = (tickCount % 800) < 500;
+                        m_forceRedraw = true;  // keep blinking even if the sim is paused
+                    }
                     else
                         m_prevBestLapTime = t;
 
@@ -525,8 +538,10 @@ class OverlayDDU : public Overlay
                 {
                     if( lapCountUpdated )
                     {
-                        const float usedLastLap = std::max( 0.0f, m_lapStartRemainingFuel - remainingFuel );
-                        m_lapStartRemainingFuel = remainingFuel;
+                        // Prefer the fuel level from the tick we actually crossed the line on
+                        const float lapStartFuel = g_ir_lapCrossing.lap == currentLap ? g_ir_lapCrossing.fuelLevel : remainingFuel;
+                        const float usedLastLap = std::max( 0.0f, m_lapStartRemainingFuel - lapStartFuel );
+                        m_lapStartRemainingFuel = lapStartFuel;
                         
                         // When resetting, the lap count resets and pushes two 0.0L laps, so we skip them here
                         if (m_isValidFuelLap && usedLastLap > 0.0f) {
@@ -770,6 +785,7 @@ class OverlayDDU : public Overlay
                 if (m_prevBrakeBias != bias) m_prevBrakeBiasTickCount = tickCount;
                 if (m_prevBrakeBiasTickCount+500 > tickCount)
                 {
+                    m_forceRedraw = true;  // so the highlight goes away on time
                     m_brush->SetColor(warnCol);
                     D2D1_RECT_F r = { m_boxBias.x0, m_boxBias.y0, m_boxBias.x1, m_boxBias.y1 };
                     m_renderTarget->FillRectangle(&r, m_brush.Get());
@@ -34,7 +34,10 @@ class OverlayInputs : public Overlay
 
         OverlayInputs(Microsoft::WRL::ComPtr<ID3D11Device> d3dDevice)
             : Overlay("OverlayInputs", d3dDevice)
-        {}
+        {
+            // The graph scrolls with session time, so it only stands still when the sim does
+            dependsOn( { &ir_SessionTime, &ir_Throttle, &ir_Brake, &ir_Clutch, &ir_SteeringWheelAngle, &ir_SteeringWheelAngleMax, &ir_BrakeABSactive, &ir_ReplayPlaySpeed } );
+        }
 
     protected:
         
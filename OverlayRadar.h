@@ -41,7 +41,9 @@ public:
 
     OverlayRadar(Microsoft::WRL::ComPtr<ID3D11Device> d3dDevice)
         : Overlay("OverlayRadar", d3dDevice)
-    {}
+    {
+        dependsOn( { &ir_CarLeftRight, &ir_LapDist, &ir_LapDistPct, &ir_CarIdxLap, &ir_CarIdxLapDistPct, &ir_CarIdxOnPitRoad } );
+    }
 
 protected:
 
@@ -69,16 +71,18 @@ protected:
         const float trackLength = ir_LapDist.getFloat() / selfLapDistPct;
         const float maxDist = g_cfg.getFloat(m_name, "max_distance", 7.0f);
 
+        const CarTable& cars = g_ir_cars;
+
         // Populate RadarInfo
         for (int i = 0; i < IR_MAX_CARS; ++i)
         {
             const Car& car = g_ir_session->cars[i];
-            const int lapcountCar = ir_CarIdxLap.getInt(i);
+            const int lapcountCar = cars.lap[i];
 
             // Ignore pace car and cars in pits
-            if (lapcountCar >= 0 && !car.isSpectator && car.carNumber >= 0 && !car.isPaceCar && !ir_CarIdxOnPitRoad.getBool(i))
+            if (lapcountCar >= 0 && !car.isSpectator && car.carNumber >= 0 && !car.isPaceCar && !cars.onPitRoad[i])
             {
-                const float carLapDistPct = ir_CarIdxLapDistPct.getFloat(i);
+                const float carLapDistPct = cars.lapDistPct[i];
                 const bool wrap = fabsf(selfLapDistPct - carLapDistPct) > 0.5f;
                 float lapDistPctDelta = selfLapDistPct - carLapDistPct;
 
@@ -39,7 +39,12 @@ class OverlayRelative : public Overlay
 
         OverlayRelative(Microsoft::WRL::ComPtr<ID3D11Device> d3dDevice)
             : Overlay("OverlayRelative", d3dDevice)
-        {}
+        {
+            dependsOn( { &ir_SessionTimeRemain, &ir_SessionLapsTotal, &ir_SessionLapsRemainEx, &ir_SessionFlags, &ir_SessionState, &ir_PaceMode,
+                         &ir_TrackTempCrew, &ir_PlayerCarClass, &ir_Lap, &ir_LapDistPct, &ir_LapBestLapTime,
+                         &ir_CarIdxLap, &ir_CarIdxLapCompleted, &ir_CarIdxLapDistPct, &ir_CarIdxEstTime, &ir_CarIdxOnPitRoad, &ir_CarIdxLastLapTime,
+                         &ir_CarIdxPosition, &ir_CarIdxClassPosition, &ir_CarIdxClass } );
+        }
 
     protected:
 
@@ -113,12 +118,13 @@ class OverlayRelative : public Overlay
             const float selfLapDistPct = ir_LapDistPct.getFloat();
             const float SelfEstLapTime = ir_CarIdxEstTime.getFloat(g_ir_session->driverCarIdx);
             const int classSelf = ir_PlayerCarClass.getInt();
+            const CarTable& cars = g_ir_cars;
             // Populate cars with the ones for which a relative/delta comparison is valid
             for( int i=0; i<IR_MAX_CARS; ++i )
             {
                 const Car& car = g_ir_session->cars[i];
 
-                const int lapcountCar = ir_CarIdxLap.getInt(i);
+                const int lapcountCar = cars.lap[i];
 
                 if( lapcountCar >= 0 && !car.isSpectator && car.carNumber>=0 )
                 {
@@ -132,8 +138,8 @@ class OverlayRelative : public Overlay
                     int   lapDelta = lapcountCar - lapcountSelf;
 
                     const float LClassRatio = car.carClassEstLapTime / ownClassEstLaptime;
-                    const float CarEstLapTime = ir_CarIdxEstTime.getFloat(i) / LClassRatio;
-                    const float carLapDistPct = ir_CarIdxLapDistPct.getFloat(i);
+                    const float CarEstLapTime = cars.estTime[i] / LClassRatio;
+                    const float carLapDistPct = cars.lapDistPct[i];
 
                     // Does the delta between us and the other car span across the start/finish line?
                     const bool wrap = fabsf(carLapDistPct - selfLapDistPct) > 0.5f;
@@ -171,12 +177,12 @@ class OverlayRelative : public Overlay
                     ci.carIdx = i;
                     ci.delta = delta;
                     ci.lapDelta = lapDelta;
-                    ci.lapDistPct = ir_CarIdxLapDistPct.getFloat(i);
+                    ci.lapDistPct = carLapDistPct;
                     ci.wrappedSum = wrappedSum;
-                    ci.pitAge = ir_CarIdxLap.getInt(i) - car.lastLapInPits;
-                    ci.last = ir_CarIdxLastLapTime.getFloat(i);
-                    ci.classLeader = (ir_CarIdxClass.getInt(i) == classSelf) && (ir_CarIdxClassPosition.getInt(i) == 1);
-                    ci.overallLeader = ir_CarIdxPosition.getInt(i) == 1;
+                    ci.pitAge = lapcountCar - car.lastLapInPits;
+                    ci.last = cars.lastLapTime[i];
+                    ci.classLeader = (cars.classId[i] == classSelf) && (cars.classPosition[i] == 1);
+                    ci.overallLeader = cars.overallPosition[i] == 1;
                     relatives.push_back( ci );
                 }
             }
@@ -258,7 +264,7 @@ class OverlayRelative : public Overlay
 
                 if( car.isSelf )
                     col = selfCol;
-                else if( ir_CarIdxOnPitRoad.getBool(ci.carIdx) )
+                else if( g_ir_cars.onPitRoad[ci.carIdx] )
                     col.a *= 0.5f;
                 
                 wchar_t s[512];
@@ -268,11 +274,11 @@ class OverlayRelative : public Overlay
                 const ColumnLayout::Column* clm = nullptr;
                 
                 // Position
-                if( ir_getPosition(ci.carIdx) > 0 )
+                if( g_ir_cars.position[ci.carIdx] > 0 )
                 {
                     clm = m_columns.get( (int)Columns::POSITION );
                     m_brush->SetColor( col );
-                    swprintf( s, _countof(s), L"P%d", ir_getPosition(ci.carIdx) );
+                    swprintf( s, _countof(s), L"P%d", g_ir_cars.position[ci.carIdx] );
                     m_textFormat->SetTextAlignment( DWRITE_TEXT_ALIGNMENT_TRAILING );
                     m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), xoff+clm->textL, xoff+clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING );
                 }
@@ -280,7 +286,7 @@ class OverlayRelative : public Overlay
                 // Car number
                 {
                     clm = m_columns.get( (int)Columns::CAR_NUMBER );
-                    swprintf( s, _countof(s), L"#%S", car.carNumberStr.c_str() );
+                    swprintf( s, _countof(s), L"#%ls", car.carNumberStr.w_str() );
                     r = { xoff+clm->textL, y-lineHeight/2, xoff+clm->textR, y+lineHeight/2 };
                     rr.rect = { r.left-2, r.top+1, r.right+2, r.bottom-1 };
                     rr.radiusX = 3;
@@ -296,18 +302,17 @@ class OverlayRelative : public Overlay
                 // Name
                 {
                     clm = m_columns.get( (int)Columns::NAME );
-                    swprintf( s, _countof(s), L"%S", car.userName.c_str() );
                     m_brush->SetColor( col );
-                    m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), xoff+clm->textL, xoff+clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING );
+                    m_text.render( m_renderTarget.Get(), car.userName.w_str(), m_textFormat.Get(), xoff+clm->textL, xoff+clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING );
                 }
 
                 // Pit age
-                if( (clm = m_columns.get((int)Columns::PIT)) && !ir_isPreStart() && (ci.pitAge>=0||ir_CarIdxOnPitRoad.getBool(ci.carIdx)) )
+                if( (clm = m_columns.get((int)Columns::PIT)) && !ir_isPreStart() && (ci.pitAge>=0||g_ir_cars.onPitRoad[ci.carIdx]) )
                 {
                     r = { xoff+clm->textL, y-lineHeight/2+2, xoff+clm->textR, y+lineHeight/2-2 };
                     m_brush->SetColor( pitCol );
                     m_renderTarget->DrawRectangle( &r, m_brush.Get() );
-                    if( ir_CarIdxOnPitRoad.getBool(ci.carIdx) ) {
+                    if( g_ir_cars.onPitRoad[ci.carIdx] ) {
                         swprintf( s, _countof(s), L"PIT" );
                         m_renderTarget->FillRectangle( &r, m_brush.Get() );
                         m_brush->SetColor( float4(0,0,0,1) );
@@ -452,7 +457,7 @@ class OverlayRelative : public Overlay
                         if( phase == 5 && !car.isSelf )
                             continue;
                         
-                        float e = ir_CarIdxLapDistPct.getFloat(ci.carIdx);
+                        float e = g_ir_cars.lapDistPct[ci.carIdx];
 
                         const float eself = ir_CarIdxLapDistPct.getFloat(g_ir_session->driverCarIdx);
 
@@ -467,7 +472,7 @@ class OverlayRelative : public Overlay
                         e = e * w + x;
 
                         float4 col = baseCol;
-                        if( !car.isSelf && ir_CarIdxOnPitRoad.getBool(ci.carIdx) )
+                        if( !car.isSelf && g_ir_cars.onPitRoad[ci.carIdx] )
                             col.a *= 0.5f;
 
                         const float dx = 2;
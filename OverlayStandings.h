@@ -47,6 +47,11 @@ public:
     OverlayStandings(Microsoft::WRL::ComPtr<ID3D11Device> d3dDevice, map<string, IWICFormatConverter*> carBrandIconsMap, bool carBrandIconsLoaded)
         : Overlay("OverlayStandings", d3dDevice)
     {
+        dependsOn({ &ir_SessionTimeRemain, &ir_SessionLapsTotal, &ir_SessionLapsRemainEx, &ir_SessionState, &ir_PaceMode, &ir_TrackTempCrew, &ir_DisplayUnits,
+                    &ir_PlayerCarIdx, &ir_PlayerCarClass, &ir_LapBestLapTime,
+                    &ir_CarIdxLap, &ir_CarIdxLapCompleted, &ir_CarIdxLapDistPct, &ir_CarIdxTrackSurface, &ir_CarIdxOnPitRoad,
+                    &ir_CarIdxLastLapTime, &ir_CarIdxBestLapTime, &ir_CarIdxF2Time, &ir_CarIdxClassPosition, &ir_CarIdxClass });
+
         m_avgL5Times.reserve(IR_MAX_CARS);
 
         for (int i = 0; i < IR_MAX_CARS; ++i) {
@@ -170,6 +175,8 @@ protected:
         const int playerCarIdx = ir_PlayerCarIdx.getInt();
         boolean hasPacecar = false;
 
+        const CarTable& cars = g_ir_cars;
+
         for( int i=0; i<IR_MAX_CARS; ++i )
         {
             const Car& car = g_ir_session->cars[i];
@@ -181,16 +188,16 @@ protected:
 
             CarInfo ci;
             ci.carIdx       = i;
-            ci.lapCount     = max( ir_CarIdxLap.getInt(i), ir_CarIdxLapCompleted.getInt(i) );
-            ci.position     = ir_getPosition(i);
-            ci.pctAroundLap = ir_CarIdxLapDistPct.getFloat(i);
-            ci.gap          = g_ir_session->sessionType!=SessionType::RACE ? 0 : -ir_CarIdxF2Time.getFloat(i);
-            ci.last         = ir_CarIdxLastLapTime.getFloat(i);
-            ci.pitAge       = ir_CarIdxLap.getInt(i) - car.lastLapInPits;
+            ci.lapCount     = max( cars.lap[i], cars.lapCompleted[i] );
+            ci.position     = cars.position[i];
+            ci.pctAroundLap = cars.lapDistPct[i];
+            ci.gap          = g_ir_session->sessionType!=SessionType::RACE ? 0 : -cars.f2Time[i];
+            ci.last         = cars.lastLapTime[i];
+            ci.pitAge       = cars.lap[i] - car.lastLapInPits;
             ci.positionsChanged = ir_getPositionsChanged(i);
-            ci.classId     = ir_getClassId(ci.carIdx);
+            ci.classId     = cars.classId[i];
 
-            ci.best         = ir_CarIdxBestLapTime.getFloat(i);
+            ci.best         = cars.bestLapTime[i];
             if (g_ir_session->sessionType == SessionType::RACE && ir_SessionState.getInt() <= irsdk_StateWarmup || g_ir_session->sessionType == SessionType::QUALIFY && ci.best <= 0) {
                 ci.best = car.qualy.fastestTime;
                 for (int j = 0; j < 5; ++j) {
@@ -198,7 +205,7 @@ protected:
                 }
             }
                 
-            if (ir_CarIdxTrackSurface.getInt(ci.carIdx) == irsdk_NotInWorld) {
+            if (cars.trackSurface[i] == irsdk_NotInWorld) {
                 switch (g_ir_session->sessionType) {
                     case SessionType::QUALIFY:
                         ci.best = car.qualy.fastestTime;
@@ -473,7 +480,7 @@ protected:
             // Dim color if player is disconnected.
             // TODO: this isn't 100% accurate, I think, because a car might be "not in world" while the player
             // is still connected? I haven't been able to find a better way to do this, though.
-            const bool isGone = !car.isSelf && ir_CarIdxTrackSurface.getInt(ci.carIdx) == irsdk_NotInWorld;
+            const bool isGone = !car.isSelf && g_ir_cars.trackSurface[ci.carIdx] == irsdk_NotInWorld;
             float4 textCol = car.isSelf ? selfCol : (car.isBuddy ? buddyCol : (car.isFlagged?flaggedCol:otherCarCol));
             if( isGone )
                 textCol.a *= 0.5f;
@@ -490,7 +497,7 @@ protected:
             // Car number
             {
                 clm = m_columns.get( (int)Columns::CAR_NUMBER );
-                swprintf( s, _countof(s), L"#%S", car.carNumberStr.c_str() );
+                swprintf( s, _countof(s), L"#%ls", car.carNumberStr.w_str() );
                 r = { xoff+clm->textL, y-lineHeight/2, xoff+clm->textR, y+lineHeight/2 };
                 rr.rect = { r.left-2, r.top+1, r.right+2, r.bottom-1 };
                 rr.radiusX = 3;
@@ -505,18 +512,17 @@ protected:
             {
                 clm = m_columns.get( (int)Columns::NAME );
                 m_brush->SetColor( textCol );
-                swprintf( s, _countof(s), L"%S", car.teamName.c_str() );
-                m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), xoff+clm->textL, xoff+clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING );
+                m_text.render( m_renderTarget.Get(), car.teamName.w_str(), m_textFormat.Get(), xoff+clm->textL, xoff+clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING );
             }
 
             // Pit age
-            if( !ir_isPreStart() && (ci.pitAge>=0||ir_CarIdxOnPitRoad.getBool(ci.carIdx)) )
+            if( !ir_isPreStart() && (ci.pitAge>=0||g_ir_cars.onPitRoad[ci.carIdx]) )
             {
                 if (clm = m_columns.get( (int)Columns::PIT )){
                     m_brush->SetColor( pitCol );
                     swprintf( s, _countof(s), L"%d", ci.pitAge );
                     r = { xoff+clm->textL, y-lineHeight/2+2, xoff+clm->textR, y+lineHeight/2-2 };
-                    if( ir_CarIdxOnPitRoad.getBool(ci.carIdx) ) {
+                    if( g_ir_cars.onPitRoad[ci.carIdx] ) {
                         swprintf( s, _countof(s), L"PIT" );
                         m_renderTarget->FillRectangle( &r, m_brush.Get() );
                         m_brush->SetColor( float4(0,0,0,1) );
@@ -564,7 +570,7 @@ protected:
                 // TODO: Don't create multiple bitmaps if multiple cars use the same icon
                 // This would help if many cars load the 00Error 
                 if (m_carIdToIconMap.find(car.carID) == m_carIdToIconMap.end()) {
-                     m_renderTarget->CreateBitmapFromWicBitmap( findCarBrandIcon(car.carName, m_carBrandIconsMap), nullptr, &m_carIdToIconMap[car.carID]);
+                     m_renderTarget->CreateBitmapFromWicBitmap( findCarBrandIcon(std::string(car.carName.view()), m_carBrandIconsMap), nullptr, &m_carIdToIconMap[car.carID]);
                 }
 
                 if (m_carIdToIconMap[car.carID] != 0) {
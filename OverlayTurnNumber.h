@@ -45,7 +45,9 @@ public:
   const float DefaultFontSize = 15.3f;
 
   OverlayTurnNumber(Microsoft::WRL::ComPtr<ID3D11Device> d3dDevice)
-      : Overlay("OverlayTurnNumber", d3dDevice) {}
+      : Overlay("OverlayTurnNumber", d3dDevice) {
+    dependsOn({ &ir_LapDist, &ir_LapDistPct });
+  }
 
 protected:
   virtual float2 getDefaultSize() { return float2(200, 50); }
@@ -111,7 +113,7 @@ protected:
 			return;
     }
 
-		auto filename = filesystem::path(directory) / std::format("{}.json", g_ir_session->trackName);
+		auto filename = filesystem::path(directory) / std::format("{}.json", g_ir_session->trackName.view());
 
 
 		std::string json;
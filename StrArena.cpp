@@ -0,0 +1,209 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "StrArena.h"
+#include "irsdk/yaml_index.h"
+
+const StrArenaEntry Str::s_empty = { 0, 0, "", L"" };
+
+// Code point of the UTF-8 sequence at s into cp and its length into n. False if
+// it isn't a valid one: a stray byte, cut short, overlong, a surrogate or past U+10FFFF.
+static bool decodeUtf8( const unsigned char* s, int len, unsigned& cp, int& n )
+{
+    const unsigned c = s[0];
+    unsigned min;
+    if( c < 0x80 )      { cp = c; n = 1; return true; }
+    else if( c < 0xC2 ) return false;
+    else if( c < 0xE0 ) { cp = c & 0x1F; n = 2; min = 0x80; }
+    else if( c < 0xF0 ) { cp = c & 0x0F; n = 3; min = 0x800; }
+    else if( c < 0xF5 ) { cp = c & 0x07; n = 4; min = 0x10000; }
+    else return false;
+
+    if( n > len )
+        return false;
+    for( int i=1; i<n; ++i )
+    {
+        if( (s[i] & 0xC0) != 0x80 )
+            return false;
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    return cp >= min && cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF);
+}
+
+int utf8SeqLen( const char* s, int len )
+{
+    unsigned cp;
+    int n;
+    return len > 0 && decodeUtf8( (const unsigned char*)s, len, cp, n ) ? n : 0;
+}
+
+// Session strings are UTF-8, DirectWrite wants UTF-16. A byte that doesn't start
+// a valid sequence is taken as Latin-1, the way it was widened before. Never writes
+// more than len characters, plus the terminator.
+static void widenUtf8( const char* s, int len, wchar_t* out )
+{
+#ifdef _WIN32
+    const int n = MultiByteToWideChar( CP_UTF8, MB_ERR_INVALID_CHARS, s, len, out, len );
+    if( n > 0 )
+    {
+        out[n] = L'\0';
+        return;
+    }
+#endif
+
+    const unsigned char* u = (const unsigned char*)s;
+    for( int i=0; i<len; )
+    {
+        unsigned cp;
+        int n;
+        if( !decodeUtf8( u+i, len-i, cp, n ) )
+        {
+            cp = u[i];
+            n = 1;
+        }
+        i += n;
+
+        if( sizeof(wchar_t) == 2 && cp >= 0x10000 )
+        {
+            // surrogate pair, still no longer than the four bytes it came from
+            cp -= 0x10000;
+            *out++ = (wchar_t)(0xD800 + (cp >> 10));
+            *out++ = (wchar_t)(0xDC00 + (cp & 0x3FF));
+        }
+        else
+            *out++ = (wchar_t)cp;
+    }
+    *out = L'\0';
+}
+
+StrArena::~StrArena()
+{
+    for( char* block : m_blocks )
+        delete[] block;
+}
+
+Str StrArena::intern( const char* s, int len )
+{
+    if( !s || len <= 0 )
+        return Str();
+
+    const unsigned long long hash = irsdkYamlIndex::hash( s, len );
+
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    if( (size_t)(m_numStrings + 1) * 2 > m_table.size() )
+        growTable();
+
+    const size_t mask = m_table.size() - 1;
+    size_t slot = (size_t)hash & mask;
+    for( ; m_table[slot]; slot = (slot + 1) & mask )
+    {
+        const StrArenaEntry* e = m_table[slot];
+        if( e->hash == hash && e->len == len && 0 == memcmp( e->str, s, len ) )
+            return Str( e );
+    }
+
+    // Entry, the string and its wide copy in one go
+    const size_t strOfs  = sizeof(StrArenaEntry);
+    const size_t wstrOfs = (strOfs + len + 1 + alignof(wchar_t) - 1) & ~(alignof(wchar_t) - 1);
+    char* mem = (char*)alloc( wstrOfs + (len + 1) * sizeof(wchar_t) );
+
+    char* str = mem + strOfs;
+    memcpy( str, s, len );
+    str[len] = '\0';
+
+    // Decoded, never more characters than there are bytes
+    wchar_t* wstr = (wchar_t*)(mem + wstrOfs);
+    widenUtf8( s, len, wstr );
+
+    StrArenaEntry* e = (StrArenaEntry*)mem;
+    e->hash = hash;
+    e->len  = len;
+    e->str  = str;
+    e->wstr = wstr;
+
+    m_table[slot] = e;
+    m_numStrings++;
+    return Str( e );
+}
+
+int StrArena::getNumStrings()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+    return m_numStrings;
+}
+
+size_t StrArena::getNumBytes()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+    return m_numBytes;
+}
+
+void* StrArena::alloc( size_t size )
+{
+    size = (size + alignof(StrArenaEntry) - 1) & ~(alignof(StrArenaEntry) - 1);
+    m_numBytes += size;
+
+    // Oversized strings get a block of their own
+    if( size > BLOCK_SIZE / 4 )
+    {
+        char* block = new char[size];
+        m_blocks.push_back( block );
+        return block;
+    }
+
+    if( !m_curBlock || m_blockUsed + size > BLOCK_SIZE )
+    {
+        m_curBlock = new char[BLOCK_SIZE];
+        m_blocks.push_back( m_curBlock );
+        m_blockUsed = 0;
+    }
+
+    void* p = m_curBlock + m_blockUsed;
+    m_blockUsed += size;
+    return p;
+}
+
+void StrArena::growTable()
+{
+    std::vector<const StrArenaEntry*> table( m_table.empty() ? 1024 : m_table.size() * 2, nullptr );
+    const size_t mask = table.size() - 1;
+    for( const StrArenaEntry* e : m_table )
+    {
+        if( !e )
+            continue;
+
+        size_t slot = (size_t)e->hash & mask;
+        while( table[slot] )
+            slot = (slot + 1) & mask;
+        table[slot] = e;
+    }
+    m_table.swap( table );
+}
@@ -0,0 +1,106 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// One string in a StrArena. Never changes, moves or goes away once it's there.
+struct StrArenaEntry
+{
+    unsigned long long  hash;
+    int                 len;
+    const char*         str;    // zero terminated
+    const wchar_t*      wstr;   // same text decoded to UTF-16 for DirectWrite, zero terminated
+};
+
+// Handle to a string in a StrArena. The arena keeps one copy of every string,
+// so two handles are equal exactly when their strings are.
+class Str
+{
+    public:
+
+        Str() : m_e( &s_empty ) {}
+        explicit Str( const StrArenaEntry* e ) : m_e( e ) {}
+
+        const char*         c_str() const { return m_e->str; }
+        const wchar_t*      w_str() const { return m_e->wstr; }
+        int                 size() const { return m_e->len; }
+        bool                empty() const { return m_e->len == 0; }
+        unsigned long long  hash() const { return m_e->hash; }
+        std::string_view    view() const { return std::string_view( m_e->str, m_e->len ); }
+
+        bool operator==( const Str& other ) const { return m_e == other.m_e; }
+        bool operator!=( const Str& other ) const { return m_e != other.m_e; }
+
+    private:
+
+        const StrArenaEntry*        m_e;
+
+        friend class StrArena;
+        static const StrArenaEntry  s_empty;
+};
+
+// Length of the UTF-8 sequence at s, 0 if the byte there doesn't start a valid
+// one. Those are the bytes StrArena::intern() widens one at a time for w_str().
+int utf8SeqLen( const char* s, int len );
+
+// Deduplicating string store. Interning a string that is already there only
+// hashes and compares it, so re-interning the same strings doesn't allocate.
+// Strings are never freed, handles stay valid for the lifetime of the arena
+// and can be read from any thread. intern() itself is thread safe.
+class StrArena
+{
+    public:
+
+        StrArena() = default;
+        ~StrArena();
+
+        Str         intern( const char* s, int len );
+        Str         intern( std::string_view s ) { return intern( s.data(), (int)s.size() ); }
+
+        int         getNumStrings();
+        size_t      getNumBytes();
+
+    private:
+
+        StrArena( const StrArena& ) = delete;
+        StrArena& operator=( const StrArena& ) = delete;
+
+        void*       alloc( size_t size );
+        void        growTable();
+
+        static const size_t BLOCK_SIZE = 64 * 1024;
+
+        std::mutex                          m_lock;
+        std::vector<char*>                  m_blocks;
+        char*                               m_curBlock = nullptr;
+        size_t                              m_blockUsed = 0;
+        size_t                              m_numBytes = 0;
+        std::vector<const StrArenaEntry*>   m_table;    // open addressing, power of two size
+        int                                 m_numStrings = 0;
+};
@@ -26,7 +26,16 @@ SOFTWARE.
 
 #include "iracing.h"
 #include "Config.h"
+#include "irsdk/yaml_index.h"
 #include "string"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <filesystem>
+#include <set>
+#include <thread>
+#include <type_traits>
 
 irsdkCVar ir_SessionTime("SessionTime");    // double[1] Seconds since session start (s)
 irsdkCVar ir_SessionTick("SessionTick");    // int[1] Current update number ()
@@ -325,16 +334,19 @@ irsdkCVar ir_LFSHshockVel("LFSHshockVel");    // float[1] LFSH shock velocity (m
 irsdkCVar ir_LFSHshockVel_ST("LFSHshockVel_ST");    // float[6] LFSH shock velocity at 360 Hz (m/s)
 
 // Initialize ir_session
-Session g_ir_session_data[2];
-bool g_ir_session_cur = 0;
+Session g_ir_session_data[3];
 Session* g_ir_session = &g_ir_session_data[0];
+unsigned g_ir_sessionSeq = 0;
+SessionParseStats g_ir_sessionParseStats;
+LapCrossing g_ir_lapCrossing;
+CarTable g_ir_cars;
 
-static bool parseYamlInt(const char *yamlStr, const char *path, int *dest)
+static bool parseYamlInt(const irsdkYamlIndex& yaml, int node, const char *path, int *dest)
 {
     int count = 0;
     const char *s = nullptr;
 
-    if( parseYaml(yamlStr, path, &s, &count) )
+    if( yaml.getVal(yaml.findPath(node, path), &s, &count) )
     {
         *dest = atoi( s );
         return true;
@@ -343,12 +355,12 @@ static bool parseYamlInt(const char *yamlStr, const char *path, int *dest)
     return false;
 }
 
-static bool parseYamlFloat(const char *yamlStr, const char *path, float *dest)
+static bool parseYamlFloat(const irsdkYamlIndex& yaml, int node, const char *path, float *dest)
 {
     int count = 0;
     const char *s = nullptr;
 
-    if( parseYaml(yamlStr, path, &s, &count) )
+    if( yaml.getVal(yaml.findPath(node, path), &s, &count) )
     {
         (*dest) = (float)atof( s );
         return true;
@@ -357,25 +369,21 @@ static bool parseYamlFloat(const char *yamlStr, const char *path, float *dest)
     return false;
 }
 
-static bool parseYamlStr(const char *yamlStr, const char *path, std::string& dest)
+// Unquoted value, a view into the session string. Only valid for as long as that is.
+static bool parseYamlStr(const irsdkYamlIndex& yaml, int node, const char *path, std::string_view& dest)
 {
     int count = 0;
     const char *s = nullptr;
 
-    if( parseYaml(yamlStr, path, &s, &count) )
+    if( yaml.getVal(yaml.findPath(node, path), &s, &count) )
     {
-        // strip leading quotes
-        if( *s == '"' )
-        {
-            s++;
-            count--;
-        }
-
-        dest.assign( s, count );
+        dest = std::string_view( s, count );
 
-        // strip trailing quotes
-        if( !dest.empty() && dest[dest.length()-1]=='"' )
-            dest.pop_back();
+        // strip quotes
+        if( dest.starts_with('"') )
+            dest.remove_prefix( 1 );
+        if( dest.ends_with('"') )
+            dest.remove_suffix( 1 );
 
         return true;
     }
@@ -383,283 +391,885 @@ static bool parseYamlStr(const char *yamlStr, const char *path, std::string& des
     return false;
 }
 
-// TODO: Add Mutex?
-void updateSessionStringData(const char* sessionYaml, Session* ir_session_pointer) {
-#if defined(_DEBUG) and DEBUG_DUMP_SESSIONSTRING
-    //printf("%s\n", sessionYaml);
-    FILE* fp = fopen("sessionYaml.txt", "ab");
-    fprintf(fp, "\n\n==== NEW SESSION STRING ======================================\n");
-    fprintf(fp, "%s", sessionYaml);
-    fclose(fp);
-#endif
-    char path[256];
+// Session text lives in here, so re-decoding a string we've seen before doesn't allocate
+static StrArena s_ir_strings;
 
-    // Weekend info
-    parseYamlInt(sessionYaml, "WeekendInfo:SubSessionID:", &ir_session_pointer->subsessionId);
+static bool parseYamlStr(const irsdkYamlIndex& yaml, int node, const char *path, Str& dest)
+{
+    std::string_view s;
+
+    if( parseYamlStr(yaml, node, path, s) )
+    {
+        dest = s_ir_strings.intern( s );
+        return true;
+    }
 
-    parseYamlStr(sessionYaml, "WeekendInfo:TrackName:", ir_session_pointer->trackName);
+    return false;
+}
 
-    parseYamlInt(sessionYaml, "WeekendInfo:WeekendOptions:IsFixedSetup:", &ir_session_pointer->isFixedSetup);
+// What user names get folded to: line breaks become spaces, and the accented vowels
+// become plain ones. Those come as two byte UTF-8 sequences (0xC3 0x80+i), or as the
+// single Latin-1 bytes for them when a byte isn't part of a valid UTF-8 sequence.
+// Valid sequences are judged the same way the arena decodes them for DirectWrite.
+struct NameFoldTable
+{
+    char            single[256] = {};   // replacement for a byte on its own, 0 to keep it
+    char            afterC3[64] = {};   // replacement for 0xC3 followed by 0x80+i, 0 to keep it
 
-    parseYamlInt(sessionYaml, "WeekendInfo:WeekendOptions:NumCarClasses:", &ir_session_pointer->numCarClasses);
+    constexpr NameFoldTable()
+    {
+        single['\n'] = ' ';
+        single['\r'] = ' ';
+        single[0xE1] = 'a';
+        single[0xE9] = 'e';
+        single[0xED] = 'i';
+        single[0xF3] = 'o';
+        single[0xFA] = 'u';
+
+        afterC3[0xA1 & 0x3F] = 'a';
+        afterC3[0xA9 & 0x3F] = 'e';
+        afterC3[0xAD & 0x3F] = 'i';
+        afterC3[0xB3 & 0x3F] = 'o';
+        afterC3[0xBA & 0x3F] = 'u';
+    }
+};
+static constexpr NameFoldTable s_ir_nameFold;
 
+static Str ir_normalizeName(std::string_view name)
+{
+    const NameFoldTable& t = s_ir_nameFold;
 
-    std:string simMode;
-    parseYamlStr(sessionYaml, "WeekendInfo:SimMode:", simMode);
-    ir_session_pointer->isReplay = (simMode == "replay");
-    
-    const char* driverInfoYaml = strstr(sessionYaml, "DriverInfo:");
+    static thread_local std::string out;
+    out.clear();
 
-    // Driver/car info
-    parseYamlInt(driverInfoYaml, "DriverInfo:DriverCarIdx:", &ir_session_pointer->driverCarIdx);
-    parseYamlFloat(driverInfoYaml, "DriverInfo:DriverCarFuelMaxLtr:", &ir_session_pointer->fuelMaxLtr);
-    parseYamlFloat(driverInfoYaml, "DriverInfo:DriverCarIdleRPM:", &ir_session_pointer->rpmIdle);
-    parseYamlFloat(driverInfoYaml, "DriverInfo:DriverCarRedLine:", &ir_session_pointer->rpmRedline);
-    parseYamlFloat(driverInfoYaml, "DriverInfo:DriverCarSLFirstRPM:", &ir_session_pointer->rpmSLFirst);
-    parseYamlFloat(driverInfoYaml, "DriverInfo:DriverCarSLShiftRPM:", &ir_session_pointer->rpmSLShift);
-    parseYamlFloat(driverInfoYaml, "DriverInfo:DriverCarSLLastRPM:", &ir_session_pointer->rpmSLLast);
-    parseYamlFloat(driverInfoYaml, "DriverInfo:DriverCarSLBlinkRPM:", &ir_session_pointer->rpmSLBlink);
-
-    // Per-Driver info
-    for (int carIdx = 0; carIdx < IR_MAX_CARS; ++carIdx)
+    for (size_t i = 0; i < name.size(); )
     {
-        Car& car = ir_session_pointer->cars[carIdx];
-
-        car.isSelf = int(carIdx == ir_session_pointer->driverCarIdx);
+        const unsigned char c = (unsigned char)name[i];
+        const int len = utf8SeqLen(name.data() + i, (int)(name.size() - i));
 
-        sprintf(path, " - CarIdx: %d", carIdx);
-        const char* carIdxYaml = strstr(driverInfoYaml, path);
-        
-        if (!parseYamlStr(carIdxYaml, "UserName:", car.userName))
+        if (len > 1)
         {
-            car = Car();
-            continue;
+            const char fold = c == 0xC3 ? t.afterC3[(unsigned char)name[i + 1] & 0x3F] : 0;
+            if (fold)
+                out += fold;
+            else
+                out.append(name.substr(i, len));
+            i += len;
         }
-
-        if (!parseYamlStr(carIdxYaml, "TeamName:", car.teamName))
+        else
         {
-            car = Car();
-            continue;
+            out += t.single[c] ? t.single[c] : (char)c;
+            i++;
         }
+    }
 
-        // Remove line breaks in user names if we find any and special characters
-        for (char& c : car.userName) {
-            switch (c) {
-            case '\n':
-                c = ' ';
-                break;
-            case '\r':
-                c = ' ';
-                break;
-            case '':
-                c = 'i';
-                break;
-            case '':
-                c = 'o';
-                break;
-            case '':
-                c = 'u';
-                break;
-            case '':
-                c = 'a';
-                break;
-            case '':
-                c = 'e';
-                break;
-            default:
-                c = c;
-            }
-        }
+    return s_ir_strings.intern(out);
+}
 
-        parseYamlStr(carIdxYaml, "CarNumber:", car.carNumberStr);
+// Driver fields of one DriverInfo:Drivers entry, false if it isn't a driver
+static bool ir_decodeCar(const irsdkYamlIndex& yaml, int carIdxYaml, Car& car)
+{
+    std::string_view userName;
+    if (!parseYamlStr(yaml, carIdxYaml, "UserName:", userName))
+        return false;
 
-        parseYamlInt(carIdxYaml, "CarNumberRaw", &car.carNumber);
+    if (!parseYamlStr(yaml, carIdxYaml, "TeamName:", car.teamName))
+        return false;
 
-        parseYamlStr(carIdxYaml, "LicString:", car.licenseStr);
-        car.licenseChar = car.licenseStr.empty() ? 'R' : car.licenseStr[0];
-        const std::string SRstr = car.licenseStr.empty() ? "0" : std::string(car.licenseStr.begin() + 1, car.licenseStr.end());
-        car.licenseSR = (float)atof(SRstr.c_str());
+    // Remove line breaks in user names if we find any and special characters
+    car.userName = ir_normalizeName(userName);
 
-        switch (car.licenseStr[0]) {
-        case 'R': // Red
-            car.licenseCol = float4(1.0f, 0.0f, 0.0f, 1.0f);
-            break;
-        case 'D': // Orange
-            car.licenseCol = float4(1.0f, 0.35f, 0.0f, 1.0f);
+    parseYamlStr(yaml, carIdxYaml, "CarNumber:", car.carNumberStr);
+
+    parseYamlInt(yaml, carIdxYaml, "CarNumberRaw", &car.carNumber);
+
+    parseYamlStr(yaml, carIdxYaml, "LicString:", car.licenseStr);
+    car.licenseChar = car.licenseStr.empty() ? 'R' : car.licenseStr.c_str()[0];
+    car.licenseSR = car.licenseStr.empty() ? 0.0f : (float)atof(car.licenseStr.c_str() + 1);
+
+    switch (car.licenseStr.c_str()[0]) {
+    case 'R': // Red
+        car.licenseCol = float4(1.0f, 0.0f, 0.0f, 1.0f);
+        break;
+    case 'D': // Orange
+        car.licenseCol = float4(1.0f, 0.35f, 0.0f, 1.0f);
 			break;
-        case 'C': // Yellow
-            car.licenseCol = float4(0.85f, 0.85f, 0.2f, 1.0f);
+    case 'C': // Yellow
+        car.licenseCol = float4(0.85f, 0.85f, 0.2f, 1.0f);
 			break;
-        case 'B': // Green
-            car.licenseCol = float4(0.2f, 0.6f, 0.0f, 1.0f);
+    case 'B': // Green
+        car.licenseCol = float4(0.2f, 0.6f, 0.0f, 1.0f);
 			break;
-        case 'A': // Blue
-            car.licenseCol = float4(0.05f, 0.07f, 0.9f, 1.0f);
+    case 'A': // Blue
+        car.licenseCol = float4(0.05f, 0.07f, 0.9f, 1.0f);
 			break;
-        case 'W': // Black
-            car.licenseCol = float4(0.0f, 0.0f, 0.0f, 1.0f);
+    case 'W': // Black
+        car.licenseCol = float4(0.0f, 0.0f, 0.0f, 1.0f);
 			break;
-        }
-        /*
-        sprintf(path, "DriverInfo:Drivers:CarIdx:{%d}LicColor:", carIdx);
-        parseYamlStr(carIdxYaml, path, car.licenseColStr);
-        sscanf(car.licenseColStr.c_str(), "0x%x", &licColHex);
-        car.licenseCol.r = float((licColHex >> 16) & 0xff) / 255.f;
-        car.licenseCol.g = float((licColHex >> 8) & 0xff) / 255.f;
-        car.licenseCol.b = float((licColHex >> 0) & 0xff) / 255.f;
-        car.licenseCol.a = 1;
-        */
+    }
+    /*
+    sprintf(path, "DriverInfo:Drivers:CarIdx:{%d}LicColor:", carIdx);
+    parseYamlStr(carIdxYaml, path, car.licenseColStr);
+    sscanf(car.licenseColStr.c_str(), "0x%x", &licColHex);
+    car.licenseCol.r = float((licColHex >> 16) & 0xff) / 255.f;
+    car.licenseCol.g = float((licColHex >> 8) & 0xff) / 255.f;
+    car.licenseCol.b = float((licColHex >> 0) & 0xff) / 255.f;
+    car.licenseCol.a = 1;
+    */
+
+    parseYamlStr(yaml, carIdxYaml, "CarClassColor:", car.classColStr);
+    unsigned classColHex = 0;
+    sscanf(car.classColStr.c_str(), "0x%x", &classColHex);
+    car.classCol.r = float((classColHex >> 16) & 0xff) / 255.f;
+    car.classCol.g = float((classColHex >> 8) & 0xff) / 255.f;
+    car.classCol.b = float((classColHex >> 0) & 0xff) / 255.f;
+    car.classCol.a = 1;
+
+    parseYamlInt(yaml, carIdxYaml, "CarClassID:", &car.classId);
+
+    parseYamlInt(yaml, carIdxYaml, "IRating:", &car.irating);
+
+    parseYamlInt(yaml, carIdxYaml, "CarIsPaceCar:", &car.isPaceCar);
+
+    parseYamlInt(yaml, carIdxYaml, "IsSpectator:", &car.isSpectator);
+
+    parseYamlInt(yaml, carIdxYaml, "CurDriverIncidentCount:", &car.incidentCount);
+
+    parseYamlFloat(yaml, carIdxYaml, "CarClassEstLapTime:", &car.carClassEstLapTime);
+
+    parseYamlStr(yaml, carIdxYaml, "CarScreenName:", car.carName);
+
+    parseYamlInt(yaml, carIdxYaml, "CarID:", &car.carID);
+
+    return true;
+}
 
-        parseYamlStr(carIdxYaml, "CarClassColor:", car.classColStr);
-        unsigned classColHex = 0;
-        sscanf(car.classColStr.c_str(), "0x%x", &classColHex);
-        car.classCol.r = float((classColHex >> 16) & 0xff) / 255.f;
-        car.classCol.g = float((classColHex >> 8) & 0xff) / 255.f;
-        car.classCol.b = float((classColHex >> 0) & 0xff) / 255.f;
-        car.classCol.a = 1;
+// Decode a results list into rows, skipping the rows that hash the same as the ones already there
+static void ir_decodeResults(const irsdkYamlIndex& yaml, int resultsYaml, SessionResults& results)
+{
+    const int numRows = std::min(yaml.getNumChildren(resultsYaml), IR_MAX_CARS);
+    for (int i = 0; i < numRows; ++i)
+    {
+        const int rowYaml = yaml.getChild(resultsYaml, i);
+        const unsigned long long hash = yaml.getHash(rowYaml);
 
-        parseYamlInt(carIdxYaml, "CarClassID:", &car.classId);
+        SessionResultsRow& row = results.rows[i];
+        if (i < results.numRows && row.hash == hash)
+            continue;
 
-        parseYamlInt(carIdxYaml, "IRating:", &car.irating);
+        row = SessionResultsRow();
+        row.hash = hash;
+        parseYamlInt(yaml, rowYaml, "CarIdx:", &row.carIdx);
 
-        parseYamlInt(carIdxYaml, "CarIsPaceCar:", &car.isPaceCar);
+        int realPos = -1;
+        parseYamlInt(yaml, rowYaml, "ClassPosition:", &realPos);
+        row.times.position = realPos + 1;
 
-        parseYamlInt(carIdxYaml, "IsSpectator:", &car.isSpectator);
+        row.hasLastTime = parseYamlFloat(yaml, rowYaml, "LastTime:", &row.times.lastTime);
+        row.hasFastestTime = parseYamlFloat(yaml, rowYaml, "FastestTime:", &row.times.fastestTime);
+    }
+    results.numRows = numRows;
+}
 
-        parseYamlInt(carIdxYaml, "CurDriverIncidentCount:", &car.incidentCount);
+static void ir_applyResults(const SessionResults& results, Session* ir_session_pointer)
+{
+    for (int i = 0; i < results.numRows; ++i)
+    {
+        const SessionResultsRow& row = results.rows[i];
+        if (row.carIdx < 0 || row.carIdx >= IR_MAX_CARS)
+            continue;
 
-        parseYamlFloat(carIdxYaml, "CarClassEstLapTime:", &car.carClassEstLapTime);
+        SessionPosTimes* curCarEditing = nullptr;
 
-        parseYamlStr(carIdxYaml, "CarScreenName:", car.carName);
+        switch (results.type) {
+        case SessionType::PRACTICE:
+            curCarEditing = &ir_session_pointer->cars[row.carIdx].practice;
+            break;
+        case SessionType::QUALIFY:
+            curCarEditing = &ir_session_pointer->cars[row.carIdx].qualy;
+            break;
+        case SessionType::RACE:
+            curCarEditing = &ir_session_pointer->cars[row.carIdx].race;
+            break;
+        }
+        if (curCarEditing == nullptr) continue;
 
-        parseYamlInt(carIdxYaml, "CarID:", &car.carID);
+        curCarEditing->position = row.times.position;
+        if (row.hasLastTime)
+            curCarEditing->lastTime = row.times.lastTime;
+        if (row.hasFastestTime)
+            curCarEditing->fastestTime = row.times.fastestTime;
+    }
+}
 
+// Everything derived from the decoded data together with the current telemetry,
+// as captured by ir_tick() when it posted the string
+static void ir_resolveSession(Session* ir_session_pointer, int sessionNum, int playerCarClass)
+{
+    // Positions are rebuilt from the decoded rows every time, session info last
+    // (may override qual results, but that's ok since hopefully they're the same!)
+    for (int carIdx = 0; carIdx < IR_MAX_CARS; ++carIdx)
+    {
+        Car& car = ir_session_pointer->cars[carIdx];
         car.qualy.position = 0;
         car.practice.position = 0;
         car.race.position = 0;
     }
+
+    ir_applyResults(ir_session_pointer->qualifyResults, ir_session_pointer);
+
+    for (int i = 0; i < ir_session_pointer->numSessions; ++i)
+    {
+        const SessionResults& results = ir_session_pointer->sessions[i];
+
+        if (results.sessionNum == sessionNum) { // Set the current session name
+            ir_session_pointer->sessionType = results.type;
+        }
+
+        ir_session_pointer->isUnlimitedTime = results.isUnlimitedTime;
+        ir_session_pointer->isUnlimitedLaps = results.isUnlimitedLaps;
+
+        ir_applyResults(results, ir_session_pointer);
+    }
     
-    const char* qualifyResultsInfoYaml = strstr(sessionYaml, "QualifyResultsInfo:");
-    if (qualifyResultsInfoYaml != nullptr) {
-        // Qualifying results info
-        for (int pos = 0; pos < IR_MAX_CARS; ++pos)
+    // SoF
+    double sof = 0;
+    int cnt = 0;
+    int ownClass = playerCarClass;
+    for (int i = 0; i < IR_MAX_CARS; ++i)
+    {
+        const Car& car = ir_session_pointer->cars[i];
+
+        if (car.isPaceCar || car.isSpectator || car.userName.empty() || car.classId != ownClass)
+            continue;
+
+        sof += car.irating;
+        cnt++;
+    }
+    ir_session_pointer->sof = int(sof / cnt);
+}
+
+void updateSessionStringData(const char* sessionYaml, Session* ir_session_pointer, int sessionNum, int playerCarClass) {
+#if defined(_DEBUG) and DEBUG_DUMP_SESSIONSTRING
+    //printf("%s\n", sessionYaml);
+    FILE* fp = fopen("sessionYaml.txt", "ab");
+    fprintf(fp, "\n\n==== NEW SESSION STRING ======================================\n");
+    fprintf(fp, "%s", sessionYaml);
+    fclose(fp);
+#endif
+    // Tokenize the whole string once, everything below walks the index
+    irsdkYamlIndex yaml;
+    yaml.build(sessionYaml);
+    const int root = yaml.getRoot();
+
+    // Most updates only change a driver or a results row. Only decode the
+    // sections, drivers and rows whose text hashes differently from what the
+    // session data was last decoded from.
+    if (!ir_session_pointer->initialized)
+    {
+        ir_session_pointer->weekendInfoHash = 0;
+        ir_session_pointer->driverInfoHash = 0;
+        ir_session_pointer->sessionInfoHash = 0;
+        ir_session_pointer->qualifyResultsInfoHash = 0;
+        for (int carIdx = 0; carIdx < IR_MAX_CARS; ++carIdx)
         {
+            ir_session_pointer->carHash[carIdx] = 0;
+            ir_session_pointer->cars[carIdx] = Car();
+        }
+        ir_session_pointer->numSessions = 0;
+        ir_session_pointer->qualifyResults.numRows = 0;
+    }
+
+    // Weekend info
+    const unsigned long long weekendInfoHash = yaml.getHash(yaml.findPath(root, "WeekendInfo:"));
+    if (weekendInfoHash != ir_session_pointer->weekendInfoHash)
+    {
+        ir_session_pointer->weekendInfoHash = weekendInfoHash;
 
-            sprintf(path, "\n - Position: %d", pos);
-            const char* qualifyingPositionYamlTmp = strstr(qualifyResultsInfoYaml, path);
-            if (qualifyingPositionYamlTmp != nullptr) {
-                const char* qualifyingPositionYaml = qualifyingPositionYamlTmp + 16; // +16 to skip the searched string
+        parseYamlInt(yaml, root, "WeekendInfo:SubSessionID:", &ir_session_pointer->subsessionId);
 
-                int carIdx = -1;
-                if (parseYamlInt(qualifyingPositionYaml, "CarIdx:", &carIdx)) {
+        parseYamlStr(yaml, root, "WeekendInfo:TrackName:", ir_session_pointer->trackName);
 
-                    int realPos = -1;
-                    parseYamlInt(qualifyingPositionYaml, "ClassPosition:", &realPos);
-                    ir_session_pointer->cars[carIdx].qualy.position = realPos + 1;
+        parseYamlInt(yaml, root, "WeekendInfo:WeekendOptions:IsFixedSetup:", &ir_session_pointer->isFixedSetup);
 
-                    parseYamlFloat(qualifyingPositionYaml, "FastestTime:", &ir_session_pointer->cars[carIdx].qualy.fastestTime);
+        parseYamlInt(yaml, root, "WeekendInfo:WeekendOptions:NumCarClasses:", &ir_session_pointer->numCarClasses);
+
+
+        std::string_view simMode;
+        parseYamlStr(yaml, root, "WeekendInfo:SimMode:", simMode);
+        ir_session_pointer->isReplay = (simMode == "replay");
+    }
+
+    // Driver/car info
+    const unsigned long long driverInfoHash = yaml.getHash(yaml.findPath(root, "DriverInfo:"));
+    if (driverInfoHash != ir_session_pointer->driverInfoHash)
+    {
+        ir_session_pointer->driverInfoHash = driverInfoHash;
+
+        parseYamlInt(yaml, root, "DriverInfo:DriverCarIdx:", &ir_session_pointer->driverCarIdx);
+        parseYamlFloat(yaml, root, "DriverInfo:DriverCarFuelMaxLtr:", &ir_session_pointer->fuelMaxLtr);
+        parseYamlFloat(yaml, root, "DriverInfo:DriverCarIdleRPM:", &ir_session_pointer->rpmIdle);
+        parseYamlFloat(yaml, root, "DriverInfo:DriverCarRedLine:", &ir_session_pointer->rpmRedline);
+        parseYamlFloat(yaml, root, "DriverInfo:DriverCarSLFirstRPM:", &ir_session_pointer->rpmSLFirst);
+        parseYamlFloat(yaml, root, "DriverInfo:DriverCarSLShiftRPM:", &ir_session_pointer->rpmSLShift);
+        parseYamlFloat(yaml, root, "DriverInfo:DriverCarSLLastRPM:", &ir_session_pointer->rpmSLLast);
+        parseYamlFloat(yaml, root, "DriverInfo:DriverCarSLBlinkRPM:", &ir_session_pointer->rpmSLBlink);
+
+        // Find each car's entry in the driver list
+        int carYaml[IR_MAX_CARS];
+        for (int carIdx = 0; carIdx < IR_MAX_CARS; ++carIdx)
+            carYaml[carIdx] = -1;
+
+        const int driversYaml = yaml.findPath(root, "DriverInfo:Drivers:");
+        for (int i = 0; i < yaml.getNumChildren(driversYaml); ++i)
+        {
+            const int item = yaml.getChild(driversYaml, i);
+            int carIdx = -1;
+            if (parseYamlInt(yaml, item, "CarIdx:", &carIdx) && carIdx >= 0 && carIdx < IR_MAX_CARS)
+                carYaml[carIdx] = item;
+        }
+
+        // Per-Driver info, for the entries that changed
+        for (int carIdx = 0; carIdx < IR_MAX_CARS; ++carIdx)
+        {
+            const unsigned long long carHash = yaml.getHash(carYaml[carIdx]);
+            if (carHash == ir_session_pointer->carHash[carIdx])
+                continue;
+
+            ir_session_pointer->carHash[carIdx] = carHash;
+
+            Car& car = ir_session_pointer->cars[carIdx];
+            if (!ir_decodeCar(yaml, carYaml[carIdx], car))
+                car = Car();
+        }
+    }
+
+    for (int carIdx = 0; carIdx < IR_MAX_CARS; ++carIdx)
+        ir_session_pointer->cars[carIdx].isSelf = int(carIdx == ir_session_pointer->driverCarIdx);
+
+    // Qualifying results info
+    const int qualifyResultsInfoYaml = yaml.findPath(root, "QualifyResultsInfo:");
+    const unsigned long long qualifyResultsInfoHash = yaml.getHash(qualifyResultsInfoYaml);
+    if (qualifyResultsInfoHash != ir_session_pointer->qualifyResultsInfoHash)
+    {
+        ir_session_pointer->qualifyResultsInfoHash = qualifyResultsInfoHash;
+        ir_session_pointer->qualifyResults.type = SessionType::QUALIFY;
+        ir_decodeResults(yaml, yaml.findPath(qualifyResultsInfoYaml, "Results:"), ir_session_pointer->qualifyResults);
+    }
+
+    // Session info. Every session's results are decoded once and then kept for as long as
+    // their text stays the same, a finished session's never changes again. Past sessions
+    // are still needed, a practice we joined after feeds the position fallback.
+    const int sessionInfoYaml = yaml.findPath(root, "SessionInfo:");
+    const unsigned long long sessionInfoHash = yaml.getHash(sessionInfoYaml);
+    if (sessionInfoHash != ir_session_pointer->sessionInfoHash)
+    {
+        ir_session_pointer->sessionInfoHash = sessionInfoHash;
+
+        const int sessionsYaml = yaml.findPath(sessionInfoYaml, "Sessions:");
+        int numSessions = 0;
+        for (int i = 0; i < yaml.getNumChildren(sessionsYaml) && numSessions < IR_MAX_SESSIONS; ++i)
+        {
+            const int sessionNumYaml = yaml.getChild(sessionsYaml, i);
+            SessionResults& results = ir_session_pointer->sessions[numSessions];
+
+            const unsigned long long hash = yaml.getHash(sessionNumYaml);
+            if (numSessions >= ir_session_pointer->numSessions || results.hash != hash) {
+                int session = -1;
+                if (!parseYamlInt(yaml, sessionNumYaml, "SessionNum:", &session)) break;
+
+                std::string_view sessionNameStr;
+                if (!parseYamlStr(yaml, sessionNumYaml, "SessionName:", sessionNameStr)) {
+                    break;
                 }
+
+                SessionType thisSessionType = SessionType::UNKNOWN;
+                if (sessionNameStr == "PRACTICE")
+                    thisSessionType = SessionType::PRACTICE;
+                else if (sessionNameStr == "QUALIFY")
+                    thisSessionType = SessionType::QUALIFY;
+                else if (sessionNameStr == "RACE")
+                    thisSessionType = SessionType::RACE;
+
+                // rows are compared against whatever this slot held before, as long as it's the same session
+                if (numSessions >= ir_session_pointer->numSessions || results.sessionNum != session) {
+                    results.numRows = 0;
+                    results.rowsHash = 0;
+                }
+
+                results.hash = hash;
+                results.sessionNum = session;
+                results.type = thisSessionType;
+
+                std::string_view str;
+                parseYamlStr(yaml, sessionNumYaml, "SessionTime:", str);
+                results.isUnlimitedTime = int(str == "unlimited");
+
+                parseYamlStr(yaml, sessionNumYaml, "SessionLaps:", str);
+                results.isUnlimitedLaps = int(str == "unlimited");
             }
+
+            const int resultsYaml = yaml.findPath(sessionNumYaml, "ResultsPositions:");
+            const unsigned long long rowsHash = yaml.getHash(resultsYaml);
+            if (rowsHash != results.rowsHash || !rowsHash) {
+                ir_decodeResults(yaml, resultsYaml, results);
+                results.rowsHash = rowsHash;
+            }
+            numSessions++;
         }
+        ir_session_pointer->numSessions = numSessions;
     }
 
-    const char* sessionInfoYaml = strstr(sessionYaml, "SessionInfo:");
-    
-    // Session info (may override qual results from above, but that's ok since hopefully they're the same!)
-    for (int session = 0; ; ++session)
+    ir_resolveSession(ir_session_pointer, sessionNum, playerCarClass);
+
+    ir_session_pointer->initialized = true;
+}
+
+// The last decoded session is kept on disk, so that when iRon starts up in the middle
+// of a session it can show that right away and then only patch what changed since.
+// Flat image of the Session, with the strings it points to stored after it.
+static_assert( std::is_trivially_copyable_v<Session>, "the session cache stores Session as a flat image" );
+
+static const char*      IR_SESSION_CACHE_FILE    = "session_cache.bin";
+static const unsigned   IR_SESSION_CACHE_MAGIC   = 0x43535249; // "IRSC"
+static const int        IR_SESSION_CACHE_VERSION = 3;
+
+struct SessionCacheHeader
+{
+    unsigned            magic;
+    int                 version;
+    int                 sessionSize;    // sizeof(Session), a build with a different layout ignores the file
+    int                 subsessionId;
+    unsigned long long  contentHash;    // of the session string it was decoded from
+    unsigned long long  payloadHash;    // of everything after the header
+};
+
+template<typename F>
+static void ir_forEachStr( Session& s, F f )
+{
+    for( Car& car : s.cars )
     {
+        f( car.userName );
+        f( car.teamName );
+        f( car.carNumberStr );
+        f( car.carName );
+        f( car.licenseStr );
+        f( car.licenseColStr );
+        f( car.classColStr );
+    }
+    f( s.trackName );
+}
 
-        sprintf(path, "\n - SessionNum: %d", session);
-        const char* sessionNumYamlTmp = strstr(sessionInfoYaml, path);
-        if (sessionNumYamlTmp == nullptr) break;
+static void ir_saveSessionCache( Session& s, unsigned long long contentHash )
+{
+    std::string buf( sizeof(SessionCacheHeader), '\0' );
+    buf.append( (const char*)&s, sizeof(Session) );
+    ir_forEachStr( s, [&buf]( const Str& str ) {
+        const int len = str.size();
+        buf.append( (const char*)&len, sizeof(len) );
+        buf.append( str.c_str(), len );
+    } );
+
+    SessionCacheHeader h = {};
+    h.magic        = IR_SESSION_CACHE_MAGIC;
+    h.version      = IR_SESSION_CACHE_VERSION;
+    h.sessionSize  = (int)sizeof(Session);
+    h.subsessionId = s.subsessionId;
+    h.contentHash  = contentHash;
+    h.payloadHash  = irsdkYamlIndex::hash( buf.data() + sizeof(h), (int)(buf.size() - sizeof(h)) );
+    memcpy( buf.data(), &h, sizeof(h) );
+
+    // Write next to it and swap it in, so a crash mid-write can't leave half a file behind
+    const std::string tmp = std::string(IR_SESSION_CACHE_FILE) + ".tmp";
+    if( !saveFile( tmp, buf ) )
+        return;
+    std::error_code ec;
+    std::filesystem::rename( tmp, IR_SESSION_CACHE_FILE, ec );
+}
 
-        const char* sessionNumYaml = sessionNumYamlTmp + 16; // +16 to skip the searched string
-        std::string sessionNameStr;
-        if (!parseYamlStr(sessionNumYaml, "SessionName:", sessionNameStr)) {
-            break;
+static bool ir_loadSessionCache( int subsessionId, Session* s, unsigned long long* contentHash )
+{
+    std::string buf;
+    if( !loadFile( IR_SESSION_CACHE_FILE, buf ) || buf.size() < sizeof(SessionCacheHeader) + sizeof(Session) )
+        return false;
+
+    SessionCacheHeader h;
+    memcpy( &h, buf.data(), sizeof(h) );
+    if( h.magic != IR_SESSION_CACHE_MAGIC || h.version != IR_SESSION_CACHE_VERSION || h.sessionSize != (int)sizeof(Session) || h.subsessionId != subsessionId )
+        return false;
+    if( h.payloadHash != irsdkYamlIndex::hash( buf.data() + sizeof(h), (int)(buf.size() - sizeof(h)) ) )
+        return false;
+
+    // The string handles in the image are meaningless now, every one of them gets replaced below
+    memcpy( (void*)s, buf.data() + sizeof(h), sizeof(Session) );
+
+    const char* p   = buf.data() + sizeof(h) + sizeof(Session);
+    const char* end = buf.data() + buf.size();
+    bool ok = true;
+    ir_forEachStr( *s, [&]( Str& str ) {
+        int len = 0;
+        if( !ok || end - p < (ptrdiff_t)sizeof(len) ) {
+            ok = false;
+            return;
         }
-            
-        SessionType thisSessionType = SessionType::UNKNOWN;
-        if (sessionNameStr == "PRACTICE")
-            thisSessionType = SessionType::PRACTICE;
-        else if (sessionNameStr == "QUALIFY")
-            thisSessionType = SessionType::QUALIFY;
-        else if (sessionNameStr == "RACE")
-            thisSessionType = SessionType::RACE;
-
-        if (session == ir_SessionNum.getInt()) { // Set the current session name
-            ir_session_pointer->sessionType = thisSessionType;
+        memcpy( &len, p, sizeof(len) );
+        p += sizeof(len);
+        if( len < 0 || end - p < len ) {
+            ok = false;
+            return;
         }
+        str = s_ir_strings.intern( p, len );
+        p += len;
+    } );
+
+    if( !ok || p != end )
+    {
+        *s = Session();
+        return false;
+    }
+
+    *contentHash = h.contentHash;
+    return true;
+}
+
+// Session string parsing runs on a worker of its own. ir_tick() hands it a private
+// copy of the newest string, along with the telemetry the decode depends on, and the
+// worker decodes that into a Session only it touches and publishes a copy of it.
+// The main thread switches over in ir_tick(), so g_ir_session never changes under an overlay.
+//
+// Three slots: the one the main thread reads (s_ir_sessionLive), the newest publish, and one
+// to write the next publish into. s_ir_sessionPublished is handed over with exchange(), so
+// exactly one side owns an unadopted publish at any time.
+static Session                  s_ir_sessionWork;
+static std::atomic<Session*>    s_ir_sessionPublished( nullptr );
+static std::atomic<Session*>    s_ir_sessionLive( &g_ir_session_data[0] );
+static Session*                 s_ir_sessionLastPublished = nullptr;    // worker only
+
+// What ir_tick() hands the worker
+struct SessionParseJob
+{
+    std::shared_ptr<const char> sessionYaml;    // null to decode the last string again
+    int                         sessionNum = -1;
+    int                         playerCarClass = -1;
+    std::chrono::steady_clock::time_point postedAt;
+};
 
-        std::string str;
-        parseYamlStr(sessionNumYaml, "SessionTime:", str);
-        ir_session_pointer->isUnlimitedTime = int(str == "unlimited");
+struct SessionParseQueue
+{
+    std::mutex                  lock;
+    std::condition_variable     wake;
+    SessionParseJob             pending;
+    bool                        hasPending = false;
+    bool                        stop = false;
+    std::thread                 thread;
+};
+static SessionParseQueue        s_ir_parseQueue;
+
+// Telemetry last handed to the worker, main thread only
+static int                      s_ir_postedSessionNum = -1;
+static int                      s_ir_postedPlayerCarClass = -1;
+
+// The cache is written when a new subsession shows up, then at most every
+// IR_SESSION_CACHE_INTERVAL while the string keeps changing, and on shutdown. Worker only.
+static const std::chrono::seconds IR_SESSION_CACHE_INTERVAL( 30 );
+static unsigned long long      s_ir_sessionCachedHash = 0;
+static int                     s_ir_sessionCachedSubsessionId = 0;
+static bool                    s_ir_sessionCacheDirty = false;
+static unsigned long long      s_ir_sessionDirtyHash = 0;
+static std::chrono::steady_clock::time_point s_ir_sessionCacheSavedAt;
+
+static void ir_flushSessionCache()
+{
+    if( !s_ir_sessionCacheDirty )
+        return;
 
-        parseYamlStr(sessionNumYaml, "SessionLaps:", str);
-        ir_session_pointer->isUnlimitedLaps = int(str == "unlimited");
+    ir_saveSessionCache( s_ir_sessionWork, s_ir_sessionDirtyHash );
+    s_ir_sessionCachedHash = s_ir_sessionDirtyHash;
+    s_ir_sessionCachedSubsessionId = s_ir_sessionWork.subsessionId;
+    s_ir_sessionCacheDirty = false;
+    s_ir_sessionCacheSavedAt = std::chrono::steady_clock::now();
+}
 
-        for (int pos = 1; pos < IR_MAX_CARS + 1; ++pos)
+static void ir_publishSession()
+{
+    // Take back a publish the main thread hasn't adopted yet, it's ours to overwrite again.
+    // If it's gone the main thread has claimed it, and may still be reading the slot it
+    // is switching away from, so stay clear of both.
+    Session* slot = s_ir_sessionPublished.exchange( nullptr, std::memory_order_acq_rel );
+    if( !slot )
+    {
+        Session* live = s_ir_sessionLive.load( std::memory_order_acquire );
+        for( Session& s : g_ir_session_data )
         {
-            sprintf(path,"\n   - Position: %d", pos);
-            const char* sessionPositionYamlTmp = strstr(sessionNumYaml, path);
-            if (sessionPositionYamlTmp == nullptr) break;
+            if( &s != s_ir_sessionLastPublished && &s != live ) {
+                slot = &s;
+                break;
+            }
+        }
+    }
+    *slot = s_ir_sessionWork;
+    s_ir_sessionLastPublished = slot;
+    s_ir_sessionPublished.store( slot, std::memory_order_release );
+}
 
-            const char* sessionPositionYaml = sessionPositionYamlTmp + 18; // +18 to skip the searched string
+static void ir_parseAndPublish( const char* sessionYaml, int sessionNum, int playerCarClass, std::chrono::steady_clock::time_point postedAt )
+{
+    const std::chrono::steady_clock::time_point parseStart = std::chrono::steady_clock::now();
 
-            int carIdx = -1;
-            if (parseYamlInt(sessionPositionYaml, "CarIdx:", &carIdx))
-            {
-                SessionPosTimes* curCarEditing = nullptr;
+    const unsigned long long contentHash = irsdkYamlIndex::hash( sessionYaml, (int)strlen(sessionYaml) );
 
-                switch (thisSessionType) {
-                case SessionType::PRACTICE:
-                    curCarEditing = &ir_session_pointer->cars[carIdx].practice;
-                    break;
-                case SessionType::QUALIFY:
-                    curCarEditing = &ir_session_pointer->cars[carIdx].qualy;
-                    break;
-                case SessionType::RACE:
-                    curCarEditing = &ir_session_pointer->cars[carIdx].race;
-                    break;
-                }
-                if (curCarEditing == nullptr) continue;
+    // First string since we started, see if it's a session we have on disk
+    if( !s_ir_sessionWork.initialized )
+    {
+        const char* val = nullptr;
+        int valLen = 0;
+        const int subsessionId = parseYaml( sessionYaml, "WeekendInfo:SubSessionID:", &val, &valLen ) ? atoi( val ) : 0;
+
+        unsigned long long cachedHash = 0;
+        if( subsessionId && ir_loadSessionCache( subsessionId, &s_ir_sessionWork, &cachedHash ) )
+        {
+            ir_resolveSession( &s_ir_sessionWork, sessionNum, playerCarClass );
+            ir_publishSession();
+            s_ir_sessionCachedHash = cachedHash;
+            s_ir_sessionCachedSubsessionId = subsessionId;
+            s_ir_sessionCacheSavedAt = std::chrono::steady_clock::now();
+            g_ir_sessionParseStats.numCacheLoads++;
+
+            // Otherwise show it now and let the decode below patch what's different
+            if( cachedHash == contentHash )
+                return;
+        }
+    }
+
+    updateSessionStringData( sessionYaml, &s_ir_sessionWork, sessionNum, playerCarClass );
 
-                int realPos = -1;
-                parseYamlInt(sessionPositionYaml, "ClassPosition:", &realPos);
-                curCarEditing->position = realPos + 1;
+    const std::chrono::steady_clock::time_point parseEnd = std::chrono::steady_clock::now();
 
-                parseYamlFloat(sessionPositionYaml, "LastTime:", &curCarEditing->lastTime);
+    ir_publishSession();
 
-                parseYamlFloat(sessionPositionYaml, "FastestTime:", &curCarEditing->fastestTime);
+    if( contentHash != s_ir_sessionCachedHash && s_ir_sessionWork.subsessionId )
+    {
+        s_ir_sessionCacheDirty = true;
+        s_ir_sessionDirtyHash = contentHash;
+
+        // incident counts and the like change all race long, those only go out on the timer
+        if( s_ir_sessionWork.subsessionId != s_ir_sessionCachedSubsessionId ||
+            std::chrono::steady_clock::now() - s_ir_sessionCacheSavedAt >= IR_SESSION_CACHE_INTERVAL )
+            ir_flushSessionCache();
+    }
 
+    SessionParseStats& stats = g_ir_sessionParseStats;
+    const float parseMs   = std::chrono::duration<float, std::milli>( parseEnd - parseStart ).count();
+    const float latencyMs = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - postedAt ).count();
+    stats.numParsed++;
+    stats.lastParseMs = parseMs;
+    stats.lastLatencyMs = latencyMs;
+    if( parseMs > stats.maxParseMs )
+        stats.maxParseMs = parseMs;
+    if( latencyMs > stats.maxLatencyMs )
+        stats.maxLatencyMs = latencyMs;
+}
+
+static void ir_sessionParseThread()
+{
+    SessionParseQueue& q = s_ir_parseQueue;
+
+    // kept for when only the telemetry it was decoded against changes
+    std::shared_ptr<const char> lastYaml;
+
+    while( true )
+    {
+        SessionParseJob job;
+        {
+            std::unique_lock<std::mutex> lock( q.lock );
+            auto ready = [&q]{ return q.hasPending || q.stop; };
+            if( s_ir_sessionCacheDirty )
+                q.wake.wait_until( lock, s_ir_sessionCacheSavedAt + IR_SESSION_CACHE_INTERVAL, ready );
+            else
+                q.wake.wait( lock, ready );
+            if( q.stop )
+                break;
+            if( !q.hasPending )
+            {
+                // the string has been quiet since it last changed, write it out now
+                lock.unlock();
+                ir_flushSessionCache();
+                continue;
             }
+            job = std::move( q.pending );
+            q.pending = SessionParseJob();
+            q.hasPending = false;
         }
+
+        // the previous copy goes back to the pool
+        if( job.sessionYaml )
+            lastYaml = std::move( job.sessionYaml );
+        if( lastYaml )
+            ir_parseAndPublish( lastYaml.get(), job.sessionNum, job.playerCarClass, job.postedAt );
     }
-    
-    // SoF
-    double sof = 0;
-    int cnt = 0;
-    int ownClass = ir_PlayerCarClass.getInt();
-    for (int i = 0; i < IR_MAX_CARS; ++i)
-    {
-        const Car& car = ir_session_pointer->cars[i];
 
-        if (car.isPaceCar || car.isSpectator || car.userName.empty() || car.classId != ownClass)
-            continue;
+    ir_flushSessionCache();
+}
 
-        sof += car.irating;
-        cnt++;
+// Queue a session string for the worker, or just new telemetry for the last one if sessionYaml
+// is null. Whatever it hasn't gotten to yet gets replaced, only the newest string is worth parsing.
+static void ir_postSessionStr( std::shared_ptr<const char> sessionYaml, int sessionNum, int playerCarClass )
+{
+    SessionParseQueue& q = s_ir_parseQueue;
+
+    if( !q.thread.joinable() )
+        q.thread = std::thread( ir_sessionParseThread );
+
+    s_ir_postedSessionNum = sessionNum;
+    s_ir_postedPlayerCarClass = playerCarClass;
+
+    {
+        std::lock_guard<std::mutex> lock( q.lock );
+        if( !q.hasPending )
+            q.pending.postedAt = std::chrono::steady_clock::now();
+        else if( sessionYaml && q.pending.sessionYaml )
+            g_ir_sessionParseStats.numCoalesced++;
+        if( sessionYaml )
+            q.pending.sessionYaml = std::move( sessionYaml );
+        q.pending.sessionNum = sessionNum;
+        q.pending.playerCarClass = playerCarClass;
+        q.hasPending = true;
     }
-    ir_session_pointer->sof = int(sof / cnt);
-    
-    ir_session_pointer->initialized = true;
-    g_ir_session_cur = !g_ir_session_cur; // switch to this session data
+    q.wake.notify_one();
+}
+
+void ir_shutdown()
+{
+    SessionParseQueue& q = s_ir_parseQueue;
+    if( q.thread.joinable() )
+    {
+        {
+            std::lock_guard<std::mutex> lock( q.lock );
+            q.stop = true;
+        }
+        q.wake.notify_one();
+        q.thread.join();
+    }
+
+    irsdkClient::instance().stopThread();
+}
 
-    g_ir_session = ir_session_pointer;
+// Switch the main thread over to the latest published session data, if there is any
+static void ir_adoptSession()
+{
+    // Claim it, from here on the worker won't touch it
+    Session* published = s_ir_sessionPublished.exchange( nullptr, std::memory_order_acq_rel );
+    if( !published )
+        return;
+
+    // Per tick state isn't in the session string, so carry it over
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+        published->cars[carIdx].lastLapInPits = g_ir_session->cars[carIdx].lastLapInPits;
+
+    // Done with the old one once the worker sees this
+    g_ir_session = published;
+    g_ir_sessionSeq++;
+    s_ir_sessionLive.store( published, std::memory_order_release );
 
     ir_handleConfigChange();
 }
 
+// Per tick tracking, for things that may only last a tick or two
+static void ir_processLine( const char* data )
+{
+    // Track cars in pits. Reset every time we're in the 'warmup' phase (just before starting pace laps).
+    const int  sessionState = ir_SessionState.get<int>( data );
+    const bool resetPitAge = sessionState == irsdk_StateWarmup;
+    const std::span<const bool> carIdxOnPitRoad = ir_CarIdxOnPitRoad.span<bool>( data );
+    const std::span<const int>  carIdxLap       = ir_CarIdxLap.span<int>( data );
+    const int numCars = ir_numCars( carIdxOnPitRoad, carIdxLap );
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+    {
+        Car& car = g_ir_session->cars[carIdx];
+        if( resetPitAge )
+            car.lastLapInPits = 0;
+        if( sessionState >= 0 /* work around getting garbage sometimes (?) */ && carIdx < numCars && carIdxOnPitRoad[carIdx] )
+            car.lastLapInPits = carIdxLap[carIdx];
+    }
+
+    // Remember the fuel level on the exact tick we started a new lap
+    const int driverCarIdx = g_ir_session->driverCarIdx;
+    if( driverCarIdx >= 0 )
+    {
+        const int lap = ir_CarIdxLap.get<int>( data, driverCarIdx );
+        if( lap != g_ir_lapCrossing.lap )
+        {
+            g_ir_lapCrossing.lap = lap;
+            g_ir_lapCrossing.fuelLevel = ir_FuelLevel.get<float>( data );
+        }
+    }
+}
+
+static int ir_resolvePosition( int classPosition, const Car& car )
+{
+    // Try the different sources we have for position data, in descending order of importance
+    if( classPosition > 0 )
+        return classPosition;
+
+    if( car.race.position > 0 )
+        return car.race.position;
+
+    if( car.qualy.position > 0 )
+        return car.qualy.position;
+
+    if( car.practice.position > 0 )
+        return car.practice.position;
+
+    return 0;
+}
+
+static int ir_resolveClassId( int carClass, const Car& car )
+{
+    if( carClass > 0 )
+        return carClass;
+
+    if( car.classId > 0 )
+        return car.classId;
+
+    return 0;
+}
+
+// Copy a whole CarIdx variable into the table, zero filling whatever the sim didn't give us
+template<typename T>
+static void ir_copyCarVar( irsdkCVar& var, T (&dst)[IR_MAX_CARS] )
+{
+    const std::span<const T> src = var.span<T>();
+    const int n = ir_numCars( src );
+    std::copy_n( src.begin(), n, dst );
+    std::fill( dst + n, dst + IR_MAX_CARS, T() );
+}
+
+static void ir_updateCarTable()
+{
+    CarTable& t = g_ir_cars;
+
+    ir_copyCarVar( ir_CarIdxClassPosition, t.classPosition );
+    ir_copyCarVar( ir_CarIdxPosition, t.overallPosition );
+    ir_copyCarVar( ir_CarIdxClass, t.classId );
+    ir_copyCarVar( ir_CarIdxLap, t.lap );
+    ir_copyCarVar( ir_CarIdxLapCompleted, t.lapCompleted );
+    ir_copyCarVar( ir_CarIdxLapDistPct, t.lapDistPct );
+    ir_copyCarVar( ir_CarIdxEstTime, t.estTime );
+    ir_copyCarVar( ir_CarIdxF2Time, t.f2Time );
+    ir_copyCarVar( ir_CarIdxLastLapTime, t.lastLapTime );
+    ir_copyCarVar( ir_CarIdxBestLapTime, t.bestLapTime );
+    ir_copyCarVar( ir_CarIdxTrackSurface, t.trackSurface );
+    ir_copyCarVar( ir_CarIdxOnPitRoad, t.onPitRoad );
+
+    // Fill in from the session info where the sim has nothing
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+    {
+        const Car& car = g_ir_session->cars[carIdx];
+        t.position[carIdx] = ir_resolvePosition( t.classPosition[carIdx], car );
+        t.classId[carIdx] = ir_resolveClassId( t.classId[carIdx], car );
+    }
+}
+
 #define THREAD_SESSION_STRING_UPDATE
 ConnectionStatus ir_tick()
 {
@@ -668,38 +1278,51 @@ ConnectionStatus ir_tick()
     irsdk.waitForData(16);
 
     if (!irsdk.isConnected()) {
+        if( g_ir_session->initialized )
+            g_ir_sessionSeq++;
         g_ir_session->initialized = false;
+        g_ir_cars = CarTable();
         return ConnectionStatus::DISCONNECTED;
     }
         
 
+    // What the session data is decoded against, read here since the worker mustn't touch live telemetry
+    const int sessionNum     = ir_SessionNum.getInt();
+    const int playerCarClass = ir_PlayerCarClass.getInt();
+
     if( irsdk.wasSessionStrUpdated() )
     {
-        g_ir_session_data[!g_ir_session_cur].initialized = false;
 #ifdef THREAD_SESSION_STRING_UPDATE
-        std::thread sessionStrUpdate = std::thread(updateSessionStringData, irsdk.getSessionStr(), &g_ir_session_data[!g_ir_session_cur]);
-        sessionStrUpdate.detach();
+        ir_postSessionStr( irsdk.copySessionStr(), sessionNum, playerCarClass );
 #else
-        std::chrono::steady_clock::time_point debugTimeStart = std::chrono::high_resolution_clock::now();
-        updateSessionStringData(irsdk.getSessionStr(), &g_ir_session_data[!g_ir_session_cur]);
-        std::chrono::steady_clock::time_point debugTimeEnd = std::chrono::high_resolution_clock::now();
-            
-        long long debugTimeDiff = std::chrono::duration_cast<std::chrono::microseconds>(debugTimeEnd - debugTimeStart).count();
-        printf("YAML Parsing took %.5d microseconds\n", debugTimeDiff);
+        std::shared_ptr<const char> sessionYaml = irsdk.copySessionStr();
+        if( sessionYaml )
+        {
+            ir_parseAndPublish( sessionYaml.get(), sessionNum, playerCarClass, std::chrono::steady_clock::now() );
+            printf("YAML Parsing took %.3f ms\n", g_ir_sessionParseStats.lastParseMs.load());
+        }
 #endif
 
     } // if session string updated
-
-    // Track cars in pits. Reset every time we're in the 'warmup' phase (just before starting pace laps).
-    const bool resetPitAge = ir_SessionState.getInt() == irsdk_StateWarmup;
-    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+#ifdef THREAD_SESSION_STRING_UPDATE
+    else if( sessionNum != s_ir_postedSessionNum || playerCarClass != s_ir_postedPlayerCarClass )
     {
-        Car& car = g_ir_session->cars[carIdx];
-        if( resetPitAge )
-            car.lastLapInPits = 0;
-        if( ir_SessionState.getInt() >= 0 /* work around getting garbage sometimes (?) */ && ir_CarIdxOnPitRoad.getBool(carIdx) )
-            car.lastLapInPits = ir_CarIdxLap.getInt(carIdx);
+        // New session or car class without a new string, decode the last one against them
+        ir_postSessionStr( nullptr, sessionNum, playerCarClass );
     }
+#endif
+
+    ir_adoptSession();
+
+    // Go through every tick we got since last time in catch-up mode, or just the current one otherwise
+    const char* line = irsdk.popQueuedData();
+    if( !line )
+        line = irsdk.getData();
+    for( ; line; line = irsdk.popQueuedData() )
+        ir_processLine( line );
+
+    // Everything the overlays need per car, in one place
+    ir_updateCarTable();
 
     // Check for both ir_IsOnTrack and ir_IsOnTrackCar, because I've seen iRacing report true for ir_IsOnTrack 
     // (for just a short time) even when we're not in the car in a practice session. Checking both does seem
@@ -709,21 +1332,30 @@ ConnectionStatus ir_tick()
 
 void ir_handleConfigChange()
 {
-    std::vector<std::string> buddies = g_cfg.getStringVec( "General", "buddies", {} );
-    std::vector<std::string> flagged = g_cfg.getStringVec( "General", "flagged", {} );
+    irsdkClient::instance().setSubscriptionMode( g_cfg.getBool( "General", "subscribe_variables", false ) );
+    irsdkClient::instance().setCatchUpMode( g_cfg.getBool( "General", "catch_up_ticks", true ) );
+
+    // Interned the same way as the session's user names, so matching them is a handle compare
+    std::vector<Str> buddies;
+    for( const std::string& name : g_cfg.getStringVec( "General", "buddies", {} ) )
+        buddies.push_back( s_ir_strings.intern( name ) );
+
+    std::vector<Str> flagged;
+    for( const std::string& name : g_cfg.getStringVec( "General", "flagged", {} ) )
+        flagged.push_back( s_ir_strings.intern( name ) );
 
     for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
     {
         Car& car = g_ir_session->cars[carIdx];
 
         car.isBuddy = 0;
-        for( const std::string& name : buddies ) {
+        for( const Str& name : buddies ) {
             if( name == car.userName )
                 car.isBuddy = 1;
         }
 
         car.isFlagged = 0;
-        for( const std::string& name : flagged ) {
+        for( const Str& name : flagged ) {
             if( name == car.userName )
                 car.isFlagged = 1;
         }
@@ -749,24 +1381,7 @@ float ir_estimateLaptime()
 
 int ir_getPosition( int carIdx )
 {
-    // Try the different sources we have for position data, in descending order of importance
-    int pos = ir_CarIdxClassPosition.getInt(carIdx);
-    if( pos > 0 )
-        return pos;
-
-    pos = g_ir_session->cars[carIdx].race.position;
-    if( pos > 0 )
-        return pos;
-
-    pos = g_ir_session->cars[carIdx].qualy.position;
-    if( pos > 0 )
-        return pos;
-
-    pos = g_ir_session->cars[carIdx].practice.position;
-    if( pos > 0 )
-        return pos;
-
-    return 0;
+    return ir_resolvePosition( ir_CarIdxClassPosition.getInt(carIdx), g_ir_session->cars[carIdx] );
 }
 
 int ir_getPositionsChanged(int carIdx)
@@ -842,15 +1457,71 @@ void ir_getSessionTimeRemaining(int& hours, int& mins, int& secs) {
 
 int ir_getClassId(int carIdx)
 {
-    int id = ir_CarIdxClass.getInt(carIdx);
-    if (id > 0)
-        return id;
+    return ir_resolveClassId( ir_CarIdxClass.getInt(carIdx), g_ir_session->cars[carIdx] );
+}
 
-    id = g_ir_session->cars[carIdx].classId;
-    if (id > 0)
-        return id;
+void ir_benchmarkVariables()
+{
+    irsdkClient& irsdk = irsdkClient::instance();
+    if( !irsdk.isConnected() || !ir_CarIdxLapDistPct.isValid() )
+        return;
 
-    return 0;
+    const int idx = irsdk.getVarIdx( "CarIdxLapDistPct" );
+    const int iterations = 100000;
+    volatile float sink = 0;
+
+    auto timeIt = [&]( const char* name, auto&& fn ) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for( int i=0; i<iterations; ++i )
+            for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+                sink = sink + fn( carIdx );
+        const auto end = std::chrono::high_resolution_clock::now();
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        printf( "    %-32s %6.2f ns/access\n", name, ns / ((double)iterations * IR_MAX_CARS) );
+    };
+
+    printf("IRSDK variable access (CarIdxLapDistPct, %d x %d reads):\n", iterations, IR_MAX_CARS);
+    timeIt( "irsdkClient::getVarFloat(idx)", [&]( int i ) { return irsdk.getVarFloat( idx, i ); } );
+    timeIt( "irsdkCVar::getFloat()", [&]( int i ) { return ir_CarIdxLapDistPct.getFloat( i ); } );
+    timeIt( "irsdkCVar::get<float>()", [&]( int i ) { return ir_CarIdxLapDistPct.get<float>( i ); } );
+    const std::span<const float> lapDistPct = ir_CarIdxLapDistPct.span<float>();
+    timeIt( "irsdkCVar::span<float>()", [&]( int i ) { return lapDistPct[i]; } );
+}
+
+void ir_benchmarkCarTable()
+{
+    if( !irsdkClient::instance().isConnected() || !ir_CarIdxLap.isValid() )
+        return;
+
+    const int iterations = 10000;
+    volatile float sink = 0;
+
+    auto timeIt = [&]( const char* name, auto&& fn ) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for( int i=0; i<iterations; ++i )
+            fn();
+        const auto end = std::chrono::high_resolution_clock::now();
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        printf( "    %-32s %8.0f ns/tick\n", name, ns / iterations );
+    };
+
+    std::set<int> classes;
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+        if( g_ir_session->cars[carIdx].userName.size() )
+            classes.insert( ir_getClassId(carIdx) );
+
+    printf("CarTable (%d cars, %d classes, %d iterations):\n", IR_MAX_CARS, (int)classes.size(), iterations);
+    timeIt( "per-car irsdkCVar reads", [&]() {
+        for( int i=0; i<IR_MAX_CARS; ++i )
+            sink = sink + (float)ir_getPosition(i) + (float)ir_getClassId(i) + (float)ir_CarIdxPosition.getInt(i)
+                + (float)ir_CarIdxLap.getInt(i) + (float)ir_CarIdxLapCompleted.getInt(i) + ir_CarIdxLapDistPct.getFloat(i)
+                + ir_CarIdxEstTime.getFloat(i) + ir_CarIdxF2Time.getFloat(i) + ir_CarIdxLastLapTime.getFloat(i)
+                + ir_CarIdxBestLapTime.getFloat(i) + (float)ir_CarIdxTrackSurface.getInt(i) + (float)ir_CarIdxOnPitRoad.getBool(i);
+    } );
+    timeIt( "ir_updateCarTable()", [&]() {
+        ir_updateCarTable();
+        sink = sink + g_ir_cars.lapDistPct[IR_MAX_CARS-1];
+    } );
 }
 
 void ir_printVariables()
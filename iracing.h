@@ -28,9 +28,13 @@ SOFTWARE.
 #include "irsdk/irsdk_client.h"
 #include "irsdk/yaml_parser.h"
 #include <string>
+#include <algorithm>
+#include <atomic>
 #include "util.h"
+#include "StrArena.h"
 
 #define IR_MAX_CARS 64
+#define IR_MAX_SESSIONS 16
 
 using namespace std;
 
@@ -59,20 +63,43 @@ struct SessionPosTimes
     int             position = 0;
 };
 
+// One row of a session's results as it was decoded, kept so that the next
+// session string update only has to decode the rows that changed
+struct SessionResultsRow
+{
+    unsigned long long hash = 0;
+    int             carIdx = -1;
+    bool            hasLastTime = false;
+    bool            hasFastestTime = false;
+    SessionPosTimes times;
+};
+
+struct SessionResults
+{
+    unsigned long long hash = 0;
+    unsigned long long rowsHash = 0;    // of the rows as they were decoded, 0 if they haven't been
+    int             sessionNum = -1;
+    SessionType     type = SessionType::UNKNOWN;
+    int             isUnlimitedTime = 0;
+    int             isUnlimitedLaps = 0;
+    int             numRows = 0;
+    SessionResultsRow rows[IR_MAX_CARS];
+};
+
 struct Car
 {    
-    string          userName;
-    string          teamName;
+    Str             userName;
+    Str             teamName;
     int             carNumber = 0;
-    string          carNumberStr;
-    string          carName;
+    Str             carNumberStr;
+    Str             carName;
     int             carID;
-    string          licenseStr;
+    Str             licenseStr;
     char            licenseChar = 'R';
     float           licenseSR = 0;
-    string          licenseColStr;
+    Str             licenseColStr;
     float4          licenseCol = float4(0,0,0,1);
-    string          classColStr;
+    Str             classColStr;
     float4          classCol = float4(0, 0, 0, 1);
     int             classId = 0;
     int             irating = 0;
@@ -109,8 +136,18 @@ struct Session
     float           rpmSLShift = 0;
     float           rpmSLLast = 0;
     float           rpmSLBlink = 0;
-		std::string			trackName;
+		Str			    trackName;
 
+    // Hashes of the parts of the session string the above was decoded from,
+    // see updateSessionStringData()
+    unsigned long long weekendInfoHash = 0;
+    unsigned long long driverInfoHash = 0;
+    unsigned long long sessionInfoHash = 0;
+    unsigned long long qualifyResultsInfoHash = 0;
+    unsigned long long carHash[IR_MAX_CARS] = {};
+    int             numSessions = 0;
+    SessionResults  sessions[IR_MAX_SESSIONS];
+    SessionResults  qualifyResults;
 };
 
 extern irsdkCVar ir_SessionTime;    // double[1] Seconds since session start (s)
@@ -409,17 +446,67 @@ extern irsdkCVar ir_LFSHshockDefl_ST;    // float[6] LFSH shock deflection at 36
 extern irsdkCVar ir_LFSHshockVel;    // float[1] LFSH shock velocity (m/s)
 extern irsdkCVar ir_LFSHshockVel_ST;    // float[6] LFSH shock velocity at 360 Hz (m/s)
 
+// Lap and fuel level of the tick the driver last started a new lap on.
+// Tracked tick by tick in ir_tick(), so it's exact even when we render late.
+struct LapCrossing
+{
+    int             lap = -1;
+    float           fuelLevel = 0;
+};
+
+// The per-car variables of the current tick, one array per field, built once in ir_tick()
+// so the overlays don't each go back to the sim variables and session info car by car.
+// Variables the sim doesn't provide read as 0, same as through irsdkCVar.
+struct CarTable
+{
+    int             position[IR_MAX_CARS];          // best known position, see ir_getPosition()
+    int             classId[IR_MAX_CARS];           // see ir_getClassId()
+    int             classPosition[IR_MAX_CARS];     // ir_CarIdxClassPosition
+    int             overallPosition[IR_MAX_CARS];   // ir_CarIdxPosition
+    int             lap[IR_MAX_CARS];               // ir_CarIdxLap
+    int             lapCompleted[IR_MAX_CARS];      // ir_CarIdxLapCompleted
+    float           lapDistPct[IR_MAX_CARS];        // ir_CarIdxLapDistPct
+    float           estTime[IR_MAX_CARS];           // ir_CarIdxEstTime
+    float           f2Time[IR_MAX_CARS];            // ir_CarIdxF2Time
+    float           lastLapTime[IR_MAX_CARS];       // ir_CarIdxLastLapTime
+    float           bestLapTime[IR_MAX_CARS];       // ir_CarIdxBestLapTime
+    int             trackSurface[IR_MAX_CARS];      // ir_CarIdxTrackSurface
+    bool            onPitRoad[IR_MAX_CARS];         // ir_CarIdxOnPitRoad
+};
+
+// Session string parse worker, see ir_tick()
+struct SessionParseStats
+{
+    std::atomic<int>    numParsed = 0;
+    std::atomic<int>    numCoalesced = 0;   // updates replaced by a newer one before the worker got to them
+    std::atomic<int>    numCacheLoads = 0;  // sessions shown straight from the on-disk cache
+    std::atomic<float>  lastParseMs = 0;    // decoding only
+    std::atomic<float>  maxParseMs = 0;
+    std::atomic<float>  lastLatencyMs = 0;  // from ir_tick() seeing the update to the new session data being published
+    std::atomic<float>  maxLatencyMs = 0;
+};
+
 extern Session* g_ir_session;
-extern Session g_ir_session_data[2];
-extern bool g_ir_session_cur;
+extern unsigned g_ir_sessionSeq;   // bumped whenever g_ir_session changes, the slots it points to get reused
+extern Session g_ir_session_data[3];
+extern SessionParseStats g_ir_sessionParseStats;
+extern LapCrossing g_ir_lapCrossing;
+extern CarTable g_ir_cars;
 
-// Update the session string data. Parses YAML, send to another thread
-void updateSessionStringData(const char* sessionYaml, Session* ir_session_pointer);
+// Decode a session string into the session data. Only the parts that changed since
+// the last string decoded into the same Session are parsed again. sessionNum and
+// playerCarClass are the SessionNum and PlayerCarClass telemetry to decode against.
+void updateSessionStringData(const char* sessionYaml, Session* ir_session_pointer, int sessionNum, int playerCarClass);
 
 // Keep the session data updated.
 // Will block for around 16 milliseconds.
+// Session string updates are parsed on a worker thread, g_ir_session switches to
+// the result in a later call and only ever changes in here.
 ConnectionStatus ir_tick();
 
+// Stop the session parse worker and the telemetry thread, before main() returns.
+void ir_shutdown();
+
 // Let the session data tracking know that the config has changed.
 void ir_handleConfigChange();
 
@@ -451,5 +538,20 @@ void ir_getSessionTimeRemaining(int& hours, int& mins, int& secs);
 // Get car class id
 int ir_getClassId(int carIdx);
 
+// Number of cars covered by all of the given CarIdx spans, at most IR_MAX_CARS,
+// so a loop over them needs no further bounds checks. Zero if one isn't available.
+template<typename... Spans>
+int ir_numCars( const Spans&... spans )
+{
+    return (int)std::min<size_t>( { (size_t)IR_MAX_CARS, spans.size()... } );
+}
+
 // Print all the variables the sim supports.
 void ir_printVariables();
+
+// Time the different ways of reading a variable from the current line.
+void ir_benchmarkVariables();
+
+// Time building the CarTable against reading the same per-car values variable by variable.
+// Against the live session, tools/irsdk_carbench does the same on a generated 64-car field.
+void ir_benchmarkCarTable();
@@ -29,10 +29,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 
 #include <assert.h>
+#include <algorithm>
+#include <chrono>
 #include "irsdk_defines.h"
 #include "yaml_parser.h"
 #include "irsdk_client.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IRSDK_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
 #pragma warning(disable:4996)
 
 irsdkClient& irsdkClient::instance()
@@ -43,61 +50,447 @@ irsdkClient& irsdkClient::instance()
 
 bool irsdkClient::waitForData(int timeoutMS)
 {
+	// without an ingest thread we pull the data in ourselves
+	if(!m_threadRunning)
+	{
+		ingest(timeoutMS);
+		timeoutMS = 0;
+	}
+
+	return updateSnapshot(timeoutMS);
+}
+
+void irsdkClient::startThread()
+{
+	if(!m_threadRunning)
+	{
+		m_threadRunning = true;
+		m_thread = std::thread([this]() {
+			while(m_threadRunning)
+				ingest(16);
+		});
+	}
+}
+
+void irsdkClient::stopThread()
+{
+	if(m_threadRunning)
+	{
+		m_threadRunning = false;
+		if(m_thread.joinable())
+			m_thread.join();
+	}
+}
+
+// ingest side, fill the back slot with the next line and publish it
+bool irsdkClient::ingest(int timeoutMS)
+{
+	Snapshot *snap = &m_snap[m_writeSlot];
+
+	// slots are resized lazily as they come around
+	if(m_ingestLen && snap->nData != m_ingestLen)
+	{
+		if(snap->data) delete [] snap->data;
+		snap->nData = m_ingestLen;
+		snap->data = new char[snap->nData];
+		snap->statusID = -1;
+	}
+
+	if(m_ingestCatchUp != m_catchUp)
+	{
+		m_ingestCatchUp = m_catchUp;
+		irsdk_setCatchUp(m_ingestCatchUp);
+	}
+
+	// let a stand-in producer know how far the reader got
+	if(m_ingestAckTick != m_ackTick)
+	{
+		m_ingestAckTick = m_ackTick;
+		irsdk_ackTick(m_ingestAckTick);
+	}
+
+	// pull in the latest ranges from the reader
+	if(m_subscribe && !m_rangesDirty && m_ingestRangesVersion != m_rangesVersion)
+	{
+		std::lock_guard<std::mutex> lock(m_rangesLock);
+		m_ingestRanges = m_ranges;
+		m_ingestRangesVersion = m_rangesVersion;
+	}
+
+	// in subscription mode only copy what our variables need, but a slot
+	// has to be filled completely once per connection before that is safe
+	char *data = m_ingestLen ? snap->data : NULL;
+	const bool fullCopy = !(m_subscribe && data && !m_rangesDirty && snap->statusID == m_ingestStatusID && !m_ingestRanges.empty());
+
+	bool ready;
+	if(fullCopy)
+		ready = irsdk_waitForDataReady(timeoutMS, data);
+	else
+		ready = irsdk_waitForDataReadyRanges(timeoutMS, data, m_ingestRanges.data(), (int)m_ingestRanges.size());
+
 	// wait for start of session or new data
-	if(irsdk_waitForDataReady(timeoutMS, m_data) && irsdk_getHeader())
+	if(ready && irsdk_getHeader())
 	{
 		// if new connection, or data changed lenght then init
-		if(!m_data || m_nData != irsdk_getHeader()->bufLen)
+		if(!data || m_ingestLen != irsdk_getHeader()->bufLen)
 		{
 			// allocate memory to hold incoming data from sim
-			if(m_data) delete [] m_data;
-			m_nData = irsdk_getHeader()->bufLen;
-			m_data = new char[m_nData];
+			m_ingestLen = irsdk_getHeader()->bufLen;
+			if(snap->data) delete [] snap->data;
+			snap->nData = m_ingestLen;
+			snap->data = new char[snap->nData];
 
 			// indicate a new connection
-			m_statusID++;
+			m_ingestStatusID++;
 
-			// reset session info str status
-			m_lastSessionCt = -1;
+			// offsets may have moved
+			m_rangesDirty = true;
 
 			// and try to fill in the data
-			if(irsdk_getNewData(m_data))
+			if(irsdk_getNewData(snap->data))
+			{
+				publish(true, true);
 				return true;
+			}
 		}
-		else if(m_data)
+		else
 		{
 			// else we are allready initialized, and data is ready for processing
+			publish(true, fullCopy);
 			return true;
 		}
 	}
-	else if(!isConnected())
+	else if(m_ingestLen && !irsdk_isConnected())
 	{
 		// else session ended
-		if(m_data)
-			delete[] m_data;
+		m_ingestLen = 0;
+		publish(false, false);
+	}
+
+	return false;
+}
+
+void irsdkClient::publish(bool connected, bool fullCopy)
+{
+	Snapshot *snap = &m_snap[m_writeSlot];
+	snap->connected = connected;
+	snap->fullCopy = fullCopy;
+	if(connected)
+	{
+		snap->statusID = m_ingestStatusID;
+		snap->tickCount = irsdk_getLastTickCount();
+	}
+
+	if(connected && m_ingestCatchUp)
+		queueLine(snap, fullCopy);
+
+	m_droppedTicks = irsdk_getDroppedTicks() + m_queueOverflow;
+
+	// hand the slot over to the reader and take back whatever it left in the middle
+	m_writeSlot = m_middleSlot.exchange(m_writeSlot | SNAPSHOT_FRESH) & SNAPSHOT_SLOT;
+
+	{
+		std::lock_guard<std::mutex> lock(m_snapLock);
+	}
+	m_snapReady.notify_one();
+}
+
+void irsdkClient::queueLine(const Snapshot *snap, bool fullCopy)
+{
+	const unsigned int head = m_queueHead.load(std::memory_order_relaxed);
+
+	// reader fell too far behind, this one is lost
+	if(head - m_queueTail.load(std::memory_order_acquire) >= QUEUE_SIZE)
+	{
+		m_queueOverflow++;
+		return;
+	}
+
+	QueuedLine *line = &m_queue[head % QUEUE_SIZE];
+	if(line->nData != snap->nData)
+	{
+		if(line->data) delete [] line->data;
+		line->nData = snap->nData;
+		line->data = new char[line->nData];
+		line->statusID = -1;
+	}
+
+	// only the subscribed ranges changed if the snapshot was not a full copy
+	if(!fullCopy && line->statusID == snap->statusID)
+	{
+		for(size_t i=0; i<m_ingestRanges.size(); i++)
+			memcpy(line->data + m_ingestRanges[i].offset, snap->data + m_ingestRanges[i].offset, m_ingestRanges[i].len);
+	}
+	else
+		memcpy(line->data, snap->data, line->nData);
+	line->statusID = snap->statusID;
+
+	m_queueHead.store(head + 1, std::memory_order_release);
+}
+
+const char *irsdkClient::popQueuedData()
+{
+	unsigned int tail = m_queueTail.load(std::memory_order_relaxed);
+
+	// done with the one we handed out last time
+	if(m_queuePending)
+	{
+		m_queueTail.store(++tail, std::memory_order_release);
+		m_queuePending = false;
+	}
+
+	while(m_data && tail != m_queueHead.load(std::memory_order_acquire))
+	{
+		// lines from before a reconnect don't match our variable offsets
+		if(m_queue[tail % QUEUE_SIZE].statusID == m_statusID)
+		{
+			m_queuePending = true;
+			return m_queue[tail % QUEUE_SIZE].data;
+		}
+		m_queueTail.store(++tail, std::memory_order_release);
+	}
+
+	return NULL;
+}
+
+// reader side, swap in the newest published slot if there is one
+bool irsdkClient::updateSnapshot(int timeoutMS)
+{
+	if(!(m_middleSlot & SNAPSHOT_FRESH) && timeoutMS > 0)
+	{
+		// the lock is only there for the wakeup, slots are exchanged lock free
+		std::unique_lock<std::mutex> lock(m_snapLock);
+		m_snapReady.wait_for(lock, std::chrono::milliseconds(timeoutMS), [this]() { return (m_middleSlot & SNAPSHOT_FRESH) != 0; });
+	}
+
+	// only we clear the fresh bit, so this can not race with the writer
+	if(!(m_middleSlot & SNAPSHOT_FRESH))
+	{
+		// nothing changed since last time
+		clearDirty();
+		return false;
+	}
+
+	m_readSlot = m_middleSlot.exchange(m_readSlot) & SNAPSHOT_SLOT;
+	const Snapshot *snap = &m_snap[m_readSlot];
+
+	if(!snap->connected)
+	{
 		m_data = NULL;
 
+		// nothing left in the queue is of any use now
+		m_queueTail = m_queueHead.load();
+		m_queuePending = false;
+
+		// reset session info str status
+		m_lastSessionCt = -1;
+		m_sessionMemoCt = -1;
+		m_sessionMemoStr.reset();
+		clearDirty();
+		return false;
+	}
+
+	m_data = snap->data;
+	m_nData = snap->nData;
+	m_ackTick = snap->tickCount;
+
+	const bool newConnection = m_statusID != snap->statusID;
+	if(newConnection)
+	{
+		// indicate a new connection
+		m_statusID = snap->statusID;
+
 		// reset session info str status
 		m_lastSessionCt = -1;
+		m_sessionMemoCt = -1;
+		m_sessionMemoStr.reset();
+
+		// resolve our variables once, up front, instead of on first use
+		irsdkCVar::bindAll();
 	}
 
+	updateDirty(newConnection);
+
+	// a full line was just copied, so it is safe to switch to the new ranges
+	if(m_subscribe && m_rangesDirty && snap->fullCopy)
+		updateRanges();
+
+	return true;
+}
+
+// which 16 byte chunks of a and b differ, one flag per chunk
+static void diffChunks(const char *a, const char *b, int len, unsigned char *changed)
+{
+	const int n = len / 16;
+#ifdef IRSDK_HAVE_SSE2
+	for(int i=0; i<n; i++)
+	{
+		const __m128i x = _mm_loadu_si128((const __m128i *)(a + i*16));
+		const __m128i y = _mm_loadu_si128((const __m128i *)(b + i*16));
+		changed[i] = _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF;
+	}
+#else
+	for(int i=0; i<n; i++)
+		changed[i] = memcmp(a + i*16, b + i*16, 16) != 0;
+#endif
+	if(len % 16)
+		changed[n] = memcmp(a + n*16, b + n*16, len % 16) != 0;
+}
+
+// compare the new line against the last one, and flag the variables that changed
+void irsdkClient::updateDirty(bool newConnection)
+{
+	m_updateCount++;
+
+	if(newConnection || m_prevData.size() != (size_t)m_nData)
+	{
+		// take the layout of this connection, the sim does not change it while connected
+		m_varRanges.clear();
+		const irsdk_header *header = irsdk_getHeader();
+		const irsdk_varHeader *vh = irsdk_getVarHeaderPtr();
+		if(header && vh)
+		{
+			for(int i=0; i<header->numVars; i++)
+			{
+				irsdk_dataRange range = { vh[i].offset, vh[i].count * irsdk_VarTypeBytes[vh[i].type] };
+				m_varRanges.push_back(range);
+			}
+		}
+
+		m_prevData.assign(m_data, m_data + m_nData);
+		m_changedChunks.resize((m_nData + 15) / 16);
+		m_dirtyBits.assign((m_varRanges.size() + 63) / 64, ~0ULL);
+		m_varChangedAt.assign(m_varRanges.size(), m_updateCount);
+		m_anyDirty = true;
+		return;
+	}
+
+	// a vectorized pass over the whole line first, most of it does not change
+	// from one tick to the next, then only the variables in changed chunks are
+	// compared byte for byte
+	diffChunks(m_data, m_prevData.data(), m_nData, m_changedChunks.data());
+
+	clearDirty();
+	for(size_t i=0; i<m_varRanges.size(); i++)
+	{
+		const irsdk_dataRange &r = m_varRanges[i];
+		if(r.len <= 0 || r.offset < 0 || r.offset + r.len > m_nData)
+			continue;
+
+		bool touched = false;
+		for(int c = r.offset / 16; c <= (r.offset + r.len - 1) / 16 && !touched; c++)
+			touched = m_changedChunks[c] != 0;
+
+		if(touched && memcmp(m_data + r.offset, m_prevData.data() + r.offset, r.len) != 0)
+		{
+			m_dirtyBits[i / 64] |= 1ULL << (i % 64);
+			m_varChangedAt[i] = m_updateCount;
+			m_anyDirty = true;
+		}
+	}
+
+	memcpy(m_prevData.data(), m_data, m_nData);
+}
+
+void irsdkClient::clearDirty()
+{
+	if(m_anyDirty)
+	{
+		std::fill(m_dirtyBits.begin(), m_dirtyBits.end(), 0ULL);
+		m_anyDirty = false;
+	}
+}
+
+bool irsdkClient::isVarDirty(int idx)
+{
+	if(idx >= 0 && idx < (int)m_varRanges.size())
+		return ((m_dirtyBits[idx / 64] >> (idx % 64)) & 1) != 0;
+
 	return false;
 }
 
+int irsdkClient::getVarChangedAt(int idx)
+{
+	if(idx >= 0 && idx < (int)m_varChangedAt.size())
+		return m_varChangedAt[idx];
+
+	return -1;
+}
+
 void irsdkClient::shutdown()
 {
+	stopThread();
+
 	irsdk_shutdown();
-	if(m_data)
-		delete[] m_data;
+	for(int i=0; i<3; i++)
+	{
+		if(m_snap[i].data)
+			delete[] m_snap[i].data;
+		m_snap[i].data = NULL;
+		m_snap[i].nData = 0;
+	}
+	for(unsigned int i=0; i<QUEUE_SIZE; i++)
+	{
+		if(m_queue[i].data)
+			delete[] m_queue[i].data;
+		m_queue[i].data = NULL;
+		m_queue[i].nData = 0;
+	}
+	m_queueHead = 0;
+	m_queueTail = 0;
+	m_queuePending = false;
 	m_data = NULL;
+	m_ingestLen = 0;
 
 	// reset session info str status
 	m_lastSessionCt = -1;
+	m_sessionMemoCt = -1;
+	m_sessionMemoStr.reset();
+}
+
+void irsdkClient::setSubscriptionMode(bool enable)
+{
+	if(m_subscribe != enable)
+	{
+		m_subscribe = enable;
+		m_rangesDirty = true;
+	}
+}
+
+void irsdkClient::updateRanges()
+{
+	std::lock_guard<std::mutex> lock(m_rangesLock);
+
+	m_ranges.clear();
+	irsdkCVar::getUsedRanges(m_ranges);
+
+	std::sort(m_ranges.begin(), m_ranges.end(),
+		[](const irsdk_dataRange &a, const irsdk_dataRange &b) { return a.offset < b.offset; });
+
+	// merge overlapping and nearby ranges, a few extra bytes are cheaper than another memcpy
+	static const int maxGap = 32;
+	size_t n = 0;
+	for(size_t i=0; i<m_ranges.size(); i++)
+	{
+		if(n > 0 && m_ranges[i].offset <= m_ranges[n-1].offset + m_ranges[n-1].len + maxGap)
+		{
+			const int end = m_ranges[i].offset + m_ranges[i].len;
+			if(end > m_ranges[n-1].offset + m_ranges[n-1].len)
+				m_ranges[n-1].len = end - m_ranges[n-1].offset;
+		}
+		else
+			m_ranges[n++] = m_ranges[i];
+	}
+	m_ranges.resize(n);
+	m_rangesVersion++;
+
+	m_rangesDirty = false;
 }
 
 bool irsdkClient::isConnected()
 {
-	return m_data != NULL && irsdk_isConnected();
+	// with an ingest thread running it is the one watching the connection
+	return m_data != NULL && (m_threadRunning || irsdk_isConnected());
 }
 
 int irsdkClient::getVarIdx(const char*name)
@@ -356,12 +749,22 @@ int irsdkClient::getSessionStrVal(const char *path, char *val, int valLen)
 {
 	if(isConnected() && path && val && valLen > 0)
 	{
-		// track changes in string
-		m_lastSessionCt = getSessionCt(); 
+		// look things up in a private copy, the sim may rewrite the shared one
+		// halfway through a parse. What we looked up in the old copy no longer applies
+		if(!m_sessionMemoStr || m_sessionMemoCt != getSessionCt())
+		{
+			std::shared_ptr<const char> str = copySessionStr();
+			if(!str)
+				return 0;
+
+			m_sessionMemo.reset();
+			m_sessionMemoStr = str;
+			m_sessionMemoCt = m_lastSessionCt; // as copied
+		}
 
 		const char *tVal = NULL;
 		int tValLen = 0;
-		if(parseYaml(irsdk_getSessionInfoStr(), path, &tVal, &tValLen))
+		if(m_sessionMemo.parse(m_sessionMemoStr.get(), path, &tVal, &tValLen))
 		{
 			// dont overflow out buffer
 			int len = tValLen;
@@ -395,22 +798,147 @@ const char* irsdkClient::getSessionStr()
 	return NULL;
 }
 
+// Buffers for session string copies, with a free list per power of two size
+// class, so a new string of about the same size as the last one reuses its
+// buffer instead of allocating.
+class irsdkStrPool
+{
+public:
+	static const int MIN_SHIFT = 16; // 64 KB
+	static const int NUM_CLASSES = 8; // up to 8 MB, bigger ones are not pooled
+
+	static irsdkStrPool& instance()
+	{
+		// never destroyed, copies may still be let go of during static destruction
+		static irsdkStrPool *pool = new irsdkStrPool();
+		return *pool;
+	}
+
+	char *acquire(int size, int *sizeClass)
+	{
+		int c = 0;
+		while(c < NUM_CLASSES && (1 << (MIN_SHIFT + c)) < size)
+			c++;
+
+		if(c == NUM_CLASSES)
+		{
+			*sizeClass = -1;
+			return new char[size];
+		}
+
+		*sizeClass = c;
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			if(!m_free[c].empty())
+			{
+				char *buf = m_free[c].back();
+				m_free[c].pop_back();
+				return buf;
+			}
+		}
+		return new char[1 << (MIN_SHIFT + c)];
+	}
+
+	void release(char *buf, int sizeClass)
+	{
+		if(sizeClass < 0)
+		{
+			delete[] buf;
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_free[sizeClass].push_back(buf);
+	}
+
+protected:
+	std::mutex m_lock;
+	std::vector<char*> m_free[NUM_CLASSES];
+};
+
+std::shared_ptr<const char> irsdkClient::copySessionStr()
+{
+	static const int MAX_TRIES = 4;
+
+	const irsdk_header *header = irsdk_getHeader();
+	if(!isConnected() || !header)
+		return NULL;
+
+	irsdkStrPool &pool = irsdkStrPool::instance();
+	for(int i=0; i<MAX_TRIES; i++)
+	{
+		const int ct = getSessionCt();
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// the region is sessionInfoLen bytes, the string is usually a lot shorter
+		const char *src = irsdk_getSessionInfoStr();
+		const int len = (int)strnlen(src, header->sessionInfoLen);
+
+		int sizeClass = -1;
+		char *buf = pool.acquire(len + 1, &sizeClass);
+		memcpy(buf, src, len);
+		buf[len] = '\0';
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(getSessionCt() == ct)
+		{
+			m_lastSessionCt = ct;
+			return std::shared_ptr<const char>(buf, [sizeClass](const char *p) { irsdkStrPool::instance().release((char*)p, sizeClass); });
+		}
+
+		pool.release(buf, sizeClass);
+		m_sessionCopyRetries++;
+	}
+
+	return NULL;
+}
+
 
 //----------------------------------
 
+irsdkCVar *irsdkCVar::s_first = NULL;
+
 irsdkCVar::irsdkCVar()
 	: m_idx(-1)
 	, m_statusID(-1)
+	, m_type(irsdk_char)
+	, m_typeBytes(0)
+	, m_count(0)
+	, m_offset(0)
+	, m_used(false)
+	, m_next(s_first)
 {
 	m_name[0] = '\0';
+	s_first = this;
 }
 
 irsdkCVar::irsdkCVar(const char *name)
+	: m_idx(-1)
+	, m_statusID(-1)
+	, m_type(irsdk_char)
+	, m_typeBytes(0)
+	, m_count(0)
+	, m_offset(0)
+	, m_used(false)
+	, m_next(s_first)
 {
 	m_name[0] = '\0';
+	s_first = this;
 	setVarName(name);
 }
 
+irsdkCVar::~irsdkCVar()
+{
+	for(irsdkCVar **pp = &s_first; *pp; pp = &(*pp)->m_next)
+	{
+		if(*pp == this)
+		{
+			*pp = m_next;
+			break;
+		}
+	}
+}
+
 void irsdkCVar::setVarName(const char *name)
 {
 	if(!name || 0 != strncmp(name, m_name, sizeof(m_name)))
@@ -428,14 +956,51 @@ void irsdkCVar::setVarName(const char *name)
 	}
 }
 
-bool irsdkCVar::checkIdx()
+void irsdkCVar::bindAll()
+{
+	for(irsdkCVar *var = s_first; var; var = var->m_next)
+		var->bind();
+}
+
+void irsdkCVar::getUsedRanges(std::vector<irsdk_dataRange> &ranges)
+{
+	const int statusID = irsdkClient::instance().getStatusID();
+
+	for(irsdkCVar *var = s_first; var; var = var->m_next)
+	{
+		if(var->m_used && var->m_idx != -1 && var->m_statusID == statusID)
+		{
+			irsdk_dataRange range = { var->m_offset, var->m_count * var->m_typeBytes };
+			ranges.push_back(range);
+		}
+	}
+}
+
+void irsdkCVar::markUsed()
+{
+	m_used = true;
+	irsdkClient::instance().invalidateRanges();
+}
+
+bool irsdkCVar::bind()
 {
 	if(irsdkClient::instance().isConnected())
 	{
-		if(m_statusID != irsdkClient::instance().getStatusID())
+		m_statusID = irsdkClient::instance().getStatusID();
+		m_idx = irsdkClient::instance().getVarIdx(m_name);
+
+		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(m_idx);
+		if(vh)
 		{
-			m_statusID = irsdkClient::instance().getStatusID();
-			m_idx = irsdkClient::instance().getVarIdx(m_name);
+			m_type = vh->type;
+			m_typeBytes = irsdk_VarTypeBytes[vh->type];
+			m_count = vh->count;
+			m_offset = vh->offset;
+		}
+		else
+		{
+			m_idx = -1;
+			m_count = 0;
 		}
 
 		return (m_idx != -1);
@@ -447,49 +1012,122 @@ bool irsdkCVar::checkIdx()
 int /*irsdk_VarType*/ irsdkCVar::getType()
 {
 	if(checkIdx())
-		return irsdkClient::instance().getVarType(m_idx);
+		return m_type;
 	return 0;
 }
 
 int irsdkCVar::getCount()
 {
 	if(checkIdx())
-		return irsdkClient::instance().getVarCount(m_idx);
+		return m_count;
 	return 0;
 }
 
 bool irsdkCVar::isValid()
 {
-	checkIdx();
-	return (m_idx > -1);
+	return checkIdx();
 }
 
+bool irsdkCVar::isDirty()
+{
+	if(checkIdx())
+		return irsdkClient::instance().isVarDirty(m_idx);
+	return false;
+}
+
+int irsdkCVar::getChangedAt()
+{
+	if(checkIdx())
+		return irsdkClient::instance().getVarChangedAt(m_idx);
+	return -1;
+}
+
+// convert one entry of a bound variable, same rules as irsdkClient::getVar*()
+template<typename T>
+static T convertVar(int type, const char *data, int entry)
+{
+	switch(type)
+	{
+	// 1 byte
+	case irsdk_char:
+	case irsdk_bool:
+		return (T)(((const char*)data)[entry]);
+
+	// 4 bytes
+	case irsdk_int:
+	case irsdk_bitField:
+		return (T)(((const int*)data)[entry]);
+
+	case irsdk_float:
+		return (T)(((const float*)data)[entry]);
+
+	// 8 bytes
+	case irsdk_double:
+		return (T)(((const double*)data)[entry]);
+	}
+
+	return T();
+}
 
 bool irsdkCVar::getBool(int entry)
 {
 	if(checkIdx())
-		return irsdkClient::instance().getVarBool(m_idx, entry);
+	{
+		if(entry >= 0 && entry < m_count)
+		{
+			const char *data = irsdkClient::instance().getData() + m_offset;
+
+			// test float/double for greater than 1.0 so that
+			// we have a chance of this being usefull
+			if(m_type == irsdk_float)
+				return ((const float*)data)[entry] >= 1.0f;
+			if(m_type == irsdk_double)
+				return ((const double*)data)[entry] >= 1.0;
+			return convertVar<int>(m_type, data, entry) != 0;
+		}
+
+		// invalid offset
+		assert(false);
+	}
 	return false;
 }
 
 int irsdkCVar::getInt(int entry)
 {
 	if(checkIdx())
-		return irsdkClient::instance().getVarInt(m_idx, entry);
+	{
+		if(entry >= 0 && entry < m_count)
+			return convertVar<int>(m_type, irsdkClient::instance().getData() + m_offset, entry);
+
+		// invalid offset
+		assert(false);
+	}
 	return 0;
 }
 
 float irsdkCVar::getFloat(int entry)
 {
 	if(checkIdx())
-		return irsdkClient::instance().getVarFloat(m_idx, entry);
+	{
+		if(entry >= 0 && entry < m_count)
+			return convertVar<float>(m_type, irsdkClient::instance().getData() + m_offset, entry);
+
+		// invalid offset
+		assert(false);
+	}
 	return 0.0f;
 }
 
 double irsdkCVar::getDouble(int entry)
 {
 	if(checkIdx())
-		return irsdkClient::instance().getVarDouble(m_idx, entry);
+	{
+		if(entry >= 0 && entry < m_count)
+			return convertVar<double>(m_type, irsdkClient::instance().getData() + m_offset, entry);
+
+		// invalid offset
+		assert(false);
+	}
 	return 0.0;
 }
 
@@ -28,6 +28,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef IRSDKCLIENT_H
 #define IRSDKCLIENT_H
 
+#include <assert.h>
+#include <string.h>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <memory>
+#include <span>
+#include "yaml_parser.h"
+
 // A C++ wrapper around the irsdk calls that takes care of the details of maintaining a connection.
 // reads out the data into a cache so you don't have to worry about timming
 class irsdkClient
@@ -38,11 +49,56 @@ public:
 
 	// wait for live data, or if a .ibt file is open
 	// then read the next line from the file.
+	// With the ingest thread running this just waits for its next snapshot.
 	bool waitForData(int timeoutMS = 16);
 
+	// pull data from the sim on a thread of our own, and publish every tick
+	// into a triple buffer, so the reader never blocks on the sim or misses
+	// a tick because it was busy. Everything but waitForData() stays on the
+	// reader's thread.
+	void startThread();
+	void stopThread();
+	bool isThreadRunning() { return m_threadRunning; }
+
 	bool isConnected();
 	int getStatusID() { return m_statusID; }
 
+	// cached copy of the current line, or NULL if not connected
+	const char *getData() { return m_data; }
+
+	// subscription mode, only copy the parts of the line that irsdkCVar's
+	// have actually read from, instead of the whole line every tick.
+	// Variables not read through an irsdkCVar go stale in this mode!
+	void setSubscriptionMode(bool enable);
+	bool getSubscriptionMode() { return m_subscribe; }
+
+	// recompute the subscribed ranges after the next full copy
+	void invalidateRanges() { m_rangesDirty = true; }
+
+	// catch-up mode, read every line the sim writes in order instead of
+	// only the newest, and queue them up so per tick logic can walk through
+	// the ticks that happened between two calls to waitForData()
+	void setCatchUpMode(bool enable) { m_catchUp = enable; }
+	bool getCatchUpMode() { return m_catchUp; }
+
+	// oldest queued line, valid until the next call, or NULL if there is none
+	const char *popQueuedData();
+
+	// ticks the sim wrote that never made it to us
+	int getDroppedTicks() { return m_droppedTicks; }
+
+	// change tracking, a variable is dirty if any of its bytes changed between
+	// the previous and the current line, as of the last call to waitForData().
+	// Everything is dirty on a new connection. In subscription mode only the
+	// variables that are read are kept current, the rest may look dirty.
+	bool isVarDirty(int idx);
+	bool isAnyVarDirty() { return m_anyDirty; }
+
+	// counts the lines we took in, so a caller that does not look every time
+	// can tell if a variable changed since it last did
+	int getUpdateCount() { return m_updateCount; }
+	int getVarChangedAt(int idx);
+
 	int getVarIdx(const char*name);
 
 	// what is the base type of the data
@@ -78,11 +134,25 @@ public:
 
 	// pars string for individual value, 1 success, 0 failure, -n minimum buffer size
 	//****Note, this is a linear parser, so it is slow!
+	// Every path is only parsed for once per string update though, asking
+	// for it again is a hash lookup until the string changes.
 	int getSessionStrVal(const char *path, char *val, int valLen);
 
 	// get the whole string
+	// Points straight into the shared memory, the sim may rewrite it at any time!
 	const char *getSessionStr();
 
+	// private copy of the whole string, for reading it at leisure or on another
+	// thread. The update count is read before and after copying and the copy
+	// is retried if the sim rewrote the string in between, so it is never torn.
+	// The buffer comes out of a pool and goes back to it when the last
+	// reference is dropped. NULL if not connected or the string kept changing,
+	// wasSessionStrUpdated() stays true then.
+	std::shared_ptr<const char> copySessionStr();
+
+	// copies thrown away because the string changed while copying
+	int getSessionCopyRetries() { return m_sessionCopyRetries; }
+
 protected:
 
 	irsdkClient()
@@ -90,17 +160,132 @@ protected:
 		, m_nData(0)
 		, m_statusID(0)
 		, m_lastSessionCt(-1)
-	{ }
+		, m_sessionCopyRetries(0)
+		, m_sessionMemoCt(-1)
+		, m_subscribe(false)
+		, m_rangesDirty(true)
+		, m_rangesVersion(0)
+		, m_writeSlot(0)
+		, m_readSlot(1)
+		, m_middleSlot(2)
+		, m_ingestLen(0)
+		, m_ingestStatusID(0)
+		, m_ingestRangesVersion(-1)
+		, m_ingestCatchUp(false)
+		, m_ingestAckTick(-1)
+		, m_queueHead(0)
+		, m_queueTail(0)
+		, m_queuePending(false)
+		, m_queueOverflow(0)
+		, m_catchUp(false)
+		, m_droppedTicks(0)
+		, m_ackTick(-1)
+		, m_updateCount(0)
+		, m_anyDirty(false)
+		, m_threadRunning(false)
+	{
+		memset(m_snap, 0, sizeof(m_snap));
+		memset(m_queue, 0, sizeof(m_queue));
+	}
 
 	~irsdkClient() { shutdown(); }
 
+	// one line of data, as handed from the ingest side to the reader
+	struct Snapshot
+	{
+		char *data;
+		int nData;
+		int statusID;
+		int tickCount;
+		bool connected;
+		bool fullCopy; // false if only the subscribed ranges were copied
+	};
+
 	void shutdown();
+	void updateRanges();
+
+	// ingest side
+	bool ingest(int timeoutMS);
+	void publish(bool connected, bool fullCopy);
+	void queueLine(const Snapshot *snap, bool fullCopy);
 
+	// reader side
+	bool updateSnapshot(int timeoutMS);
+	void updateDirty(bool newConnection);
+	void clearDirty();
+
+	// reader's view of the current snapshot
 	char *m_data;
 	int m_nData;
 	int m_statusID;
 
 	int m_lastSessionCt;
+	int m_sessionCopyRetries;
+
+	// getSessionStrVal() answers from m_sessionMemoStr, a copySessionStr()
+	// taken at update m_sessionMemoCt
+	irsdkYamlMemo m_sessionMemo;
+	std::shared_ptr<const char> m_sessionMemoStr;
+	int m_sessionMemoCt;
+
+	std::atomic<bool> m_subscribe;
+	std::atomic<bool> m_rangesDirty;
+	std::atomic<int> m_rangesVersion;
+	std::mutex m_rangesLock;
+	std::vector<irsdk_dataRange> m_ranges;
+
+	// triple buffer, the writer and reader each own a slot and swap
+	// theirs with the middle one, the fresh bit marks an unread middle
+	static const int SNAPSHOT_SLOT = 3;
+	static const int SNAPSHOT_FRESH = 4;
+	Snapshot m_snap[3];
+	int m_writeSlot;
+	int m_readSlot;
+	std::atomic<int> m_middleSlot;
+
+	// only used for waking up the reader
+	std::mutex m_snapLock;
+	std::condition_variable m_snapReady;
+
+	// ingest side connection state
+	int m_ingestLen;
+	int m_ingestStatusID;
+	int m_ingestRangesVersion;
+	std::vector<irsdk_dataRange> m_ingestRanges;
+	bool m_ingestCatchUp;
+	int m_ingestAckTick;
+
+	// single producer, single consumer queue of every line read in catch-up mode
+	static const unsigned int QUEUE_SIZE = 16;
+	struct QueuedLine
+	{
+		char *data;
+		int nData;
+		int statusID;
+	};
+	QueuedLine m_queue[QUEUE_SIZE];
+	std::atomic<unsigned int> m_queueHead; // advanced by the ingest side
+	std::atomic<unsigned int> m_queueTail; // advanced by the reader
+	bool m_queuePending; // reader still holds the line at the tail
+	int m_queueOverflow;
+
+	std::atomic<bool> m_catchUp;
+	std::atomic<int> m_droppedTicks;
+
+	// tick of the snapshot the reader last took, passed on by the ingest side
+	std::atomic<int> m_ackTick;
+
+	// change tracking, all on the reader side
+	std::vector<irsdk_dataRange> m_varRanges; // bytes of each variable, by index
+	std::vector<char> m_prevData; // line the dirty bits are relative to
+	std::vector<unsigned char> m_changedChunks;
+	std::vector<unsigned long long> m_dirtyBits;
+	std::vector<int> m_varChangedAt;
+	int m_updateCount;
+	bool m_anyDirty;
+
+	std::thread m_thread;
+	std::atomic<bool> m_threadRunning;
 
 	static irsdkClient *m_instance;
 };
@@ -113,27 +298,110 @@ class irsdkCVar
 public:
 	irsdkCVar();
 	irsdkCVar(const char *name);
+	~irsdkCVar();
 
 	void setVarName(const char *name);
 
+	// resolve every live irsdkCVar against the current connection,
+	// called by irsdkClient each time the status ID changes
+	static void bindAll();
+
+	// byte ranges of every bound variable that has been read at least once
+	static void getUsedRanges(std::vector<irsdk_dataRange> &ranges);
+
 	// returns irsdk_VarType as int so we don't depend on irsdk_defines.h
 	int getType();
 	int getCount();
 	bool isValid();
 
+	// changed with the last line, see irsdkClient::isVarDirty()
+	bool isDirty();
+	// irsdkClient::getUpdateCount() as of the last change, -1 if it never did
+	int getChangedAt();
+
 	// entry is the array offset, or 0 if not an array element
 	bool getBool(int entry = 0);
 	int getInt(int entry = 0);
 	float getFloat(int entry = 0);
 	double getDouble(int entry = 0);
 
+	// typed access straight into the cached line, no conversion is done
+	// so T must match the variables type (char/bool, int/bitfield, float or double).
+	// An entry out of range gives T(), it often comes from the session string
+	template<typename T> T get(int entry = 0)
+	{
+		if(checkIdx() && (unsigned)entry < (unsigned)m_count)
+		{
+			assert(sizeof(T) == m_typeBytes);
+			return ((const T*)(irsdkClient::instance().getData() + m_offset))[entry];
+		}
+		return T();
+	}
+
+	// same as above, but read from a line other than the current one,
+	// like those returned by irsdkClient::popQueuedData()
+	template<typename T> T get(const char *data, int entry = 0)
+	{
+		if(data && checkIdx() && (unsigned)entry < (unsigned)m_count)
+		{
+			assert(sizeof(T) == m_typeBytes);
+			return ((const T*)(data + m_offset))[entry];
+		}
+		return T();
+	}
+
+	// the whole array at once, as laid out in the cached line, so loops over the
+	// CarIdx variables run over contiguous memory with no checks per element.
+	// Same type rules as get<T>(), empty if the variable is not available.
+	// Only valid until the next call to irsdkClient::waitForData().
+	template<typename T> std::span<const T> span()
+	{
+		return span<T>(irsdkClient::instance().getData());
+	}
+
+	template<typename T> std::span<const T> span(const char *data)
+	{
+		if(data && checkIdx())
+		{
+			assert(sizeof(T) == m_typeBytes);
+			if(sizeof(T) == m_typeBytes)
+				return std::span<const T>((const T*)(data + m_offset), m_count);
+		}
+		return std::span<const T>();
+	}
+
 protected:
-	bool checkIdx();
+	// fast path, only falls back to a lookup if the connection changed under us
+	bool checkIdx()
+	{
+		if(m_statusID == irsdkClient::instance().getStatusID() && irsdkClient::instance().getData())
+		{
+			if(!m_used)
+				markUsed();
+			return m_idx != -1;
+		}
+		return bind();
+	}
+	bool bind();
+	void markUsed();
 
 	static const int max_string = 32; //IRSDK_MAX_STRING
 	char m_name[max_string];
 	int m_idx;
 	int m_statusID;
+
+	// resolved from the var header on bind()
+	int m_type;
+	int m_typeBytes;
+	int m_count;
+	int m_offset;
+
+	// has been read from, so it needs to be copied in subscription mode
+	bool m_used;
+
+	// intrusive list of all variables, so we can bind them in one go
+	irsdkCVar *m_next;
+	static irsdkCVar *s_first;
 };
 
 #endif // IRSDKCLIENT_H
@@ -0,0 +1,280 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "irsdk_defines.h"
+#include "irsdk_diskclient.h"
+#include "irsdk_columns.h"
+
+#pragma warning(disable:4996)
+
+// lines transposed per write, so each column gets written in decent sized pieces
+static const int IRSDK_COLUMNS_BLOCK = 4096;
+// lines gathered from at a time, so they stay in cache while every column is picked out of them
+static const int IRSDK_COLUMNS_TILE = 32;
+
+static long long alignUp(long long ofs, long long align)
+{
+	return (ofs + align - 1) & ~(align - 1);
+}
+
+// copy elemSize bytes from every srcStride'th byte of src to dst
+static void gather(char *dst, const char *src, int srcStride, int elemSize, int count)
+{
+	switch(elemSize)
+	{
+	case 1:
+		for(int i=0; i<count; i++, src+=srcStride)
+			dst[i] = *src;
+		break;
+	case 4:
+		for(int i=0; i<count; i++, src+=srcStride)
+			memcpy(dst + i*4, src, 4);
+		break;
+	case 8:
+		for(int i=0; i<count; i++, src+=srcStride)
+			memcpy(dst + i*8, src, 8);
+		break;
+	default:
+		for(int i=0; i<count; i++, src+=srcStride)
+			memcpy(dst + i*elemSize, src, elemSize);
+		break;
+	}
+}
+
+bool irsdkColumnFile::transcode(irsdkDiskClient &ibt, const char *path)
+{
+	const irsdk_header *header = ibt.getHeader();
+	if(!header || !path)
+		return false;
+
+	const irsdk_varHeader *varHeaders = ibt.getVarHeaders();
+	const int numVars = header->numVars;
+	const int numRecords = ibt.getRecordCount();
+	const char *sessionStr = ibt.getSessionStr();
+
+	// lay the file out up front, the columns are written a block at a time out of order
+	irsdkColumnHeader h;
+	memset(&h, 0, sizeof(h));
+	h.magic = IRSDK_COLUMNS_MAGIC;
+	h.version = IRSDK_COLUMNS_VERSION;
+	h.numVars = numVars;
+	h.numRecords = numRecords;
+	h.tickRate = header->tickRate;
+	h.sessionInfoLen = (int)strlen(sessionStr) + 1;
+	h.source = *ibt.getDiskSubHeader();
+	h.varHeaderOffset = alignUp(sizeof(h), 8);
+	h.sessionInfoOffset = h.varHeaderOffset + (long long)numVars * sizeof(irsdk_varHeader);
+	h.columnTableOffset = alignUp(h.sessionInfoOffset + h.sessionInfoLen, 8);
+
+	std::vector<long long> columnTable(numVars);
+	long long ofs = h.columnTableOffset + (long long)numVars * sizeof(long long);
+	for(int i=0; i<numVars; i++)
+	{
+		ofs = alignUp(ofs, 64);
+		columnTable[i] = ofs;
+		for(int e=0; e<varHeaders[i].count; e++)
+			ofs = alignUp(ofs + (long long)numRecords * irsdk_VarTypeBytes[varHeaders[i].type], 64);
+	}
+
+	FILE *file = irsdkCreateTemp(path);
+	if(!file)
+		return false;
+
+	bool ok = fwrite(&h, 1, sizeof(h), file) == sizeof(h)
+		&& irsdkFileSeek(file, h.varHeaderOffset)
+		&& fwrite(varHeaders, sizeof(irsdk_varHeader), numVars, file) == (size_t)numVars
+		&& fwrite(sessionStr, 1, h.sessionInfoLen, file) == (size_t)h.sessionInfoLen
+		&& irsdkFileSeek(file, h.columnTableOffset)
+		&& fwrite(columnTable.data(), sizeof(long long), numVars, file) == (size_t)numVars;
+
+	// a block laid out like the file, where column i entry e starts at stagingOfs[i] + e * block size
+	std::vector<size_t> stagingOfs(numVars);
+	size_t stagingLen = 0;
+	for(int i=0; i<numVars; i++)
+	{
+		stagingOfs[i] = stagingLen;
+		stagingLen += (size_t)IRSDK_COLUMNS_BLOCK * irsdk_VarTypeBytes[varHeaders[i].type] * varHeaders[i].count;
+	}
+	std::vector<char> staging(stagingLen);
+	// lines of a block when they have to be read rather than mapped
+	std::vector<char> rows;
+
+	ibt.rewind();
+	for(int first=0; ok && first<numRecords; first+=IRSDK_COLUMNS_BLOCK)
+	{
+		const int count = numRecords - first < IRSDK_COLUMNS_BLOCK ? numRecords - first : IRSDK_COLUMNS_BLOCK;
+
+		// either way the block's lines are bufLen apart
+		const char *block = ibt.record(first);
+		if(!block)
+		{
+			rows.resize((size_t)count * header->bufLen);
+			for(int r=0; ok && r<count; r++)
+			{
+				ok = ibt.getNextData();
+				if(ok)
+					memcpy(&rows[(size_t)r * header->bufLen], ibt.getData(), header->bufLen);
+			}
+			block = rows.data();
+		}
+
+		for(int tile=0; ok && tile<count; tile+=IRSDK_COLUMNS_TILE)
+		{
+			const int tileCount = count - tile < IRSDK_COLUMNS_TILE ? count - tile : IRSDK_COLUMNS_TILE;
+			const char *src = block + (size_t)tile * header->bufLen;
+
+			for(int i=0; i<numVars; i++)
+			{
+				const int size = irsdk_VarTypeBytes[varHeaders[i].type];
+				for(int e=0; e<varHeaders[i].count; e++)
+				{
+					char *dst = &staging[stagingOfs[i] + ((size_t)e * IRSDK_COLUMNS_BLOCK + tile) * size];
+					gather(dst, src + varHeaders[i].offset + e * size, header->bufLen, size, tileCount);
+				}
+			}
+		}
+
+		for(int i=0; ok && i<numVars; i++)
+		{
+			const int size = irsdk_VarTypeBytes[varHeaders[i].type];
+			const long long columnLen = alignUp((long long)numRecords * size, 64);
+
+			for(int e=0; ok && e<varHeaders[i].count; e++)
+			{
+				ok = irsdkFileSeek(file, columnTable[i] + e * columnLen + (long long)first * size)
+					&& fwrite(&staging[stagingOfs[i] + (size_t)e * IRSDK_COLUMNS_BLOCK * size], size, count, file) == (size_t)count;
+			}
+		}
+	}
+	ibt.rewind();
+
+	// pad the last column out to its alignment, so every column can be mapped whole
+	ok = ok && irsdkFileSeek(file, ofs - 1) && fwrite("", 1, 1, file) == 1;
+
+	return irsdkCommitTemp(file, path, ok);
+}
+
+bool irsdkColumnFile::open(const char *path)
+{
+	close();
+
+	if(!m_map.open(path))
+		return false;
+
+	const char *base = m_map.getData();
+
+	const irsdkColumnHeader *h = (const irsdkColumnHeader *)base;
+	if(!m_map.contains(0, sizeof(*h)) || h->magic != IRSDK_COLUMNS_MAGIC || h->version != IRSDK_COLUMNS_VERSION
+		|| h->numVars < 0 || h->numRecords < 0 || h->sessionInfoLen <= 0
+		|| !m_map.contains(h->varHeaderOffset, (long long)h->numVars * sizeof(irsdk_varHeader))
+		|| !m_map.contains(h->sessionInfoOffset, h->sessionInfoLen) || base[h->sessionInfoOffset + h->sessionInfoLen - 1] != '\0'
+		|| h->varHeaderOffset % 8 || h->columnTableOffset % 8
+		|| !m_map.contains(h->columnTableOffset, (long long)h->numVars * sizeof(long long)))
+	{
+		m_map.close();
+		return false;
+	}
+
+	m_varHeaders = (const irsdk_varHeader *)(base + h->varHeaderOffset);
+	m_columnTable = (const long long *)(base + h->columnTableOffset);
+
+	// every column has to be in the file, so getColumn() needn't check
+	bool ok = true;
+	for(int i=0; ok && i<h->numVars; i++)
+	{
+		const int type = m_varHeaders[i].type;
+		const int count = m_varHeaders[i].count;
+		ok = type >= 0 && type < irsdk_ETCount && count >= 1 && m_columnTable[i] % 64 == 0;
+		if(ok)
+		{
+			const long long len = (long long)h->numRecords * irsdk_VarTypeBytes[type];
+			ok = m_map.contains(m_columnTable[i], (count - 1) * alignUp(len, 64) + len);
+		}
+	}
+	if(!ok)
+	{
+		close();
+		return false;
+	}
+
+	m_header = h;
+	m_varIndex.build(m_varHeaders, h->numVars);
+	m_map.advise(irsdkFileMap::Access_Sequential);
+	return true;
+}
+
+void irsdkColumnFile::close()
+{
+	m_header = NULL;
+	m_varHeaders = NULL;
+	m_columnTable = NULL;
+	m_varIndex.clear();
+	m_map.close();
+}
+
+bool irsdkColumnFile::isCurrent(irsdkDiskClient &ibt) const
+{
+	const irsdk_diskSubHeader *source = ibt.getDiskSubHeader();
+
+	return m_header && source
+		&& m_header->numRecords == ibt.getRecordCount()
+		&& m_header->numVars == ibt.getNumVars()
+		&& 0 == memcmp(&m_header->source, source, sizeof(*source));
+}
+
+const char *irsdkColumnFile::getSessionStr() const
+{
+	return m_header ? m_map.getData() + m_header->sessionInfoOffset : NULL;
+}
+
+int irsdkColumnFile::getVarIdx(const char *name) const
+{
+	if(m_header && name)
+		return m_varIndex.find(m_varHeaders, name);
+
+	return -1;
+}
+
+const irsdk_varHeader *irsdkColumnFile::getVarHeader(int idx) const
+{
+	if(m_header && idx >= 0 && idx < m_header->numVars)
+		return &m_varHeaders[idx];
+
+	return NULL;
+}
+
+const char *irsdkColumnFile::getColumnData(int idx, int entry) const
+{
+	const irsdk_varHeader *vh = getVarHeader(idx);
+	if(!vh || entry < 0 || entry >= vh->count)
+		return NULL;
+
+	const long long columnLen = alignUp((long long)m_header->numRecords * irsdk_VarTypeBytes[vh->type], 64);
+	return m_map.getData() + m_columnTable[idx] + entry * columnLen;
+}
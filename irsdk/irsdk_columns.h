@@ -0,0 +1,128 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IRSDKCOLUMNS_H
+#define IRSDKCOLUMNS_H
+
+#include <span>
+#include "irsdk_filemap.h"
+#include "irsdk_varindex.h"
+
+class irsdkDiskClient;
+
+// A .ibt turned on its side: every entry of every variable is one contiguous
+// array over all lines, so reading a channel across a whole stint only
+// touches that channel. Written next to the .ibt by irsdkColumnFile::transcode()
+// and mapped by irsdkColumnFile.
+//
+// Layout, all offsets from the start of the file:
+//   irsdkColumnHeader
+//   irsdk_varHeader[numVars]      as in the .ibt
+//   session string                as in the .ibt, NUL terminated
+//   long long[numVars]            where each variable's columns start
+//   columns                       entry 0 of a variable, then entry 1, ...
+//                                 each numRecords long, starting 64 byte aligned
+//
+// Requires irsdk_defines.h to be included first.
+
+static const int IRSDK_COLUMNS_MAGIC = 0x43544249; // "IBTC"
+static const int IRSDK_COLUMNS_VERSION = 1;
+
+struct irsdkColumnHeader
+{
+	int magic;
+	int version;
+	int numVars;
+	int numRecords;
+	int tickRate;
+	int sessionInfoLen;			// including the terminator
+	irsdk_diskSubHeader source;	// of the .ibt, to tell whether this is still a copy of it
+	long long varHeaderOffset;
+	long long sessionInfoOffset;
+	long long columnTableOffset;
+};
+
+// which irsdk_VarType a column has to be to hand it out as a span of T
+template<class T> struct irsdkColumnType;
+template<> struct irsdkColumnType<char> { static bool matches(int type) { return type == irsdk_char || type == irsdk_bool; } };
+template<> struct irsdkColumnType<bool> { static bool matches(int type) { return type == irsdk_char || type == irsdk_bool; } };
+template<> struct irsdkColumnType<int> { static bool matches(int type) { return type == irsdk_int || type == irsdk_bitField; } };
+template<> struct irsdkColumnType<unsigned int> { static bool matches(int type) { return type == irsdk_int || type == irsdk_bitField; } };
+template<> struct irsdkColumnType<float> { static bool matches(int type) { return type == irsdk_float; } };
+template<> struct irsdkColumnType<double> { static bool matches(int type) { return type == irsdk_double; } };
+
+class irsdkColumnFile
+{
+public:
+	// write the columns of ibt to path in one pass over its lines, leaves ibt rewound
+	static bool transcode(irsdkDiskClient &ibt, const char *path);
+
+	irsdkColumnFile() : m_header(NULL), m_varHeaders(NULL), m_columnTable(NULL) { }
+	~irsdkColumnFile() { close(); }
+
+	bool open(const char *path);
+	void close();
+	bool isOpen() const { return m_header != NULL; }
+
+	// false if ibt has changed since this was written from it
+	bool isCurrent(irsdkDiskClient &ibt) const;
+
+	int getNumRecords() const { return m_header ? m_header->numRecords : 0; }
+	int getNumVars() const { return m_header ? m_header->numVars : 0; }
+	int getTickRate() const { return m_header ? m_header->tickRate : 0; }
+	const char *getSessionStr() const;
+
+	int getVarIdx(const char *name) const;
+	// NULL if idx is out of range
+	const irsdk_varHeader *getVarHeader(int idx) const;
+
+	// Every line's value of entry of variable idx. Empty if either is out of
+	// range or T doesn't fit the variable's type. Valid until close().
+	template<class T> std::span<const T> getColumn(int idx, int entry = 0) const
+	{
+		const irsdk_varHeader *vh = getVarHeader(idx);
+		const char *data = getColumnData(idx, entry);
+		if(!data || !irsdkColumnType<T>::matches(vh->type))
+			return std::span<const T>();
+
+		return std::span<const T>((const T *)data, m_header->numRecords);
+	}
+	template<class T> std::span<const T> getColumn(const char *name, int entry = 0) const { return getColumn<T>(getVarIdx(name), entry); }
+
+protected:
+	const char *getColumnData(int idx, int entry) const;
+
+	irsdkFileMap m_map;
+	const irsdkColumnHeader *m_header;
+	const irsdk_varHeader *m_varHeaders;
+	const long long *m_columnTable;
+	irsdkVarIndex m_varIndex;
+
+private:
+	irsdkColumnFile(const irsdkColumnFile&);
+	irsdkColumnFile& operator=(const irsdkColumnFile&);
+};
+
+#endif // IRSDKCOLUMNS_H
@@ -81,7 +81,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // Constant Definitions
 
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
 #include <tchar.h>
+#else
+typedef char _TCHAR;
+#ifndef _T
+#define _T(x) x
+#endif
+#endif
 
 static const _TCHAR IRSDK_DATAVALIDEVENTNAME[] = _T("Local\\IRSDKDataValidEvent");
 static const _TCHAR IRSDK_MEMMAPFILENAME[]     = _T("Local\\IRSDKMemMapFileName");
@@ -396,6 +406,13 @@ struct irsdk_diskSubHeader
 	int sessionRecordCount;
 };
 
+// byte range within a line of data, see irsdk_getNewDataRanges()
+struct irsdk_dataRange
+{
+	int offset;
+	int len;
+};
+
 //----
 // Client function definitions
 
@@ -404,8 +421,21 @@ void irsdk_shutdown();
 
 bool irsdk_getNewData(char *data);
 bool irsdk_waitForDataReady(int timeOut, char *data);
+// same as above, but only copy the given ranges of the line, the rest of data is left untouched
+bool irsdk_getNewDataRanges(char *data, const irsdk_dataRange *ranges, int numRanges);
+bool irsdk_waitForDataReadyRanges(int timeOut, char *data, const irsdk_dataRange *ranges, int numRanges);
 bool irsdk_isConnected();
 
+// read every line in order, oldest unread first, rather than skipping ahead to
+// the newest one. Only lines that were overwritten before we read them are lost.
+void irsdk_setCatchUp(bool enable);
+// running count of lines the sim wrote that we never read
+int irsdk_getDroppedTicks();
+// tick count of the line last read, or -1 if there is none
+int irsdk_getLastTickCount();
+// report the tick the application has caught up to, only a stand-in producer looks at it
+void irsdk_ackTick(int tickCount);
+
 const irsdk_header *irsdk_getHeader();
 const char *irsdk_getData(int index);
 const char *irsdk_getSessionInfoStr();
@@ -28,6 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
+#include <limits.h>
 
 #include <assert.h>
 #include "irsdk_defines.h"
@@ -36,14 +37,43 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma warning(disable:4996)
 
+// whole lines between the start of the data and size, a line cut short by a crash does not count
+static int countRecords(const irsdk_header &header, long long size)
+{
+	if(header.bufLen <= 0 || size < header.varBuf[0].bufOffset)
+		return 0;
+
+	const long long count = (size - header.varBuf[0].bufOffset) / header.bufLen;
+	return count > INT_MAX ? INT_MAX : (int)count;
+}
+
+static bool isPackedFile(const char *path)
+{
+	int magic = 0;
+	FILE *file = fopen(path, "rb");
+	if(file)
+	{
+		if(fread(&magic, 1, sizeof(magic), file) != sizeof(magic))
+			magic = 0;
+		fclose(file);
+	}
+	return magic == IRSDK_PACK_MAGIC;
+}
+
 irsdkDiskClient::irsdkDiskClient()
 	: m_ibtFile(NULL)
 	, m_sessionInfoString(NULL)
 	, m_varHeaders(NULL)
 	, m_varBuf(NULL)
+	, m_data(NULL)
+	, m_numRecords(0)
+	, m_nextRecord(0)
+	, m_isPacked(false)
+	, m_blockIdx(-1)
 {
 	memset(&m_header, 0, sizeof(m_header));
 	memset(&m_diskSubHeader, 0, sizeof(m_diskSubHeader));
+	memset(&m_packHeader, 0, sizeof(m_packHeader));
 }
 
 irsdkDiskClient::irsdkDiskClient(const char *path)
@@ -51,17 +81,45 @@ irsdkDiskClient::irsdkDiskClient(const char *path)
 	, m_sessionInfoString(NULL)
 	, m_varHeaders(NULL)
 	, m_varBuf(NULL)
+	, m_data(NULL)
+	, m_numRecords(0)
+	, m_nextRecord(0)
+	, m_isPacked(false)
+	, m_blockIdx(-1)
 {
 	memset(&m_header, 0, sizeof(m_header));
 	memset(&m_diskSubHeader, 0, sizeof(m_diskSubHeader));
+	memset(&m_packHeader, 0, sizeof(m_packHeader));
 
 	openFile(path);
 }
 
-bool irsdkDiskClient::openFile(const char *path)
+bool irsdkDiskClient::openFile(const char *path, bool useMapping)
 {
 	closeFile();
 
+	// blocks are decoded straight out of the mapping, there is no FILE* path for them
+	const bool packed = isPackedFile(path);
+
+	// read through FILE* if the file can't be mapped, say a 32 bit build with a huge file
+	if((useMapping || packed) && m_map.open(path))
+	{
+		if(openMapping())
+		{
+			m_map.advise(irsdkFileMap::Access_Sequential);
+			return true;
+		}
+
+		closeFile();
+		return false;
+	}
+
+	if(packed)
+	{
+		printf("Error mapping compressed file\n");
+		return false;
+	}
+
 	m_ibtFile = fopen(path, "rb");
 	if(m_ibtFile)
 	{
@@ -84,11 +142,15 @@ bool irsdkDiskClient::openFile(const char *path)
 							size_t len = m_header.numVars * sizeof(irsdk_varHeader);
 							if(fread(m_varHeaders, 1, len, m_ibtFile) == len)
 							{
+								m_varIndex.build(m_varHeaders, m_header.numVars);
+
 								m_varBuf = new char[m_header.bufLen];
 								if(m_varBuf)
 								{
-									fseek(m_ibtFile, m_header.varBuf[0].bufOffset, SEEK_SET);
+									m_numRecords = countRecords(m_header, irsdkFileSize(m_ibtFile));
+									irsdkFileSeek(m_ibtFile, m_header.varBuf[0].bufOffset);
 
+									m_data = m_varBuf;
 									return true;
 
 									//delete [] m_varBuf;
@@ -115,11 +177,136 @@ bool irsdkDiskClient::openFile(const char *path)
 	return false;
 }
 
+// Same layout as above, but the headers are copied out of the mapping and the
+// lines are never copied at all.
+bool irsdkDiskClient::openMapping()
+{
+	const char *base = m_map.getData();
+	const size_t size = m_map.getSize();
+
+	// a compressed file is a regular one behind the pack header, offsets count from the start of the file
+	size_t headerOfs = 0;
+	if(m_map.contains(0, sizeof(m_packHeader)) && *(const int *)base == IRSDK_PACK_MAGIC)
+	{
+		memcpy(&m_packHeader, base, sizeof(m_packHeader));
+		if(m_packHeader.version != IRSDK_PACK_VERSION)
+		{
+			printf("Unsupported compressed file version %d\n", m_packHeader.version);
+			return false;
+		}
+		m_isPacked = true;
+		headerOfs = sizeof(m_packHeader);
+	}
+
+	if(!m_map.contains(headerOfs, sizeof(m_header) + sizeof(m_diskSubHeader)))
+	{
+		printf("Error reading header\n");
+		return false;
+	}
+	memcpy(&m_header, base + headerOfs, sizeof(m_header));
+	memcpy(&m_diskSubHeader, base + headerOfs + sizeof(m_header), sizeof(m_diskSubHeader));
+
+	if(m_header.sessionInfoLen <= 0 || !m_map.contains(m_header.sessionInfoOffset, m_header.sessionInfoLen))
+	{
+		printf("Error reading sessionInfoString\n");
+		return false;
+	}
+	// the mapping is read only, so the terminator needs a copy
+	m_sessionInfoString = new char[m_header.sessionInfoLen];
+	memcpy(m_sessionInfoString, base + m_header.sessionInfoOffset, m_header.sessionInfoLen);
+	m_sessionInfoString[m_header.sessionInfoLen-1] = '\0';
+
+	if(m_header.numVars < 0 || !m_map.contains(m_header.varHeaderOffset, (long long)m_header.numVars * sizeof(irsdk_varHeader)))
+	{
+		printf("Error reading varHeaders\n");
+		return false;
+	}
+	m_varHeaders = new irsdk_varHeader[m_header.numVars];
+	memcpy(m_varHeaders, base + m_header.varHeaderOffset, m_header.numVars * sizeof(irsdk_varHeader));
+	m_varIndex.build(m_varHeaders, m_header.numVars);
+
+	if(m_isPacked)
+		return openPackBlocks();
+
+	m_numRecords = countRecords(m_header, (long long)size);
+	return true;
+}
+
+bool irsdkDiskClient::openPackBlocks()
+{
+	const char *base = m_map.getData();
+
+	const int blockRecords = m_packHeader.blockRecords;
+	if(blockRecords <= 0 || m_header.bufLen <= 0)
+	{
+		printf("Error reading compressed blocks\n");
+		return false;
+	}
+
+	// the table is written on close, without it walk the blocks themselves
+	if(m_packHeader.blockTableOffset)
+	{
+		if(m_packHeader.numBlocks < 0 || !m_map.contains(m_packHeader.blockTableOffset, (long long)m_packHeader.numBlocks * sizeof(irsdkPackBlock)))
+		{
+			printf("Error reading compressed block table\n");
+			return false;
+		}
+		m_packBlocks.resize(m_packHeader.numBlocks);
+		memcpy(m_packBlocks.data(), base + m_packHeader.blockTableOffset, m_packBlocks.size() * sizeof(irsdkPackBlock));
+	}
+	else
+	{
+		// a block cut short by a crash does not count
+		long long ofs = m_header.varBuf[0].bufOffset;
+		irsdkPackBlockHeader bh;
+		while(m_map.contains(ofs, sizeof(bh)))
+		{
+			memcpy(&bh, base + ofs, sizeof(bh));
+			if(bh.size < 0 || !m_map.contains(ofs + sizeof(bh), bh.size))
+				break;
+
+			irsdkPackBlock block = { ofs, bh.size, bh.numRecords };
+			m_packBlocks.push_back(block);
+			ofs += sizeof(bh) + bh.size;
+		}
+	}
+
+	// only the last block may be short, the line to block math depends on it
+	long long numRecords = 0;
+	for(size_t i=0; i<m_packBlocks.size(); i++)
+	{
+		const irsdkPackBlock &b = m_packBlocks[i];
+		const int wanted = i + 1 < m_packBlocks.size() ? blockRecords : b.numRecords;
+		if(b.numRecords <= 0 || b.numRecords > blockRecords || b.numRecords != wanted || !m_map.contains(b.offset + sizeof(irsdkPackBlockHeader), b.size))
+		{
+			m_packBlocks.resize(i);
+			break;
+		}
+		numRecords += b.numRecords;
+	}
+	m_numRecords = numRecords > INT_MAX ? INT_MAX : (int)numRecords;
+
+	m_blockBuf.resize((size_t)blockRecords * m_header.bufLen);
+	m_blockIdx = -1;
+	return true;
+}
+
 void irsdkDiskClient::closeFile()
 {
 	if(m_varBuf)
 		delete [] m_varBuf;
 	m_varBuf = NULL;
+	m_data = NULL;
+	m_numRecords = 0;
+	m_nextRecord = 0;
+
+	m_isPacked = false;
+	memset(&m_packHeader, 0, sizeof(m_packHeader));
+	m_packBlocks.clear();
+	m_blockBuf.clear();
+	m_blockIdx = -1;
+
+	m_varIndex.clear();
 
 	if(m_varHeaders)
 		delete [] m_varHeaders;
@@ -128,28 +315,107 @@ void irsdkDiskClient::closeFile()
 	if(m_sessionInfoString)
 		delete [] m_sessionInfoString;
 	m_sessionInfoString = NULL;
+	m_sessionMemo.reset();
 
 	if(m_ibtFile)
 		fclose(m_ibtFile);
 	m_ibtFile = NULL;
+
+	m_map.close();
+}
+
+const char *irsdkDiskClient::record(int recordIdx) const
+{
+	if(!m_map.isOpen() || m_isPacked || recordIdx < 0 || recordIdx >= m_numRecords)
+		return NULL;
+
+	return m_map.getData() + m_header.varBuf[0].bufOffset + (size_t)recordIdx * m_header.bufLen;
+}
+
+const char *irsdkDiskClient::unpackRecord(int recordIdx, std::vector<char> &buf, int &bufBlock) const
+{
+	if(!m_isPacked || recordIdx < 0 || recordIdx >= m_numRecords)
+		return NULL;
+
+	const int blockRecords = m_packHeader.blockRecords;
+	const int blockIdx = recordIdx / blockRecords;
+	if(blockIdx != bufBlock)
+	{
+		const irsdkPackBlock &b = m_packBlocks[blockIdx];
+		const unsigned char *src = (const unsigned char *)m_map.getData() + b.offset + sizeof(irsdkPackBlockHeader);
+
+		buf.resize((size_t)blockRecords * m_header.bufLen);
+		if(!irsdk_unpackBlock(m_varHeaders, m_header.numVars, m_header.bufLen, src, b.size, b.numRecords, buf.data()))
+		{
+			bufBlock = -1;
+			return NULL;
+		}
+		bufBlock = blockIdx;
+	}
+
+	return buf.data() + (size_t)(recordIdx - blockIdx * blockRecords) * m_header.bufLen;
 }
 
 bool irsdkDiskClient::getNextData()
 {
-	if(m_ibtFile)
-		return fread(m_varBuf, 1, m_header.bufLen, m_ibtFile) == (size_t)m_header.bufLen;
+	if(m_map.isOpen())
+	{
+		if(m_nextRecord >= m_numRecords)
+			return false;
+
+		m_data = m_isPacked ? unpackRecord(m_nextRecord, m_blockBuf, m_blockIdx) : record(m_nextRecord);
+		if(!m_data)
+			return false;
+
+		m_nextRecord++;
+		return true;
+	}
+
+	if(m_ibtFile && fread(m_varBuf, 1, m_header.bufLen, m_ibtFile) == (size_t)m_header.bufLen)
+	{
+		m_nextRecord++;
+		return true;
+	}
 
 	return false;
 }
 
+bool irsdkDiskClient::readData(int recordIdx)
+{
+	if(!isFileOpen() || recordIdx < 0 || recordIdx >= m_numRecords)
+		return false;
+
+	m_nextRecord = recordIdx;
+	if(m_ibtFile && !irsdkFileSeek(m_ibtFile, m_header.varBuf[0].bufOffset + (long long)recordIdx * m_header.bufLen))
+		return false;
+
+	return getNextData();
+}
+
 // iRon: Custom function so we can skip and read only the final samples
 // TODO: Move to a custom module to avoid modifying the API?
 bool irsdkDiskClient::skipData(int skipAmt)
 {
-	if (m_ibtFile && skipAmt >= 0)
-		return fseek(m_ibtFile, m_header.bufLen * skipAmt, SEEK_CUR) == 0;
-		//return fseek(m_varBufa, 1, m_header.bufLen, m_ibtFile) == (size_t)m_header.bufLen;
+	if(isFileOpen() && skipAmt >= 0)
+	{
+		m_nextRecord = skipAmt > m_numRecords - m_nextRecord ? m_numRecords : m_nextRecord + skipAmt;
+		if(m_ibtFile)
+			return irsdkFileSeek(m_ibtFile, m_header.varBuf[0].bufOffset + (long long)m_nextRecord * m_header.bufLen);
+		return true;
+	}
+
+	return false;
+}
 
+bool irsdkDiskClient::rewind()
+{
+	if(isFileOpen())
+	{
+		m_nextRecord = 0;
+		if(m_ibtFile)
+			return irsdkFileSeek(m_ibtFile, m_header.varBuf[0].bufOffset);
+		return true;
+	}
 
 	return false;
 }
@@ -157,23 +423,17 @@ bool irsdkDiskClient::skipData(int skipAmt)
 // return how many variables this .ibt file has in the header
 int irsdkDiskClient::getNumVars()
 {
-	if(m_ibtFile)
+	if(isFileOpen())
 		return m_header.numVars;
 
 	return -1;
 }
 
-int irsdkDiskClient::getVarIdx(const char *name)
+int irsdkDiskClient::getVarIdx(const char *name) const
 {
-	if(m_ibtFile && name)
+	if(isFileOpen() && name)
 	{
-		for(int idx=0; idx<m_header.numVars; idx++)
-		{
-			if(0 == strncmp(name, m_varHeaders[idx].name, IRSDK_MAX_STRING))
-			{
-				return idx;
-			}
-		}
+		return m_varIndex.find(m_varHeaders, name);
 	}
 
 	return -1;
@@ -181,7 +441,7 @@ int irsdkDiskClient::getVarIdx(const char *name)
 
 irsdk_VarType irsdkDiskClient::getVarType(int idx)
 {
-	if(m_ibtFile)
+	if(isFileOpen())
 	{
 		if(idx >= 0 && idx < m_header.numVars)
 		{
@@ -198,7 +458,7 @@ irsdk_VarType irsdkDiskClient::getVarType(int idx)
 // get info on the var
 const char* irsdkDiskClient::getVarName(int idx)
 {
-	if(m_ibtFile)
+	if(isFileOpen())
 	{
 		if(idx >= 0 && idx < m_header.numVars)
 		{
@@ -214,7 +474,7 @@ const char* irsdkDiskClient::getVarName(int idx)
 
 const char* irsdkDiskClient::getVarDesc(int idx)
 {
-	if(m_ibtFile)
+	if(isFileOpen())
 	{
 		if(idx >= 0 && idx < m_header.numVars)
 		{
@@ -230,7 +490,7 @@ const char* irsdkDiskClient::getVarDesc(int idx)
 
 const char* irsdkDiskClient::getVarUnit(int idx)
 {
-	if(m_ibtFile)
+	if(isFileOpen())
 	{
 		if(idx >= 0 && idx < m_header.numVars)
 		{
@@ -246,7 +506,7 @@ const char* irsdkDiskClient::getVarUnit(int idx)
 
 int irsdkDiskClient::getVarCount(int idx)
 {
-	if(m_ibtFile)
+	if(isFileOpen())
 	{
 		if(idx >= 0 && idx < m_header.numVars)
 		{
@@ -260,15 +520,15 @@ int irsdkDiskClient::getVarCount(int idx)
 	return 0;
 }
 
-bool irsdkDiskClient::getVarBool(int idx, int entry)
+bool irsdkDiskClient::readVarBool(const char *data, int idx, int entry) const
 {
-	if(m_ibtFile)
+	if(data)
 	{
 		if(idx >= 0 && idx < m_header.numVars)
 		{
 			if(entry >= 0 && entry < m_varHeaders[idx].count)
 			{
-				const char * data = m_varBuf + m_varHeaders[idx].offset;
+				data += m_varHeaders[idx].offset;
 				switch(m_varHeaders[idx].type)
 				{
 				// 1 byte
@@ -312,15 +572,15 @@ bool irsdkDiskClient::getVarBool(int idx, int entry)
 	return false;
 }
 
-int irsdkDiskClient::getVarInt(int idx, int entry)
+int irsdkDiskClient::readVarInt(const char *data, int idx, int entry) const
 {
-	if(m_ibtFile)
+	if(data)
 	{
 		if(idx >= 0 && idx < m_header.numVars)
 		{
 			if(entry >= 0 && entry < m_varHeaders[idx].count)
 			{
-				const char * data = m_varBuf + m_varHeaders[idx].offset;
+				data += m_varHeaders[idx].offset;
 				switch(m_varHeaders[idx].type)
 				{
 				// 1 byte
@@ -361,15 +621,15 @@ int irsdkDiskClient::getVarInt(int idx, int entry)
 	return 0;
 }
 
-float irsdkDiskClient::getVarFloat(int idx, int entry)
+float irsdkDiskClient::readVarFloat(const char *data, int idx, int entry) const
 {
-	if(m_ibtFile)
+	if(data)
 	{
 		if(idx >= 0 && idx < m_header.numVars)
 		{
 			if(entry >= 0 && entry < m_varHeaders[idx].count)
 			{
-				const char * data = m_varBuf + m_varHeaders[idx].offset;
+				data += m_varHeaders[idx].offset;
 				switch(m_varHeaders[idx].type)
 				{
 				// 1 byte
@@ -410,15 +670,15 @@ float irsdkDiskClient::getVarFloat(int idx, int entry)
 	return 0.0f;
 }
 
-double irsdkDiskClient::getVarDouble(int idx, int entry)
+double irsdkDiskClient::readVarDouble(const char *data, int idx, int entry) const
 {
-	if(m_ibtFile)
+	if(data)
 	{
 		if(idx >= 0 && idx < m_header.numVars)
 		{
 			if(entry >= 0 && entry < m_varHeaders[idx].count)
 			{
-				const char * data = m_varBuf + m_varHeaders[idx].offset;
+				data += m_varHeaders[idx].offset;
 				switch(m_varHeaders[idx].type)
 				{
 				// 1 byte
@@ -462,11 +722,11 @@ double irsdkDiskClient::getVarDouble(int idx, int entry)
 //path is in the form of "DriverInfo:Drivers:CarIdx:{%d}UserName:"
 int irsdkDiskClient::getSessionStrVal(const char *path, char *val, int valLen)
 {
-	if(m_ibtFile && path && val && valLen > 0)
+	if(isFileOpen() && path && val && valLen > 0)
 	{
 		const char *tVal = NULL;
 		int tValLen = 0;
-		if(parseYaml(m_sessionInfoString, path, &tVal, &tValLen))
+		if(m_sessionMemo.parse(m_sessionInfoString, path, &tVal, &tValLen))
 		{
 			// dont overflow out buffer
 			int len = tValLen;
@@ -488,35 +748,52 @@ int irsdkDiskClient::getSessionStrVal(const char *path, char *val, int valLen)
 	return 0;
 }
 
+bool irsdkDiskCursor::seek(int recordIdx)
+{
+	const char *data = m_ibt->isPacked() ? m_ibt->unpackRecord(recordIdx, m_block, m_blockIdx) : m_ibt->record(recordIdx);
+	if(!data)
+		return false;
+
+	m_recordIdx = recordIdx;
+	m_data = data;
+	return true;
+}
+
 //-----------------
 
 irsdkDiskWriter::irsdkDiskWriter()
 	: m_ibtFile(NULL)
 	, m_diskSubHeaderOffset(0)
 	, m_isHeaderFinalized(false)
+	, m_isPacked(false)
+	, m_packRowCount(0)
 {
 	memset(&m_header, 0, sizeof(m_header));
 	memset(&m_diskSubHeader, 0, sizeof(m_diskSubHeader));
 	memset(&m_sessionInfoString, 0, sizeof(m_sessionInfoString));
 	memset(&m_varHeaders, 0, sizeof(m_varHeaders));
 	memset(m_varBuf, 0, sizeof(m_varBuf));
+	memset(&m_packHeader, 0, sizeof(m_packHeader));
 }
 
 irsdkDiskWriter::irsdkDiskWriter(const char *path)
 	: m_ibtFile(NULL)
 	, m_diskSubHeaderOffset(0)
 	, m_isHeaderFinalized(false)
+	, m_isPacked(false)
+	, m_packRowCount(0)
 {
 	memset(&m_header, 0, sizeof(m_header));
 	memset(&m_diskSubHeader, 0, sizeof(m_diskSubHeader));
 	memset(&m_sessionInfoString, 0, sizeof(m_sessionInfoString));
 	memset(&m_varHeaders, 0, sizeof(m_varHeaders));
 	memset(m_varBuf, 0, sizeof(m_varBuf));
+	memset(&m_packHeader, 0, sizeof(m_packHeader));
 
 	openFile(path);
 }
 
-bool irsdkDiskWriter::openFile(const char *path)
+bool irsdkDiskWriter::openFile(const char *path, bool compress, int blockRecords)
 {
 	assert(m_ibtFile == NULL);
 
@@ -537,6 +814,14 @@ bool irsdkDiskWriter::openFile(const char *path)
 		//****RemoveMe, fake yaml string
 		sprintf(m_sessionInfoString, "---\n...\n");
 
+		m_isPacked = compress;
+		memset(&m_packHeader, 0, sizeof(m_packHeader));
+		m_packHeader.magic = IRSDK_PACK_MAGIC;
+		m_packHeader.version = IRSDK_PACK_VERSION;
+		m_packHeader.blockRecords = blockRecords > 0 ? blockRecords : IRSDK_PACK_BLOCK_RECORDS;
+		m_packBlocks.clear();
+		m_packRowCount = 0;
+
 		return true;
 	}
 
@@ -547,11 +832,38 @@ void irsdkDiskWriter::closeFile()
 {
 	if(m_ibtFile)
 	{
+		if(m_isPacked && m_isHeaderFinalized)
+		{
+			// the last, short, block and the table of them all
+			writePackBlock();
+
+			m_packHeader.numBlocks = (int)m_packBlocks.size();
+			m_packHeader.numRecords = m_diskSubHeader.sessionRecordCount;
+			m_packHeader.blockTableOffset = irsdkFileTell(m_ibtFile);
+			fwrite(m_packBlocks.data(), sizeof(irsdkPackBlock), m_packBlocks.size(), m_ibtFile);
+
+			irsdkFileSeek(m_ibtFile, 0);
+			fwrite(&m_packHeader, 1, sizeof(m_packHeader), m_ibtFile);
+		}
+
 		fseek(m_ibtFile, m_diskSubHeaderOffset, SEEK_SET);
 		fwrite(&m_diskSubHeader, 1, sizeof(m_diskSubHeader), m_ibtFile);
 		fclose(m_ibtFile);
 	}
 	m_ibtFile = NULL;
+	m_packRows.clear();
+	m_packBlocks.clear();
+}
+
+void irsdkDiskWriter::setSessionStr(const char *str)
+{
+	assert(!m_isHeaderFinalized);
+
+	if(str && !m_isHeaderFinalized)
+	{
+		strncpy(m_sessionInfoString, str, MAX_SESSIONSTR_LEN - 1);
+		m_sessionInfoString[MAX_SESSIONSTR_LEN - 1] = '\0';
+	}
 }
 
 int getSizeOfVarType(const irsdk_VarType type)
@@ -618,6 +930,10 @@ void irsdkDiskWriter::finalizeHeader()
 	{
 		int offset = 0;
 
+		// compressed files start with the pack header, patched on close
+		if(m_isPacked)
+			offset += sizeof(m_packHeader);
+
 		// main header
 		m_header.ver = 1;
 		m_header.status = irsdk_stConnected;
@@ -644,6 +960,12 @@ void irsdkDiskWriter::finalizeHeader()
 		m_header.varBuf[0].bufOffset = offset;
 		m_header.varBuf[0].tickCount = 0;
 
+		if(m_isPacked)
+		{
+			fwrite(&m_packHeader, 1, sizeof(m_packHeader), m_ibtFile);
+			m_packRows.resize((size_t)m_packHeader.blockRecords * m_header.bufLen);
+			m_packRowCount = 0;
+		}
 		fwrite(&m_header, 1, sizeof(m_header), m_ibtFile);
 		fwrite(&m_diskSubHeader, 1, sizeof(m_diskSubHeader), m_ibtFile);
 		fwrite(&m_varHeaders, 1, m_header.numVars * sizeof(irsdk_varHeader), m_ibtFile);
@@ -664,7 +986,14 @@ void irsdkDiskWriter::writeLine()
 
 	if(m_ibtFile && m_isHeaderFinalized)
 	{
-		fwrite(m_varBuf, 1, m_header.bufLen, m_ibtFile);
+		if(m_isPacked)
+		{
+			memcpy(&m_packRows[(size_t)m_packRowCount * m_header.bufLen], m_varBuf, m_header.bufLen);
+			if(++m_packRowCount == m_packHeader.blockRecords)
+				writePackBlock();
+		}
+		else
+			fwrite(m_varBuf, 1, m_header.bufLen, m_ibtFile);
 		m_diskSubHeader.sessionRecordCount++;
 
 		// zero out data so we are ready for the next line
@@ -672,6 +1001,28 @@ void irsdkDiskWriter::writeLine()
 	}
 }
 
+// compress the buffered lines and write them out as one block
+void irsdkDiskWriter::writePackBlock()
+{
+	if(m_packRowCount == 0)
+		return;
+
+	m_packOut.clear();
+	irsdk_packBlock(m_varHeaders, m_header.numVars, m_header.bufLen, m_packRows.data(), m_packRowCount, m_packOut);
+
+	irsdkPackBlock block;
+	block.offset = irsdkFileTell(m_ibtFile);
+	block.size = (int)m_packOut.size();
+	block.numRecords = m_packRowCount;
+	m_packBlocks.push_back(block);
+
+	irsdkPackBlockHeader bh = { block.size, block.numRecords };
+	fwrite(&bh, 1, sizeof(bh), m_ibtFile);
+	fwrite(m_packOut.data(), 1, m_packOut.size(), m_ibtFile);
+
+	m_packRowCount = 0;
+}
+
 // return how many variables this .ibt file has in the header
 int irsdkDiskWriter::getNumVars()
 {
@@ -28,6 +28,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef IRSDKDISKCLIENT_H
 #define IRSDKDISKCLIENT_H
 
+#include <vector>
+
+#include "irsdk_filemap.h"
+#include "irsdk_pack.h"
+#include "irsdk_varindex.h"
+#include "yaml_parser.h"
+
 // A C++ wrapper around the irsdk calls that takes care of reading a .ibt file
 
 //****FixMe, rename to irsdkDiskReader
@@ -39,19 +46,53 @@ public:
 	irsdkDiskClient(const char *path);
 	~irsdkDiskClient() { closeFile(); }
 
-	bool isFileOpen() { return m_ibtFile != NULL; }
-	bool openFile(const char *path);
+	bool isFileOpen() const { return m_ibtFile != NULL || m_map.isOpen(); }
+	// the file is mapped unless useMapping is off or mapping it fails,
+	// then lines are read through a FILE* into a buffer of our own.
+	// Compressed files are always mapped.
+	bool openFile(const char *path, bool useMapping = true);
 	void closeFile();
+	bool isMapped() const { return m_map.isOpen(); }
+	// size of the file as mapped, 0 if it isn't
+	size_t getMappedSize() const { return m_map.getSize(); }
+	// written with irsdkDiskWriter::openFile(path, true), lines are decoded a block at a time
+	bool isPacked() const { return m_isPacked; }
+	int getPackBlockRecords() const { return m_isPacked ? m_packHeader.blockRecords : 0; }
 
 	// read next line out of file
 	bool getNextData();
 	bool skipData(int skipAmt);
+	// make line recordIdx the current one, getNextData() carries on after it
+	bool readData(int recordIdx);
+	// back to the first line
+	bool rewind();
 	int getDataCount() { return m_diskSubHeader.sessionRecordCount; }
+	// lines actually in the file, which the sub header miscounts if the sim didn't close it
+	int getRecordCount() const { return m_numRecords; }
+
+	// Line recordIdx in the mapping, NULL if out of range or the file isn't mapped
+	// or is compressed. Stays valid until the file is closed.
+	const char *record(int recordIdx) const;
+
+	// Line recordIdx of a compressed file, decoded into buf along with the rest
+	// of its block unless bufBlock says that block is in there already. NULL if
+	// out of range or the block is corrupt. Safe to call from any thread, each
+	// with a buf of its own.
+	const char *unpackRecord(int recordIdx, std::vector<char> &buf, int &bufBlock) const;
+
+	// how the lines are about to be read, the file starts out as sequential
+	void setAccessHint(irsdkFileMap::Access access) { m_map.advise(access); }
+
+	// raw access, to republish the file as live data
+	const irsdk_header *getHeader() { return isFileOpen() ? &m_header : NULL; }
+	const irsdk_diskSubHeader *getDiskSubHeader() { return isFileOpen() ? &m_diskSubHeader : NULL; }
+	const irsdk_varHeader *getVarHeaders() { return m_varHeaders; }
+	const char *getData() { return m_data; }
 
 	// return how many variables this .ibt file has in the header
 	int getNumVars();
 
-	int getVarIdx(const char *name);
+	int getVarIdx(const char *name) const;
 
 	// get info on the var
 	const char* getVarName(int idx);
@@ -68,33 +109,99 @@ public:
 
 	// idx is the variables index, entry is the array offset, or 0 if not an array element
 	// will convert data to requested type
-	bool getVarBool(int idx, int entry = 0);
+	bool getVarBool(int idx, int entry = 0) { return readVarBool(m_data, idx, entry); }
 	bool getVarBool(const char *name, int entry = 0) { return getVarBool(getVarIdx(name), entry); }
 
-	int getVarInt(int idx, int entry = 0);
+	int getVarInt(int idx, int entry = 0) { return readVarInt(m_data, idx, entry); }
 	int getVarInt(const char *name, int entry = 0) { return getVarInt(getVarIdx(name), entry); }
 	
-	float getVarFloat(int idx, int entry = 0);
+	float getVarFloat(int idx, int entry = 0) { return readVarFloat(m_data, idx, entry); }
 	float getVarFloat(const char *name, int entry = 0) { return getVarFloat(getVarIdx(name), entry); }
 
-	double getVarDouble(int idx, int entry = 0);
+	double getVarDouble(int idx, int entry = 0) { return readVarDouble(m_data, idx, entry); }
 	double getVarDouble(const char *name, int entry = 0) { return getVarDouble(getVarIdx(name), entry); }
 
 	// 1 success, 0 failure, -n minimum buffer size
+	// each path is only parsed for once per file, repeats are a hash lookup
 	int getSessionStrVal(const char *path, char *val, int valLen);
 	// get the whole string
 	const char *getSessionStr() { return m_sessionInfoString; }
 
 protected:
+	friend class irsdkDiskCursor;
+
+	bool openMapping();
+	bool openPackBlocks();
+
+	// typed access to a variable in the line at data
+	bool readVarBool(const char *data, int idx, int entry) const;
+	int readVarInt(const char *data, int idx, int entry) const;
+	float readVarFloat(const char *data, int idx, int entry) const;
+	double readVarDouble(const char *data, int idx, int entry) const;
 
 	irsdk_header m_header;
 	irsdk_diskSubHeader m_diskSubHeader;
 
 	char *m_sessionInfoString;
+	irsdkYamlMemo m_sessionMemo;
 	irsdk_varHeader *m_varHeaders;
 	char *m_varBuf;
 
+	// current line, into the mapping or m_varBuf
+	const char *m_data;
+	int m_numRecords;
+	int m_nextRecord;
+
+	// name lookup table over m_varHeaders, built in openFile()
+	irsdkVarIndex m_varIndex;
+
 	FILE *m_ibtFile;
+	irsdkFileMap m_map;
+
+	// compressed files only
+	bool m_isPacked;
+	irsdkPackHeader m_packHeader;
+	std::vector<irsdkPackBlock> m_packBlocks;
+	std::vector<char> m_blockBuf;
+	int m_blockIdx;
+};
+
+// A read position of its own in a mapped file. Any number of them can walk
+// the same irsdkDiskClient independently, on any thread, as long as the
+// client outlives them and keeps the file open. Only works on mapped files.
+// On compressed ones each cursor decodes the blocks it visits into a buffer
+// of its own, so walking a block in order costs one decode.
+class irsdkDiskCursor
+{
+public:
+	// starts out before the first line, next() gets to it
+	irsdkDiskCursor(const irsdkDiskClient &ibt) : m_ibt(&ibt), m_recordIdx(-1), m_data(NULL), m_blockIdx(-1) { }
+
+	// false if recordIdx is out of range, the cursor stays where it was then
+	bool seek(int recordIdx);
+	bool next() { return seek(m_recordIdx + 1); }
+	bool prev() { return seek(m_recordIdx - 1); }
+
+	int getRecordIdx() const { return m_recordIdx; }
+	const char *getData() const { return m_data; }
+
+	bool getVarBool(int idx, int entry = 0) const { return m_ibt->readVarBool(m_data, idx, entry); }
+	int getVarInt(int idx, int entry = 0) const { return m_ibt->readVarInt(m_data, idx, entry); }
+	float getVarFloat(int idx, int entry = 0) const { return m_ibt->readVarFloat(m_data, idx, entry); }
+	double getVarDouble(int idx, int entry = 0) const { return m_ibt->readVarDouble(m_data, idx, entry); }
+
+protected:
+	const irsdkDiskClient *m_ibt;
+	int m_recordIdx;
+	const char *m_data;
+
+	// m_data points in here on compressed files
+	std::vector<char> m_block;
+	int m_blockIdx;
+
+private:
+	irsdkDiskCursor(const irsdkDiskCursor &);
+	irsdkDiskCursor &operator=(const irsdkDiskCursor &);
 };
 
 class irsdkDiskWriter
@@ -106,11 +213,14 @@ public:
 	~irsdkDiskWriter() { closeFile(); }
 
 	bool isFileOpen() { return m_ibtFile != NULL; }
-	bool openFile(const char *path);
+	// compress writes the lines in blocks of blockRecords, see irsdk_pack.h
+	bool openFile(const char *path, bool compress = false, int blockRecords = IRSDK_PACK_BLOCK_RECORDS);
 	void closeFile();
 
 	int addNewVariable(const char *name, const char *desc, const char *unit, const irsdk_VarType type, int count = 1);
 	bool isHeaderFinalized() { return m_isHeaderFinalized; }
+	// replaces the placeholder yaml, before finalizeHeader()
+	void setSessionStr(const char *str);
 	void finalizeHeader();
 
 	// write next line to file and clear buffers
@@ -166,7 +276,12 @@ public:
 	// get the whole string
 	//char* getSessionStr() { return m_sessionInfoString; }
 
+	// raw access to the line being built, laid out by getVarHeaders(), to copy lines from another file
+	const irsdk_varHeader *getVarHeaders() { return m_varHeaders; }
+	char *getLineBuf() { return m_varBuf; }
+
 protected:
+	void writePackBlock();
 
 	irsdk_header m_header;
 	irsdk_diskSubHeader m_diskSubHeader;
@@ -184,5 +299,13 @@ protected:
 	char m_varBuf[MAX_VAR_BUF_SIZE];
 
 	FILE *m_ibtFile;
+
+	// compressed files only, lines waiting for their block to fill
+	bool m_isPacked;
+	irsdkPackHeader m_packHeader;
+	std::vector<irsdkPackBlock> m_packBlocks;
+	std::vector<char> m_packRows;
+	int m_packRowCount;
+	std::vector<unsigned char> m_packOut;
 };
 #endif // IRSDKDISKCLIENT_H
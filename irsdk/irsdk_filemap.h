@@ -0,0 +1,84 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IRSDKFILEMAP_H
+#define IRSDKFILEMAP_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// 64 bit file offsets, long is 32 bits on Windows and endurance recordings go past 2GB
+bool irsdkFileSeek(FILE *file, long long ofs);
+long long irsdkFileTell(FILE *file);
+// leaves the file at its end, -1 if it can't be found
+long long irsdkFileSize(FILE *file);
+
+// A file written under "<path>.tmp" first and only moved over path once it
+// is complete, so a reader never sees half a file.
+FILE *irsdkCreateTemp(const char *path);
+// closes file, then moves it in place if ok or throws it away if not
+bool irsdkCommitTemp(FILE *file, const char *path, bool ok);
+
+// A whole file mapped read only, for irsdkDiskClient. The mapping stays put
+// until close(), so any number of readers can hold pointers into it and walk
+// it independently, from any thread.
+class irsdkFileMap
+{
+public:
+	enum Access
+	{
+		Access_Normal,
+		Access_Sequential,	// read ahead aggressively, drop pages behind us early
+		Access_Random,		// no read ahead, for seeking around
+	};
+
+	irsdkFileMap() : m_data(NULL), m_size(0), m_handle(NULL) { }
+	~irsdkFileMap() { close(); }
+
+	bool open(const char *path);
+	void close();
+
+	bool isOpen() const { return m_data != NULL; }
+	const char *getData() const { return m_data; }
+	size_t getSize() const { return m_size; }
+	// does [ofs, ofs+len) lie within the file
+	bool contains(long long ofs, long long len) const { return ofs >= 0 && len >= 0 && (unsigned long long)(ofs + len) <= m_size; }
+
+	// hint to the OS how the whole file is about to be read
+	void advise(Access access);
+	// hint that [ofs, ofs+len) is about to be read
+	void prefetch(size_t ofs, size_t len);
+
+protected:
+	const char *m_data;
+	size_t m_size;
+	void *m_handle; // platform file mapping object, if it needs one
+
+private:
+	irsdkFileMap(const irsdkFileMap&);
+	irsdkFileMap& operator=(const irsdkFileMap&);
+};
+
+#endif // IRSDKFILEMAP_H
@@ -0,0 +1,137 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef _WIN32
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include "irsdk_filemap.h"
+
+bool irsdkFileMap::open(const char *path)
+{
+	close();
+
+	const int fd = ::open(path, O_RDONLY);
+	if(fd < 0)
+		return false;
+
+	struct stat st;
+	if(fstat(fd, &st) == 0 && st.st_size > 0)
+	{
+		void *mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if(mem != MAP_FAILED)
+		{
+			m_data = (const char *)mem;
+			m_size = (size_t)st.st_size;
+		}
+	}
+	::close(fd); // the mapping keeps the file open
+
+	return m_data != NULL;
+}
+
+void irsdkFileMap::close()
+{
+	if(m_data)
+		munmap((void *)m_data, m_size);
+	m_data = NULL;
+	m_size = 0;
+}
+
+void irsdkFileMap::advise(Access access)
+{
+	if(!m_data)
+		return;
+
+	int advice = MADV_NORMAL;
+	if(access == Access_Sequential)
+		advice = MADV_SEQUENTIAL;
+	else if(access == Access_Random)
+		advice = MADV_RANDOM;
+
+	madvise((void *)m_data, m_size, advice);
+}
+
+void irsdkFileMap::prefetch(size_t ofs, size_t len)
+{
+	if(!m_data || ofs >= m_size)
+		return;
+
+	if(len > m_size - ofs)
+		len = m_size - ofs;
+
+	// madvise wants a page aligned start
+	const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	const size_t start = ofs & ~(page - 1);
+	madvise((void *)(m_data + start), len + (ofs - start), MADV_WILLNEED);
+}
+
+bool irsdkFileSeek(FILE *file, long long ofs)
+{
+	return fseeko(file, (off_t)ofs, SEEK_SET) == 0;
+}
+
+long long irsdkFileTell(FILE *file)
+{
+	return (long long)ftello(file);
+}
+
+long long irsdkFileSize(FILE *file)
+{
+	if(fseeko(file, 0, SEEK_END) != 0)
+		return -1;
+	return (long long)ftello(file);
+}
+
+static void tempPath(char *tmpPath, size_t size, const char *path)
+{
+	snprintf(tmpPath, size, "%s.tmp", path);
+}
+
+FILE *irsdkCreateTemp(const char *path)
+{
+	char tmpPath[1024];
+	tempPath(tmpPath, sizeof(tmpPath), path);
+	return fopen(tmpPath, "wb");
+}
+
+bool irsdkCommitTemp(FILE *file, const char *path, bool ok)
+{
+	char tmpPath[1024];
+	tempPath(tmpPath, sizeof(tmpPath), path);
+
+	// rename replaces path in one step, a reader has either the old file or the new one
+	ok = fclose(file) == 0 && ok;
+	ok = ok && rename(tmpPath, path) == 0;
+	if(!ok)
+		remove(tmpPath);
+	return ok;
+}
+
+#endif // _WIN32
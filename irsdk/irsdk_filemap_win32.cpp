@@ -0,0 +1,148 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <stdio.h>
+
+#include "irsdk_filemap.h"
+
+#pragma warning(disable:4996)
+
+bool irsdkFileMap::open(const char *path)
+{
+	close();
+
+	HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if(GetFileSizeEx(hFile, &size) && size.QuadPart > 0 && (unsigned long long)size.QuadPart <= (size_t)-1)
+	{
+		m_handle = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if(m_handle)
+		{
+			m_data = (const char *)MapViewOfFile(m_handle, FILE_MAP_READ, 0, 0, 0);
+			if(m_data)
+				m_size = (size_t)size.QuadPart;
+			else
+			{
+				CloseHandle(m_handle);
+				m_handle = NULL;
+			}
+		}
+	}
+	CloseHandle(hFile); // the mapping keeps the file open
+
+	return m_data != NULL;
+}
+
+void irsdkFileMap::close()
+{
+	if(m_data)
+		UnmapViewOfFile(m_data);
+	m_data = NULL;
+	m_size = 0;
+
+	if(m_handle)
+		CloseHandle(m_handle);
+	m_handle = NULL;
+}
+
+// There is no madvise for a view, the cache manager picks up sequential
+// access on its own. Only the explicit prefetch below does anything.
+void irsdkFileMap::advise(Access access)
+{
+}
+
+// PrefetchVirtualMemory is Windows 8 and up, look it up so older systems still load us
+typedef BOOL (WINAPI *PrefetchVirtualMemoryFn)(HANDLE, ULONG_PTR, PVOID, ULONG);
+struct irsdkMemoryRange
+{
+	PVOID VirtualAddress;
+	SIZE_T NumberOfBytes;
+};
+
+void irsdkFileMap::prefetch(size_t ofs, size_t len)
+{
+	if(!m_data || ofs >= m_size)
+		return;
+
+	if(len > m_size - ofs)
+		len = m_size - ofs;
+
+	static PrefetchVirtualMemoryFn prefetchFn = (PrefetchVirtualMemoryFn)GetProcAddress(GetModuleHandleA("kernel32.dll"), "PrefetchVirtualMemory");
+	if(prefetchFn)
+	{
+		irsdkMemoryRange range = { (PVOID)(m_data + ofs), len };
+		prefetchFn(GetCurrentProcess(), 1, &range, 0);
+	}
+}
+
+bool irsdkFileSeek(FILE *file, long long ofs)
+{
+	return _fseeki64(file, ofs, SEEK_SET) == 0;
+}
+
+long long irsdkFileTell(FILE *file)
+{
+	return _ftelli64(file);
+}
+
+long long irsdkFileSize(FILE *file)
+{
+	if(_fseeki64(file, 0, SEEK_END) != 0)
+		return -1;
+	return _ftelli64(file);
+}
+
+static void tempPath(char *tmpPath, size_t size, const char *path)
+{
+	snprintf(tmpPath, size, "%s.tmp", path);
+}
+
+FILE *irsdkCreateTemp(const char *path)
+{
+	char tmpPath[1024];
+	tempPath(tmpPath, sizeof(tmpPath), path);
+	return fopen(tmpPath, "wb");
+}
+
+bool irsdkCommitTemp(FILE *file, const char *path, bool ok)
+{
+	char tmpPath[1024];
+	tempPath(tmpPath, sizeof(tmpPath), path);
+
+	// rename won't replace an existing file here, MoveFileEx does it in one step
+	ok = fclose(file) == 0 && ok;
+	ok = ok && MoveFileExA(tmpPath, path, MOVEFILE_REPLACE_EXISTING) != 0;
+	if(!ok)
+		remove(tmpPath);
+	return ok;
+}
+
+#endif // _WIN32
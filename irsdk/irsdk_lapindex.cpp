@@ -0,0 +1,234 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <algorithm>
+
+#include "irsdk_defines.h"
+#include "irsdk_diskclient.h"
+#include "irsdk_filemap.h"
+#include "irsdk_lapindex.h"
+
+#pragma warning(disable:4996)
+
+static bool entryLess(const irsdkLapIndexEntry &a, const irsdkLapIndexEntry &b)
+{
+	if(a.sessionNum != b.sessionNum)
+		return a.sessionNum < b.sessionNum;
+	if(a.key != b.key)
+		return a.key < b.key;
+	return a.record < b.record;
+}
+
+// first entry at or after (sessionNum, key), NULL if there is none in that session
+static const irsdkLapIndexEntry *findEntry(const std::vector<irsdkLapIndexEntry> &entries, int sessionNum, int key)
+{
+	const irsdkLapIndexEntry probe = { sessionNum, key, INT_MIN };
+	std::vector<irsdkLapIndexEntry>::const_iterator it = std::lower_bound(entries.begin(), entries.end(), probe, entryLess);
+	if(it == entries.end() || it->sessionNum != sessionNum)
+		return NULL;
+
+	return &*it;
+}
+
+bool irsdkLapIndex::build(irsdkDiskClient &ibt, float bucketSeconds)
+{
+	m_laps.clear();
+	m_buckets.clear();
+	m_numRecords = 0;
+
+	const int timeIdx = ibt.getVarIdx("SessionTime");
+	if(!ibt.isFileOpen() || timeIdx < 0 || bucketSeconds <= 0)
+		return false;
+
+	const int lapIdx = ibt.getVarIdx("Lap");
+	const int sessionIdx = ibt.getVarIdx("SessionNum");
+
+	m_source = *ibt.getDiskSubHeader();
+	m_bucketSeconds = bucketSeconds;
+
+	int lastSession = INT_MIN;
+	int lastLap = INT_MIN;
+	int lastBucket = INT_MIN;
+
+	ibt.rewind();
+	int record = 0;
+	for(; ibt.getNextData(); record++)
+	{
+		const int sessionNum = sessionIdx >= 0 ? ibt.getVarInt(sessionIdx) : 0;
+		const int lap = lapIdx >= 0 ? ibt.getVarInt(lapIdx) : 0;
+		const int bucket = (int)floor(ibt.getVarDouble(timeIdx) / bucketSeconds);
+
+		if(lapIdx >= 0 && (sessionNum != lastSession || lap != lastLap))
+		{
+			const irsdkLapIndexEntry e = { sessionNum, lap, record };
+			m_laps.push_back(e);
+		}
+		if(sessionNum != lastSession || bucket != lastBucket)
+		{
+			const irsdkLapIndexEntry e = { sessionNum, bucket, record };
+			m_buckets.push_back(e);
+		}
+
+		lastSession = sessionNum;
+		lastLap = lap;
+		lastBucket = bucket;
+	}
+	ibt.rewind();
+
+	m_numRecords = record;
+	std::sort(m_laps.begin(), m_laps.end(), entryLess);
+	std::sort(m_buckets.begin(), m_buckets.end(), entryLess);
+	return true;
+}
+
+bool irsdkLapIndex::openFor(irsdkDiskClient &ibt, const char *path, float bucketSeconds)
+{
+	if(load(path) && m_bucketSeconds == bucketSeconds && isCurrent(ibt))
+		return true;
+
+	if(!build(ibt, bucketSeconds))
+		return false;
+
+	// still usable if it can't be kept, it just gets built again next time
+	save(path);
+	return true;
+}
+
+bool irsdkLapIndex::load(const char *path)
+{
+	m_laps.clear();
+	m_buckets.clear();
+	m_numRecords = 0;
+
+	FILE *file = fopen(path, "rb");
+	if(!file)
+		return false;
+
+	// the counts in a corrupt header can be anything, they have to fit in the file
+	const long long fileLen = irsdkFileSize(file);
+	irsdkFileSeek(file, 0);
+
+	irsdkLapIndexHeader h;
+	bool ok = fread(&h, 1, sizeof(h), file) == sizeof(h)
+		&& h.magic == IRSDK_LAPINDEX_MAGIC && h.version == IRSDK_LAPINDEX_VERSION
+		&& h.numLaps >= 0 && h.numBuckets >= 0 && h.bucketSeconds > 0
+		&& (long long)h.numLaps + h.numBuckets <= (fileLen - (long long)sizeof(h)) / (long long)sizeof(irsdkLapIndexEntry);
+	if(ok)
+	{
+		m_laps.resize(h.numLaps);
+		m_buckets.resize(h.numBuckets);
+		ok = fread(m_laps.data(), sizeof(irsdkLapIndexEntry), h.numLaps, file) == (size_t)h.numLaps
+			&& fread(m_buckets.data(), sizeof(irsdkLapIndexEntry), h.numBuckets, file) == (size_t)h.numBuckets;
+	}
+	fclose(file);
+
+	if(!ok)
+	{
+		m_laps.clear();
+		m_buckets.clear();
+		return false;
+	}
+
+	m_source = h.source;
+	m_numRecords = h.numRecords;
+	m_bucketSeconds = h.bucketSeconds;
+	return true;
+}
+
+bool irsdkLapIndex::save(const char *path) const
+{
+	irsdkLapIndexHeader h;
+	memset(&h, 0, sizeof(h));
+	h.magic = IRSDK_LAPINDEX_MAGIC;
+	h.version = IRSDK_LAPINDEX_VERSION;
+	h.source = m_source;
+	h.numRecords = m_numRecords;
+	h.bucketSeconds = m_bucketSeconds;
+	h.numLaps = (int)m_laps.size();
+	h.numBuckets = (int)m_buckets.size();
+
+	FILE *file = irsdkCreateTemp(path);
+	if(!file)
+		return false;
+
+	bool ok = fwrite(&h, 1, sizeof(h), file) == sizeof(h)
+		&& fwrite(m_laps.data(), sizeof(irsdkLapIndexEntry), m_laps.size(), file) == m_laps.size()
+		&& fwrite(m_buckets.data(), sizeof(irsdkLapIndexEntry), m_buckets.size(), file) == m_buckets.size();
+
+	return irsdkCommitTemp(file, path, ok);
+}
+
+bool irsdkLapIndex::isCurrent(irsdkDiskClient &ibt) const
+{
+	const irsdk_diskSubHeader *source = ibt.getDiskSubHeader();
+
+	return source && m_numRecords == ibt.getRecordCount()
+		&& 0 == memcmp(&m_source, source, sizeof(*source));
+}
+
+int irsdkLapIndex::findLap(int sessionNum, int lap) const
+{
+	const irsdkLapIndexEntry *e = findEntry(m_laps, sessionNum, lap);
+	return e && e->key == lap ? e->record : -1;
+}
+
+int irsdkLapIndex::findTime(irsdkDiskClient &ibt, int sessionNum, double sessionTime) const
+{
+	const int bucket = (int)floor(sessionTime / m_bucketSeconds);
+	const irsdkLapIndexEntry *e = findEntry(m_buckets, sessionNum, bucket);
+	if(!e)
+		return -1;
+
+	// a bucket past the one asked for starts after sessionTime already
+	const int timeIdx = ibt.getVarIdx("SessionTime");
+	if(e->key != bucket || timeIdx < 0 || !ibt.isMapped())
+		return e->record;
+
+	// where the bucket ends, the next one may belong to the next session
+	const irsdkLapIndexEntry *next = e + 1 < m_buckets.data() + m_buckets.size() ? e + 1 : NULL;
+	const bool nextInSession = next && next->sessionNum == sessionNum;
+	const int end = next ? next->record : m_numRecords;
+
+	// time only goes forward within a bucket, binary search it
+	irsdkDiskCursor c(ibt);
+	int lo = e->record;
+	int hi = end;
+	while(lo < hi)
+	{
+		const int mid = lo + (hi - lo) / 2;
+		if(c.seek(mid) && c.getVarDouble(timeIdx) < sessionTime)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if(lo < end)
+		return lo;
+	return nextInSession ? end : -1;
+}
@@ -0,0 +1,102 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IRSDKLAPINDEX_H
+#define IRSDKLAPINDEX_H
+
+#include <vector>
+
+class irsdkDiskClient;
+
+// Where every lap and every bucketSeconds of session time starts in a .ibt,
+// so "lap 37" or "5400s into the race" is a binary search instead of reading
+// the file from the top. Built in one pass over the file and kept next to
+// it, see openFor().
+//
+// Requires irsdk_defines.h to be included first.
+
+static const int IRSDK_LAPINDEX_MAGIC = 0x4C544249; // "IBTL"
+static const int IRSDK_LAPINDEX_VERSION = 1;
+
+struct irsdkLapIndexEntry
+{
+	int sessionNum;
+	int key;		// lap number, or the session time bucket
+	int record;		// first line with it
+};
+
+struct irsdkLapIndexHeader
+{
+	int magic;
+	int version;
+	irsdk_diskSubHeader source;	// of the .ibt, to tell whether this still belongs to it
+	int numRecords;
+	float bucketSeconds;
+	int numLaps;
+	int numBuckets;
+	// then irsdkLapIndexEntry laps[numLaps], buckets[numBuckets]
+};
+
+class irsdkLapIndex
+{
+public:
+	irsdkLapIndex() : m_bucketSeconds(1.0f), m_numRecords(0) { memset(&m_source, 0, sizeof(m_source)); }
+
+	// one pass over ibt, which is left rewound. Needs SessionTime,
+	// Lap and SessionNum are used if the file has them.
+	bool build(irsdkDiskClient &ibt, float bucketSeconds = 1.0f);
+
+	// the index in path if it was built from ibt as it is now, otherwise
+	// build it and write it there
+	bool openFor(irsdkDiskClient &ibt, const char *path, float bucketSeconds = 1.0f);
+
+	bool load(const char *path);
+	bool save(const char *path) const;
+
+	// false if ibt has changed since this was built from it
+	bool isCurrent(irsdkDiskClient &ibt) const;
+
+	// First line of lap in session sessionNum, -1 if it isn't in the file.
+	// A lap that shows up more than once (a reset, a tow) is found at its first.
+	int findLap(int sessionNum, int lap) const;
+
+	// First line at or after sessionTime in session sessionNum, -1 if the
+	// session ends before it. Exact to the line if ibt is mapped, to the
+	// bucket otherwise.
+	int findTime(irsdkDiskClient &ibt, int sessionNum, double sessionTime) const;
+
+	// by session, then lap
+	int getNumLaps() const { return (int)m_laps.size(); }
+	const irsdkLapIndexEntry &getLap(int i) const { return m_laps[i]; }
+
+protected:
+	irsdk_diskSubHeader m_source;
+	float m_bucketSeconds;
+	int m_numRecords;
+	std::vector<irsdkLapIndexEntry> m_laps;
+	std::vector<irsdkLapIndexEntry> m_buckets;
+};
+
+#endif // IRSDKLAPINDEX_H
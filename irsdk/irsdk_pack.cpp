@@ -0,0 +1,461 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <string.h>
+#include <bit>
+
+#include "irsdk_defines.h"
+#include "irsdk_pack.h"
+
+typedef unsigned long long u64;
+
+// least significant bit first
+class irsdkBitWriter
+{
+public:
+	irsdkBitWriter(std::vector<unsigned char> &out) : m_out(out), m_acc(0), m_bits(0) { }
+
+	void put(u64 v, int bits)
+	{
+		if(bits > 32)
+		{
+			put(v & 0xFFFFFFFF, 32);
+			put(v >> 32, bits - 32);
+			return;
+		}
+		if(bits == 0)
+			return;
+
+		m_acc |= (v & ((1ULL << bits) - 1)) << m_bits;
+		m_bits += bits;
+		while(m_bits >= 8)
+		{
+			m_out.push_back((unsigned char)m_acc);
+			m_acc >>= 8;
+			m_bits -= 8;
+		}
+	}
+
+	void flush()
+	{
+		if(m_bits)
+			m_out.push_back((unsigned char)m_acc);
+		m_acc = 0;
+		m_bits = 0;
+	}
+
+protected:
+	std::vector<unsigned char> &m_out;
+	u64 m_acc;
+	int m_bits;
+};
+
+// reads zeros past the end, see overrun()
+class irsdkBitReader
+{
+public:
+	irsdkBitReader(const unsigned char *p, const unsigned char *end) : m_p(p), m_end(end), m_acc(0), m_bits(0), m_overrun(false) { }
+
+	u64 get(int bits)
+	{
+		if(bits > 32)
+		{
+			const u64 lo = get(32);
+			return lo | (get(bits - 32) << 32);
+		}
+		if(bits == 0)
+			return 0;
+
+		while(m_bits < bits)
+		{
+			if(m_p < m_end)
+				m_acc |= (u64)*m_p++ << m_bits;
+			else
+				m_overrun = true;
+			m_bits += 8;
+		}
+
+		const u64 v = m_acc & ((1ULL << bits) - 1);
+		m_acc >>= bits;
+		m_bits -= bits;
+		return v;
+	}
+
+	bool overrun() const { return m_overrun; }
+
+protected:
+	const unsigned char *m_p;
+	const unsigned char *m_end;
+	u64 m_acc;
+	int m_bits;
+	bool m_overrun;
+};
+
+static void putVarint(std::vector<unsigned char> &out, u64 v)
+{
+	while(v >= 0x80)
+	{
+		out.push_back((unsigned char)(v | 0x80));
+		v >>= 7;
+	}
+	out.push_back((unsigned char)v);
+}
+
+static bool getVarint(const unsigned char *&p, const unsigned char *end, u64 &v)
+{
+	v = 0;
+	for(int shift=0; p<end && shift<64; shift+=7)
+	{
+		const unsigned char b = *p++;
+		v |= (u64)(b & 0x7F) << shift;
+		if(!(b & 0x80))
+			return true;
+	}
+	return false;
+}
+
+static u64 zigzag(long long v) { return ((u64)v << 1) ^ (u64)(v >> 63); }
+static long long unzigzag(u64 v) { return (long long)(v >> 1) ^ -(long long)(v & 1); }
+
+//----
+// run length, for char, bool and bitField
+
+template<class T>
+static void packRuns(const char *src, int stride, int n, std::vector<unsigned char> &out)
+{
+	for(int i=0; i<n; )
+	{
+		T v;
+		memcpy(&v, src + (size_t)i * stride, sizeof(T));
+
+		int run = 1;
+		for(T w; i + run < n; run++)
+		{
+			memcpy(&w, src + (size_t)(i + run) * stride, sizeof(T));
+			if(w != v)
+				break;
+		}
+
+		putVarint(out, run);
+		const size_t at = out.size();
+		out.resize(at + sizeof(T));
+		memcpy(&out[at], &v, sizeof(T));
+		i += run;
+	}
+}
+
+template<class T>
+static bool unpackRuns(const unsigned char *p, const unsigned char *end, char *dst, int stride, int n)
+{
+	for(int i=0; i<n; )
+	{
+		u64 run;
+		if(!getVarint(p, end, run) || run == 0 || run > (u64)(n - i) || end - p < (ptrdiff_t)sizeof(T))
+			return false;
+
+		for(int k=0; k<(int)run; k++)
+			memcpy(dst + (size_t)(i + k) * stride, p, sizeof(T));
+		p += sizeof(T);
+		i += (int)run;
+	}
+	return p == end;
+}
+
+//----
+// delta of delta, for int. Most channels count up by a steady amount or
+// not at all, so the second difference is mostly 0 and packs to a few bits.
+
+static void packInts(const char *src, int stride, int n, std::vector<unsigned char> &out)
+{
+	if(n == 0)
+		return;
+
+	int v;
+	memcpy(&v, src, sizeof(v));
+	putVarint(out, zigzag(v));
+	if(n == 1)
+		return;
+
+	long long prev = v;
+	memcpy(&v, src + stride, sizeof(v));
+	long long delta = v - prev;
+	putVarint(out, zigzag(delta));
+	prev = v;
+
+	// widest second difference in the block decides the width for all of them
+	static thread_local std::vector<u64> dods;
+	dods.clear();
+	u64 all = 0;
+	for(int i=2; i<n; i++)
+	{
+		memcpy(&v, src + (size_t)i * stride, sizeof(v));
+		const long long d = v - prev;
+		const u64 z = zigzag(d - delta);
+		dods.push_back(z);
+		all |= z;
+		delta = d;
+		prev = v;
+	}
+
+	const int width = 64 - std::countl_zero(all);
+	out.push_back((unsigned char)width);
+
+	irsdkBitWriter bw(out);
+	for(u64 z : dods)
+		bw.put(z, width);
+	bw.flush();
+}
+
+static bool unpackInts(const unsigned char *p, const unsigned char *end, char *dst, int stride, int n)
+{
+	if(n == 0)
+		return p == end;
+
+	u64 z;
+	if(!getVarint(p, end, z))
+		return false;
+	long long v = unzigzag(z);
+	int iv = (int)v;
+	memcpy(dst, &iv, sizeof(iv));
+	if(n == 1)
+		return p == end;
+
+	if(!getVarint(p, end, z))
+		return false;
+	long long delta = unzigzag(z);
+	v += delta;
+	iv = (int)v;
+	memcpy(dst + stride, &iv, sizeof(iv));
+
+	if(p >= end || *p > 64)
+		return false;
+	const int width = *p++;
+
+	irsdkBitReader br(p, end);
+	for(int i=2; i<n; i++)
+	{
+		delta += unzigzag(br.get(width));
+		v += delta;
+		iv = (int)v;
+		memcpy(dst + (size_t)i * stride, &iv, sizeof(iv));
+	}
+	return !br.overrun();
+}
+
+//----
+// XOR with the previous value, for float and double. Values that change
+// slowly share sign, exponent and the top of the mantissa, so only a short
+// run of bits in the middle differs. Per value:
+//   0                      same as the previous
+//   10 bits                differing bits fit in the previous window
+//   11 lead len-1 bits     new window
+
+template<class U, int LEAD_BITS, int LEN_BITS>
+static void packXor(const char *src, int stride, int n, std::vector<unsigned char> &out)
+{
+	const int W = sizeof(U) * 8;
+	if(n == 0)
+		return;
+
+	irsdkBitWriter bw(out);
+	U prev;
+	memcpy(&prev, src, sizeof(U));
+	bw.put(prev, W);
+
+	int prevLead = -1;
+	int prevTrail = 0;
+	for(int i=1; i<n; i++)
+	{
+		U v;
+		memcpy(&v, src + (size_t)i * stride, sizeof(U));
+		const U x = v ^ prev;
+		prev = v;
+
+		if(!x)
+		{
+			bw.put(0, 1);
+			continue;
+		}
+
+		const int lead = std::countl_zero(x);
+		const int trail = std::countr_zero(x);
+		if(prevLead >= 0 && lead >= prevLead && trail >= prevTrail)
+		{
+			bw.put(1, 1);
+			bw.put(0, 1);
+			bw.put(x >> prevTrail, W - prevLead - prevTrail);
+		}
+		else
+		{
+			const int len = W - lead - trail;
+			bw.put(1, 1);
+			bw.put(1, 1);
+			bw.put(lead, LEAD_BITS);
+			bw.put(len - 1, LEN_BITS);
+			bw.put(x >> trail, len);
+			prevLead = lead;
+			prevTrail = trail;
+		}
+	}
+	bw.flush();
+}
+
+template<class U, int LEAD_BITS, int LEN_BITS>
+static bool unpackXor(const unsigned char *p, const unsigned char *end, char *dst, int stride, int n)
+{
+	const int W = sizeof(U) * 8;
+	if(n == 0)
+		return p == end;
+
+	irsdkBitReader br(p, end);
+	U v = (U)br.get(W);
+	memcpy(dst, &v, sizeof(U));
+
+	int lead = -1;
+	int trail = 0;
+	for(int i=1; i<n; i++)
+	{
+		if(br.get(1))
+		{
+			if(br.get(1))
+			{
+				lead = (int)br.get(LEAD_BITS);
+				trail = W - lead - ((int)br.get(LEN_BITS) + 1);
+				if(trail < 0)
+					return false;
+			}
+			else if(lead < 0)
+				return false;
+
+			v ^= (U)(br.get(W - lead - trail) << trail);
+		}
+		memcpy(dst + (size_t)i * stride, &v, sizeof(U));
+	}
+	return !br.overrun();
+}
+
+//----
+
+void irsdk_packBlock(const irsdk_varHeader *varHeaders, int numVars, int bufLen, const char *rows, int numRecords, std::vector<unsigned char> &out)
+{
+	for(int i=0; i<numVars; i++)
+	{
+		const irsdk_varHeader &vh = varHeaders[i];
+		const int size = irsdk_VarTypeBytes[vh.type];
+
+		for(int e=0; e<vh.count; e++)
+		{
+			const char *src = rows + vh.offset + e * size;
+
+			// every stream is prefixed with its length, filled in once it is written
+			const size_t lenAt = out.size();
+			out.resize(lenAt + 4);
+
+			switch(vh.type)
+			{
+			case irsdk_char:
+			case irsdk_bool:
+				packRuns<unsigned char>(src, bufLen, numRecords, out);
+				break;
+			case irsdk_bitField:
+				packRuns<unsigned int>(src, bufLen, numRecords, out);
+				break;
+			case irsdk_int:
+				packInts(src, bufLen, numRecords, out);
+				break;
+			case irsdk_float:
+				packXor<unsigned int, 5, 5>(src, bufLen, numRecords, out);
+				break;
+			case irsdk_double:
+				packXor<u64, 6, 6>(src, bufLen, numRecords, out);
+				break;
+			}
+
+			const unsigned int len = (unsigned int)(out.size() - lenAt - 4);
+			memcpy(&out[lenAt], &len, 4);
+		}
+	}
+}
+
+bool irsdk_unpackBlock(const irsdk_varHeader *varHeaders, int numVars, int bufLen, const unsigned char *src, size_t len, int numRecords, char *rows)
+{
+	const unsigned char *p = src;
+	const unsigned char *end = src + len;
+
+	// padding between variables isn't stored
+	memset(rows, 0, (size_t)numRecords * bufLen);
+
+	for(int i=0; i<numVars; i++)
+	{
+		const irsdk_varHeader &vh = varHeaders[i];
+		if(vh.type < 0 || vh.type >= irsdk_ETCount)
+			return false;
+
+		const int size = irsdk_VarTypeBytes[vh.type];
+		if(vh.offset < 0 || vh.count < 1 || vh.offset + vh.count * size > bufLen)
+			return false;
+
+		for(int e=0; e<vh.count; e++)
+		{
+			unsigned int streamLen;
+			if(end - p < 4)
+				return false;
+			memcpy(&streamLen, p, 4);
+			p += 4;
+			if((size_t)(end - p) < streamLen)
+				return false;
+
+			const unsigned char *streamEnd = p + streamLen;
+			char *dst = rows + vh.offset + e * size;
+
+			bool ok = false;
+			switch(vh.type)
+			{
+			case irsdk_char:
+			case irsdk_bool:
+				ok = unpackRuns<unsigned char>(p, streamEnd, dst, bufLen, numRecords);
+				break;
+			case irsdk_bitField:
+				ok = unpackRuns<unsigned int>(p, streamEnd, dst, bufLen, numRecords);
+				break;
+			case irsdk_int:
+				ok = unpackInts(p, streamEnd, dst, bufLen, numRecords);
+				break;
+			case irsdk_float:
+				ok = unpackXor<unsigned int, 5, 5>(p, streamEnd, dst, bufLen, numRecords);
+				break;
+			case irsdk_double:
+				ok = unpackXor<u64, 6, 6>(p, streamEnd, dst, bufLen, numRecords);
+				break;
+			}
+			if(!ok)
+				return false;
+
+			p = streamEnd;
+		}
+	}
+
+	return p == end;
+}
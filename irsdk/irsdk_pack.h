@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IRSDKPACK_H
+#define IRSDKPACK_H
+
+#include <stddef.h>
+#include <vector>
+
+// Compressed .ibt, written by irsdkDiskWriter::openFile(path, true) and
+// read by irsdkDiskClient like any other. Laid out like a .ibt behind an
+// irsdkPackHeader, except that the lines come in blocks of blockRecords,
+// each compressed on its own so blocks can be decoded in any order and on
+// any thread. Within a block every entry of every variable is one stream,
+// with a codec that suits its type:
+//   int                  delta of delta, zigzag, bit packed to the block's widest value
+//   float, double        XOR with the previous value, leading/trailing zeros trimmed
+//   char, bool, bitField run length
+//
+// Requires irsdk_defines.h to be included first.
+
+static const int IRSDK_PACK_MAGIC = 0x5A544249; // "IBTZ"
+static const int IRSDK_PACK_VERSION = 1;
+static const int IRSDK_PACK_BLOCK_RECORDS = 1024; // about 17s at 60Hz
+
+struct irsdkPackHeader
+{
+	int magic;
+	int version;
+	int blockRecords;			// lines per block, the last one may be short
+	int numBlocks;				// these three are filled in on close
+	int numRecords;
+	int reserved;
+	long long blockTableOffset;	// irsdkPackBlock[numBlocks], 0 if the file wasn't closed
+};
+
+// in front of every block, so the blocks can be walked without the table
+struct irsdkPackBlockHeader
+{
+	int size;		// of what follows
+	int numRecords;
+};
+
+struct irsdkPackBlock
+{
+	long long offset;	// of its irsdkPackBlockHeader
+	int size;
+	int numRecords;
+};
+
+// compress numRecords lines starting at rows, appended to out
+void irsdk_packBlock(const irsdk_varHeader *varHeaders, int numVars, int bufLen, const char *rows, int numRecords, std::vector<unsigned char> &out);
+
+// and back into numRecords lines at rows, false if src is corrupt
+bool irsdk_unpackBlock(const irsdk_varHeader *varHeaders, int numVars, int bufLen, const unsigned char *src, size_t len, int numRecords, char *rows);
+
+#endif // IRSDKPACK_H
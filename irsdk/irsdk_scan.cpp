@@ -0,0 +1,262 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+
+#include "irsdk_defines.h"
+#include "irsdk_diskclient.h"
+#include "irsdk_workpool.h"
+#include "irsdk_scan.h"
+
+// what the chunks of one file share, the last one to finish wraps the file up
+struct irsdkScanJob
+{
+	irsdkDiskClient ibt;
+	irsdkFileSummary *result;
+
+	int lapIdx;
+	int timeIdx;
+	int fuelIdx;	// -1 if not logged
+	int pitIdx;		// likewise
+
+	std::vector<std::vector<irsdkLapSummary>> chunks;
+	std::atomic<int> chunksLeft;
+};
+
+template<class Reader>
+static void addLine(const irsdkScanJob &job, Reader &r, int recordIdx, std::vector<irsdkLapSummary> &laps)
+{
+	const int lap = r.getVarInt(job.lapIdx);
+	if(laps.empty() || laps.back().lap != lap)
+	{
+		irsdkLapSummary s;
+		memset(&s, 0, sizeof(s));
+		s.lap = lap;
+		s.firstRecord = recordIdx;
+		s.startTime = r.getVarDouble(job.timeIdx);
+		s.startFuel = job.fuelIdx >= 0 ? r.getVarFloat(job.fuelIdx) : 0.0f;
+		laps.push_back(s);
+	}
+
+	irsdkLapSummary &s = laps.back();
+	s.numRecords++;
+	if(job.pitIdx >= 0 && r.getVarBool(job.pitIdx))
+		s.pitted = true;
+}
+
+static void scanChunk(irsdkScanJob &job, int chunk, int first, int end)
+{
+	irsdkDiskCursor c(job.ibt);
+	if(!c.seek(first))
+		return;
+
+	do
+		addLine(job, c, c.getRecordIdx(), job.chunks[chunk]);
+	while(c.getRecordIdx() + 1 < end && c.next());
+}
+
+// stitch the chunks together and work out lap times, fuel and stints
+static void finishFile(irsdkScanJob &job)
+{
+	irsdkFileSummary &res = *job.result;
+
+	std::vector<irsdkLapSummary> &laps = res.laps;
+	for(const std::vector<irsdkLapSummary> &chunk : job.chunks)
+	{
+		for(const irsdkLapSummary &s : chunk)
+		{
+			irsdkLapSummary *prev = laps.empty() ? NULL : &laps.back();
+			if(prev && prev->lap == s.lap && prev->firstRecord + prev->numRecords == s.firstRecord)
+			{
+				prev->numRecords += s.numRecords;
+				prev->pitted = prev->pitted || s.pitted;
+			}
+			else
+				laps.push_back(s);
+		}
+	}
+	job.chunks.clear();
+
+	// the first lap may have been joined halfway, the last one may not be finished
+	const int numLaps = (int)laps.size();
+	for(int i=1; i<numLaps-1; i++)
+	{
+		irsdkLapSummary &s = laps[i];
+		const irsdkLapSummary &next = laps[i+1];
+		if(next.lap == s.lap + 1 && laps[i-1].lap == s.lap - 1)
+		{
+			s.complete = true;
+			s.lapTime = next.startTime - s.startTime;
+			s.fuelUsed = s.startFuel - next.startFuel;
+		}
+	}
+
+	double lapTimeSum = 0;
+	float fuelSum = 0;
+	for(int i=0; i<numLaps; i++)
+	{
+		const irsdkLapSummary &s = laps[i];
+		if(!s.complete || s.pitted)
+			continue;
+
+		if(res.bestLapTime <= 0 || s.lapTime < res.bestLapTime)
+			res.bestLapTime = s.lapTime;
+		if(job.fuelIdx >= 0 && s.fuelUsed > 0)
+		{
+			fuelSum += s.fuelUsed;
+			res.numFuelLaps++;
+		}
+
+		// carries on the stint if the previous lap did
+		const bool continues = i > 0 && laps[i-1].complete && !laps[i-1].pitted && !res.stints.empty();
+		if(!continues)
+		{
+			irsdkStintSummary st;
+			memset(&st, 0, sizeof(st));
+			st.firstLap = s.lap;
+			st.bestLapTime = s.lapTime;
+			res.stints.push_back(st);
+			lapTimeSum = 0;
+		}
+
+		irsdkStintSummary &st = res.stints.back();
+		st.numLaps++;
+		lapTimeSum += s.lapTime;
+		st.avgLapTime = lapTimeSum / st.numLaps;
+		if(s.lapTime < st.bestLapTime)
+			st.bestLapTime = s.lapTime;
+		if(s.fuelUsed > 0) // not the laps fuel was added on
+			st.fuelUsed += s.fuelUsed;
+	}
+	res.fuelPerLap = res.numFuelLaps ? fuelSum / res.numFuelLaps : 0.0f;
+	res.ok = true;
+}
+
+static void readSessionInfo(irsdkDiskClient &ibt, irsdkFileSummary &res)
+{
+	char val[256];
+	if(ibt.getSessionStrVal("WeekendInfo:TrackName:", val, sizeof(val)-1) == 1)
+		res.track = val;
+
+	if(ibt.getSessionStrVal("DriverInfo:DriverCarIdx:", val, sizeof(val)-1) == 1)
+	{
+		char path[128];
+		snprintf(path, sizeof(path), "DriverInfo:Drivers:CarIdx:{%d}CarScreenName:", atoi(val));
+		if(ibt.getSessionStrVal(path, val, sizeof(val)-1) == 1)
+			res.car = val;
+	}
+}
+
+static void scanFile(irsdkWorkPool &pool, const std::string &path, irsdkFileSummary &res, int chunkRecords)
+{
+	std::shared_ptr<irsdkScanJob> job = std::make_shared<irsdkScanJob>();
+	job->result = &res;
+
+	irsdkDiskClient &ibt = job->ibt;
+	if(!ibt.openFile(path.c_str()))
+		return;
+
+	readSessionInfo(ibt, res);
+	res.numRecords = ibt.getRecordCount();
+
+	job->lapIdx = ibt.getVarIdx("Lap");
+	job->timeIdx = ibt.getVarIdx("SessionTime");
+	job->fuelIdx = ibt.getVarIdx("FuelLevel");
+	job->pitIdx = ibt.getVarIdx("OnPitRoad");
+	if(job->lapIdx < 0 || job->timeIdx < 0)
+		return;
+
+	// what is actually read, a compressed file decodes to a lot more
+	if(ibt.isPacked())
+		res.bytes = (long long)ibt.getMappedSize();
+	else
+		res.bytes = ibt.getHeader()->varBuf[0].bufOffset + (long long)res.numRecords * ibt.getHeader()->bufLen;
+
+	// can't be shared between threads unless it is mapped, read it here in one go then
+	if(!ibt.isMapped())
+	{
+		job->chunks.resize(1);
+		for(int i=0; ibt.getNextData(); i++)
+			addLine(*job, ibt, i, job->chunks[0]);
+		finishFile(*job);
+		return;
+	}
+
+	// a chunk that splits a compressed block would decode it twice
+	if(ibt.isPacked())
+	{
+		const int blockRecords = ibt.getPackBlockRecords();
+		chunkRecords = (chunkRecords + blockRecords - 1) / blockRecords * blockRecords;
+	}
+
+	const int numChunks = res.numRecords ? (res.numRecords + chunkRecords - 1) / chunkRecords : 1;
+	job->chunks.resize(numChunks);
+	job->chunksLeft = numChunks;
+	ibt.setAccessHint(irsdkFileMap::Access_Sequential);
+
+	// onto this worker's queue, idle ones steal from the front
+	for(int k=0; k<numChunks; k++)
+	{
+		const int first = k * chunkRecords;
+		const int end = first + chunkRecords < res.numRecords ? first + chunkRecords : res.numRecords;
+		pool.push([job, k, first, end] {
+			scanChunk(*job, k, first, end);
+			if(job->chunksLeft.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				finishFile(*job);
+		});
+	}
+}
+
+void irsdk_scanFiles(const std::vector<std::string> &paths, std::vector<irsdkFileSummary> &results, int numThreads, int chunkRecords)
+{
+	if(chunkRecords < 1)
+		chunkRecords = 1;
+
+	results.clear();
+	results.resize(paths.size());
+	for(size_t i=0; i<paths.size(); i++)
+	{
+		results[i].path = paths[i];
+		results[i].bytes = 0;
+		results[i].numRecords = 0;
+		results[i].ok = false;
+		results[i].bestLapTime = 0;
+		results[i].fuelPerLap = 0;
+		results[i].numFuelLaps = 0;
+	}
+
+	irsdkWorkPool pool(numThreads);
+	for(size_t i=0; i<paths.size(); i++)
+	{
+		irsdkFileSummary *res = &results[i];
+		const std::string *path = &paths[i];
+		pool.push([&pool, path, res, chunkRecords] { scanFile(pool, *path, *res, chunkRecords); });
+	}
+	pool.wait();
+}
@@ -0,0 +1,81 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IRSDKSCAN_H
+#define IRSDKSCAN_H
+
+#include <string>
+#include <vector>
+
+// Lap by lap summaries of a pile of .ibt files, read in parallel on an
+// irsdkWorkPool. Every file is split into chunks of lines, each chunk walks
+// the file's mapping with a cursor of its own and the pieces of laps that
+// straddle chunks are stitched back together once the file is done.
+
+struct irsdkLapSummary
+{
+	int lap;
+	int firstRecord;
+	int numRecords;
+	double startTime;	// SessionTime at the first line of the lap
+	float startFuel;	// FuelLevel there, 0 if not logged
+	bool pitted;		// on pit road at some point during the lap
+	bool complete;		// started and finished in the file, and the next lap is lap+1
+	double lapTime;		// only for complete laps, to the start of the next
+	float fuelUsed;		// likewise, negative if fuel was added
+};
+
+// complete laps in a row without going through the pits
+struct irsdkStintSummary
+{
+	int firstLap;
+	int numLaps;
+	double bestLapTime;
+	double avgLapTime;
+	float fuelUsed;
+};
+
+struct irsdkFileSummary
+{
+	std::string path;
+	std::string track;		// WeekendInfo:TrackName
+	std::string car;		// the player's car, DriverInfo:Drivers:CarIdx:{DriverCarIdx}CarScreenName
+	long long bytes;		// read to summarize it, the file size if compressed. 0 unless ok
+	int numRecords;
+	bool ok;				// false if the file couldn't be read or lacks Lap/SessionTime
+
+	std::vector<irsdkLapSummary> laps;
+	std::vector<irsdkStintSummary> stints;
+
+	double bestLapTime;		// of the complete laps not through the pits, 0 if none
+	float fuelPerLap;		// average over those, 0 if not logged
+	int numFuelLaps;		// how many laps that average is over
+};
+
+// Summarize every file in paths, results in the same order. Lines are handed
+// out chunkRecords at a time, 0 threads is one per core.
+void irsdk_scanFiles(const std::vector<std::string> &paths, std::vector<irsdkFileSummary> &results, int numThreads = 0, int chunkRecords = 64 * 1024);
+
+#endif // IRSDKSCAN_H
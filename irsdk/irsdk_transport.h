@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IRSDKTRANSPORT_H
+#define IRSDKTRANSPORT_H
+
+// The memory mapped file and data valid event the live data is passed through.
+// irsdk_utils only talks to the sim through this, so the client side can run
+// against a stand-in producer, on Windows or on POSIX shared memory.
+class irsdkTransport
+{
+public:
+	virtual ~irsdkTransport() {}
+
+	// map the shared memory read only and open the event, false if nobody is producing
+	virtual bool open() = 0;
+	virtual void close() = 0;
+
+	// start of the mapping, or NULL if not open
+	virtual const char *getSharedMem() = 0;
+
+	// sleep until the producer signals new data, or timeOut ms have passed
+	virtual void waitForDataValid(int timeOut) = 0;
+
+	// tell a stand-in producer which tick we are done with, so it can measure
+	// how far behind we are. The sim does not listen, so this is a no-op there.
+	virtual void ackTick(int /*tickCount*/) {}
+};
+
+// The other end, for tools that stand in for the sim.
+class irsdkTransportProducer
+{
+public:
+	virtual ~irsdkTransportProducer() {}
+
+	// create the shared memory with room for size bytes, and the event
+	virtual bool create(int size) = 0;
+	virtual void close() = 0;
+
+	virtual char *getSharedMem() = 0;
+
+	// wake up clients waiting in irsdkTransport::waitForDataValid()
+	virtual void signalDataValid() = 0;
+
+	// last tick a client passed to irsdkTransport::ackTick(), -1 if none has yet
+	virtual int getAckTick() = 0;
+};
+
+// native transport for this platform, caller owns the result
+irsdkTransport *irsdk_createTransport();
+irsdkTransportProducer *irsdk_createTransportProducer();
+
+// read the live data through another transport, NULL goes back to the native one.
+// Shuts down any open connection, the caller keeps ownership of transport.
+void irsdk_setTransport(irsdkTransport *transport);
+
+#endif // IRSDKTRANSPORT_H
@@ -0,0 +1,263 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef _WIN32
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "irsdk_defines.h"
+#include "irsdk_transport.h"
+
+// POSIX names for the memory mapped file and the data valid event
+static const char IRSDK_POSIX_MEMMAPNAME[]   = "/IRSDKMemMapFileName";
+static const char IRSDK_POSIX_DATAVALIDNAME[] = "/IRSDKDataValidEvent";
+static const char IRSDK_POSIX_ACKTICKNAME[]   = "/IRSDKAckTick";
+
+// Map this much no matter how big the object currently is, so a producer
+// that restarts with a bigger line does not leave us with a short mapping.
+// Only the pages the header points at are ever touched.
+static const size_t IRSDK_POSIX_MAPSIZE = 64 * 1024 * 1024;
+
+// The data valid event is a counter in a shared memory object of its own,
+// bumped for every new line. Waiters sleep on it with a futex on Linux and
+// fall back to polling elsewhere.
+typedef std::atomic<unsigned int> irsdkPosixEvent;
+static_assert(sizeof(irsdkPosixEvent) == sizeof(unsigned int), "futex needs a plain 32 bit word");
+
+// tick count the client acknowledged, only a stand-in producer creates this
+typedef std::atomic<int> irsdkPosixAck;
+
+static void eventWait(const irsdkPosixEvent *ev, unsigned int seq, int timeOut)
+{
+#ifdef __linux__
+	struct timespec ts;
+	ts.tv_sec = timeOut / 1000;
+	ts.tv_nsec = (timeOut % 1000) * 1000000L;
+	syscall(SYS_futex, (const unsigned int *)ev, FUTEX_WAIT, seq, &ts, NULL, 0);
+#else
+	const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeOut);
+	while(ev->load(std::memory_order_acquire) == seq && std::chrono::steady_clock::now() < end)
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+#endif
+}
+
+static void eventWakeAll(irsdkPosixEvent *ev)
+{
+	ev->fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+	syscall(SYS_futex, (unsigned int *)ev, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+// map a named shared memory object, creating it with at least size bytes if asked to,
+// an object that is only opened is mapped read only unless writable is set
+static void *mapObject(const char *name, bool create, size_t size, size_t mapSize, bool writable = false)
+{
+	writable = writable || create;
+	const int fd = shm_open(name, create ? (O_RDWR | O_CREAT) : (writable ? O_RDWR : O_RDONLY), create ? 0666 : 0);
+	if(fd < 0)
+		return NULL;
+
+	struct stat st;
+	if(create && (fstat(fd, &st) != 0 || (size_t)st.st_size < size) && ftruncate(fd, size) != 0)
+	{
+		::close(fd);
+		return NULL;
+	}
+
+	void *mem = mmap(NULL, mapSize, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd); // the mapping keeps the object alive
+
+	return mem == MAP_FAILED ? NULL : mem;
+}
+
+class irsdkTransportPosix : public irsdkTransport
+{
+public:
+	irsdkTransportPosix()
+		: pSharedMem(NULL)
+		, pDataValid(NULL)
+		, pAckTick(NULL)
+		, lastSeq(0)
+	{ }
+
+	virtual ~irsdkTransportPosix() { close(); }
+
+	virtual bool open()
+	{
+		if(!pSharedMem)
+			pSharedMem = (const char *)mapObject(IRSDK_POSIX_MEMMAPNAME, false, 0, IRSDK_POSIX_MAPSIZE);
+
+		if(pSharedMem && !pDataValid)
+		{
+			pDataValid = (irsdkPosixEvent *)mapObject(IRSDK_POSIX_DATAVALIDNAME, false, 0, sizeof(irsdkPosixEvent));
+			if(pDataValid)
+				lastSeq = pDataValid->load(std::memory_order_acquire);
+		}
+
+		// optional, so it does not count towards being open
+		if(pSharedMem && !pAckTick)
+			pAckTick = (irsdkPosixAck *)mapObject(IRSDK_POSIX_ACKTICKNAME, false, 0, sizeof(irsdkPosixAck), true);
+
+		return pSharedMem && pDataValid;
+	}
+
+	virtual void close()
+	{
+		if(pSharedMem)
+			munmap((void *)pSharedMem, IRSDK_POSIX_MAPSIZE);
+
+		if(pDataValid)
+			munmap((void *)pDataValid, sizeof(irsdkPosixEvent));
+
+		if(pAckTick)
+			munmap(pAckTick, sizeof(irsdkPosixAck));
+
+		pSharedMem = NULL;
+		pDataValid = NULL;
+		pAckTick = NULL;
+	}
+
+	virtual const char *getSharedMem() { return pSharedMem; }
+
+	virtual void waitForDataValid(int timeOut)
+	{
+		// a signal that came in since we last looked counts, like a set event would
+		unsigned int seq = pDataValid->load(std::memory_order_acquire);
+		if(seq == lastSeq)
+		{
+			eventWait(pDataValid, seq, timeOut);
+			seq = pDataValid->load(std::memory_order_acquire);
+		}
+		lastSeq = seq;
+	}
+
+	virtual void ackTick(int tickCount)
+	{
+		if(pAckTick)
+			pAckTick->store(tickCount, std::memory_order_release);
+	}
+
+protected:
+	const char *pSharedMem;
+	const irsdkPosixEvent *pDataValid;
+	irsdkPosixAck *pAckTick;
+	unsigned int lastSeq;
+};
+
+class irsdkTransportProducerPosix : public irsdkTransportProducer
+{
+public:
+	irsdkTransportProducerPosix()
+		: pSharedMem(NULL)
+		, pDataValid(NULL)
+		, pAckTick(NULL)
+		, memSize(0)
+	{ }
+
+	virtual ~irsdkTransportProducerPosix() { close(); }
+
+	virtual bool create(int size)
+	{
+		close();
+
+		// the objects are left in place on close, so clients that still have
+		// them mapped pick us up again when we come back, like with the sim
+		pSharedMem = (char *)mapObject(IRSDK_POSIX_MEMMAPNAME, true, size, size);
+		pDataValid = (irsdkPosixEvent *)mapObject(IRSDK_POSIX_DATAVALIDNAME, true, sizeof(irsdkPosixEvent), sizeof(irsdkPosixEvent));
+		pAckTick = (irsdkPosixAck *)mapObject(IRSDK_POSIX_ACKTICKNAME, true, sizeof(irsdkPosixAck), sizeof(irsdkPosixAck));
+		memSize = size;
+
+		if(pSharedMem && pDataValid && pAckTick)
+		{
+			pAckTick->store(-1, std::memory_order_release);
+			return true;
+		}
+
+		close();
+		return false;
+	}
+
+	virtual void close()
+	{
+		if(pSharedMem)
+			munmap(pSharedMem, memSize);
+
+		if(pDataValid)
+			munmap(pDataValid, sizeof(irsdkPosixEvent));
+
+		if(pAckTick)
+			munmap(pAckTick, sizeof(irsdkPosixAck));
+
+		pSharedMem = NULL;
+		pDataValid = NULL;
+		pAckTick = NULL;
+		memSize = 0;
+	}
+
+	virtual char *getSharedMem() { return pSharedMem; }
+
+	virtual void signalDataValid()
+	{
+		eventWakeAll(pDataValid);
+	}
+
+	virtual int getAckTick()
+	{
+		return pAckTick ? pAckTick->load(std::memory_order_acquire) : -1;
+	}
+
+protected:
+	char *pSharedMem;
+	irsdkPosixEvent *pDataValid;
+	irsdkPosixAck *pAckTick;
+	size_t memSize;
+};
+
+irsdkTransport *irsdk_createTransport()
+{
+	return new irsdkTransportPosix();
+}
+
+irsdkTransportProducer *irsdk_createTransportProducer()
+{
+	return new irsdkTransportProducerPosix();
+}
+
+#endif // !_WIN32
@@ -0,0 +1,241 @@
+/*
+Copyright (c) 2013, iRacing.com Motorsport Simulations, LLC.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of iRacing.com Motorsport Simulations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifdef _WIN32
+
+#define MIN_WIN_VER 0x0501
+
+#ifndef WINVER
+#	define WINVER			MIN_WIN_VER
+#endif
+
+#ifndef _WIN32_WINNT
+#	define _WIN32_WINNT		MIN_WIN_VER 
+#endif
+
+#include <windows.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "irsdk_defines.h"
+#include "irsdk_transport.h"
+
+// only created by a stand-in producer, holds the tick count the client acknowledged
+static const _TCHAR IRSDK_ACKTICKNAME[] = _T("Local\\IRSDKAckTick");
+
+// the memory mapped file and event the sim creates
+class irsdkTransportWin32 : public irsdkTransport
+{
+public:
+	irsdkTransportWin32()
+		: hDataValidEvent(NULL)
+		, hMemMapFile(NULL)
+		, pSharedMem(NULL)
+		, hAckFile(NULL)
+		, pAckTick(NULL)
+	{ }
+
+	virtual ~irsdkTransportWin32() { close(); }
+
+	virtual bool open()
+	{
+		if(!hMemMapFile)
+			hMemMapFile = OpenFileMapping( FILE_MAP_READ, FALSE, IRSDK_MEMMAPFILENAME);
+
+		if(hMemMapFile)
+		{
+			if(!pSharedMem)
+				pSharedMem = (const char *)MapViewOfFile(hMemMapFile, FILE_MAP_READ, 0, 0, 0);
+
+			if(pSharedMem)
+			{
+				if(!hDataValidEvent)
+					hDataValidEvent = OpenEvent(SYNCHRONIZE, false, IRSDK_DATAVALIDEVENTNAME);
+
+				// optional, the sim does not create it
+				if(!hAckFile)
+				{
+					hAckFile = OpenFileMapping(FILE_MAP_WRITE, FALSE, IRSDK_ACKTICKNAME);
+					if(hAckFile)
+						pAckTick = (volatile LONG *)MapViewOfFile(hAckFile, FILE_MAP_WRITE, 0, 0, sizeof(LONG));
+				}
+
+				if(hDataValidEvent)
+					return true;
+				//else printf("Error opening event: %d\n", GetLastError()); 
+			}
+			//else printf("Error mapping file: %d\n", GetLastError()); 
+		}
+		//else printf("Error opening file: %d\n", GetLastError()); 
+
+		return false;
+	}
+
+	virtual void close()
+	{
+		if(hDataValidEvent)
+			CloseHandle(hDataValidEvent);
+
+		if(pSharedMem)
+			UnmapViewOfFile(pSharedMem);
+
+		if(hMemMapFile)
+			CloseHandle(hMemMapFile);
+
+		if(pAckTick)
+			UnmapViewOfFile((LPCVOID)pAckTick);
+
+		if(hAckFile)
+			CloseHandle(hAckFile);
+
+		hDataValidEvent = NULL;
+		pSharedMem = NULL;
+		hMemMapFile = NULL;
+		pAckTick = NULL;
+		hAckFile = NULL;
+	}
+
+	virtual const char *getSharedMem() { return pSharedMem; }
+
+	virtual void waitForDataValid(int timeOut)
+	{
+		WaitForSingleObject(hDataValidEvent, timeOut);
+	}
+
+	virtual void ackTick(int tickCount)
+	{
+		if(pAckTick)
+			InterlockedExchange(pAckTick, tickCount);
+	}
+
+protected:
+	HANDLE hDataValidEvent;
+	HANDLE hMemMapFile;
+	const char *pSharedMem;
+	HANDLE hAckFile;
+	volatile LONG *pAckTick;
+};
+
+// stand in for the sim, creates the same named objects
+class irsdkTransportProducerWin32 : public irsdkTransportProducer
+{
+public:
+	irsdkTransportProducerWin32()
+		: hDataValidEvent(NULL)
+		, hMemMapFile(NULL)
+		, pSharedMem(NULL)
+		, hAckFile(NULL)
+		, pAckTick(NULL)
+	{ }
+
+	virtual ~irsdkTransportProducerWin32() { close(); }
+
+	virtual bool create(int size)
+	{
+		close();
+
+		hMemMapFile = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, size, IRSDK_MEMMAPFILENAME);
+		if(hMemMapFile)
+		{
+			pSharedMem = (char *)MapViewOfFile(hMemMapFile, FILE_MAP_ALL_ACCESS, 0, 0, size);
+			if(pSharedMem)
+			{
+				// auto reset, so a set is never lost the way a pulse can be. It wakes
+				// one waiter, any others see the new tick when their wait times out
+				hDataValidEvent = CreateEvent(NULL, FALSE, FALSE, IRSDK_DATAVALIDEVENTNAME);
+
+				hAckFile = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(LONG), IRSDK_ACKTICKNAME);
+				if(hAckFile)
+					pAckTick = (volatile LONG *)MapViewOfFile(hAckFile, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(LONG));
+
+				if(hDataValidEvent && pAckTick)
+				{
+					InterlockedExchange(pAckTick, -1);
+					return true;
+				}
+			}
+		}
+
+		close();
+		return false;
+	}
+
+	virtual void close()
+	{
+		if(hDataValidEvent)
+			CloseHandle(hDataValidEvent);
+
+		if(pSharedMem)
+			UnmapViewOfFile(pSharedMem);
+
+		if(hMemMapFile)
+			CloseHandle(hMemMapFile);
+
+		if(pAckTick)
+			UnmapViewOfFile((LPCVOID)pAckTick);
+
+		if(hAckFile)
+			CloseHandle(hAckFile);
+
+		hDataValidEvent = NULL;
+		pSharedMem = NULL;
+		hMemMapFile = NULL;
+		pAckTick = NULL;
+		hAckFile = NULL;
+	}
+
+	virtual char *getSharedMem() { return pSharedMem; }
+
+	virtual void signalDataValid()
+	{
+		SetEvent(hDataValidEvent);
+	}
+
+	virtual int getAckTick()
+	{
+		return pAckTick ? InterlockedCompareExchange(pAckTick, 0, 0) : -1;
+	}
+
+protected:
+	HANDLE hDataValidEvent;
+	HANDLE hMemMapFile;
+	char *pSharedMem;
+	HANDLE hAckFile;
+	volatile LONG *pAckTick;
+};
+
+irsdkTransport *irsdk_createTransport()
+{
+	return new irsdkTransportWin32();
+}
+
+irsdkTransportProducer *irsdk_createTransportProducer()
+{
+	return new irsdkTransportProducerWin32();
+}
+
+#endif // _WIN32
@@ -25,6 +25,8 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#ifdef _WIN32
+
 #define MIN_WIN_VER 0x0501
 
 #ifndef WINVER
@@ -36,130 +38,182 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <windows.h>
+
+#endif
+
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include <limits.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
 
 #ifdef _MSC_VER
 #include <crtdbg.h>
 #endif
 
 #include "irsdk_defines.h"
+#include "irsdk_varindex.h"
+#include "irsdk_transport.h"
 
+#ifdef _MSC_VER
 // for timeBeginPeriod()
 #pragma comment(lib, "Winmm")
 // for RegisterWindowMessage() and SendMessage()
 #pragma comment(lib, "User32")
+#endif
 
 // Local memory
 
-static HANDLE hDataValidEvent = NULL;
-static HANDLE hMemMapFile = NULL;
+// where the data comes from, the native transport unless told otherwise
+static irsdkTransport *pTransport = NULL;
+static irsdkTransport *pNativeTransport = NULL;
 
-static const char *pSharedMem = NULL;
-static const irsdk_header *pHeader = NULL;
+// Set up and torn down by irsdk_startup()/irsdk_shutdown() on the thread pulling in data,
+// but the header accessors further down are called from other threads as well
+static std::atomic<const irsdk_header *> pHeader(NULL);
+static std::atomic<bool> isInitialized(false);
 
 static int lastTickCount = INT_MAX;
-static bool isInitialized = false;
 
 static const double timeout = 30.0; // timeout after 30 seconds with no communication
 static time_t lastValidTime = 0;
 
+// read lines in order instead of skipping to the latest
+static bool catchUp = false;
+static int droppedTicks = 0;
+
+// name lookup table over the var headers, rebuilt lazily for each new connection
+static irsdkVarIndex varIndex;
+// lookups may come from a different thread than the one pulling in data
+static std::mutex varIndexLock;
+
+static void clearVarIndex()
+{
+	std::lock_guard<std::mutex> lock(varIndexLock);
+	varIndex.clear();
+}
+
 // Function Implementations
 
 bool irsdk_startup()
 {
-	if(!hMemMapFile)
+	if(!pTransport)
 	{
-		hMemMapFile = OpenFileMapping( FILE_MAP_READ, FALSE, IRSDK_MEMMAPFILENAME);
-		lastTickCount = INT_MAX;
+		if(!pNativeTransport)
+			pNativeTransport = irsdk_createTransport();
+		pTransport = pNativeTransport;
 	}
 
-	if(hMemMapFile)
+	if(pTransport->open())
 	{
-		if(!pSharedMem)
+		const irsdk_header *header = (const irsdk_header *)pTransport->getSharedMem();
+		if(pHeader.load(std::memory_order_relaxed) != header)
 		{
-			pSharedMem = (const char *)MapViewOfFile(hMemMapFile, FILE_MAP_READ, 0, 0, 0);
-			pHeader = (irsdk_header *)pSharedMem;
+			pHeader.store(header, std::memory_order_release);
 			lastTickCount = INT_MAX;
 		}
 
-		if(pSharedMem)
-		{
-			if(!hDataValidEvent)
-			{
-				hDataValidEvent = OpenEvent(SYNCHRONIZE, false, IRSDK_DATAVALIDEVENTNAME);
-				lastTickCount = INT_MAX;
-			}
-
-			if(hDataValidEvent)
-			{
-				isInitialized = true;
-				return isInitialized;
-			}
-			//else printf("Error opening event: %d\n", GetLastError()); 
-		}
-		//else printf("Error mapping file: %d\n", GetLastError()); 
+		isInitialized.store(true, std::memory_order_release);
+		return true;
 	}
-	//else printf("Error opening file: %d\n", GetLastError()); 
 
-	isInitialized = false;
-	return isInitialized;
+	isInitialized.store(false, std::memory_order_release);
+	return false;
 }
 
 void irsdk_shutdown()
 {
-	if(hDataValidEvent)
-		CloseHandle(hDataValidEvent);
-
-	if(pSharedMem)
-		UnmapViewOfFile(pSharedMem);
+	if(pTransport)
+		pTransport->close();
 
-	if(hMemMapFile)
-		CloseHandle(hMemMapFile);
+	isInitialized.store(false, std::memory_order_release);
+	pHeader.store(NULL, std::memory_order_release);
+	lastTickCount = INT_MAX;
+	clearVarIndex();
+}
 
-	hDataValidEvent = NULL;
-	pSharedMem = NULL;
-	pHeader = NULL;
-	hMemMapFile = NULL;
+// The current connection's header, NULL if there is none. Every accessor that may be
+// called off the ingest thread goes through this, the shared memory starts at the header.
+static const irsdk_header *liveHeader()
+{
+	if(!isInitialized.load(std::memory_order_acquire))
+		return NULL;
+	return pHeader.load(std::memory_order_acquire);
+}
 
-	isInitialized = false;
-	lastTickCount = INT_MAX;
+// copy the whole line, or just the requested ranges of it if numRanges > 0
+static void copyData(char *data, const char *src, int bufLen, const irsdk_dataRange *ranges, int numRanges)
+{
+	if(numRanges > 0)
+	{
+		for(int i=0; i<numRanges; i++)
+		{
+			if(ranges[i].offset >= 0 && ranges[i].offset + ranges[i].len <= bufLen)
+				memcpy(data + ranges[i].offset, src + ranges[i].offset, ranges[i].len);
+		}
+	}
+	else
+		memcpy(data, src, bufLen);
 }
 
 bool irsdk_getNewData(char *data)
+{
+	return irsdk_getNewDataRanges(data, NULL, 0);
+}
+
+bool irsdk_getNewDataRanges(char *data, const irsdk_dataRange *ranges, int numRanges)
 {
 	if(isInitialized || irsdk_startup())
 	{
+		// only this thread changes it
+		const irsdk_header *header = pHeader.load(std::memory_order_relaxed);
+		const char *sharedMem = (const char *)header;
 #ifdef _MSC_VER
-		_ASSERTE(NULL != pHeader);
+		_ASSERTE(NULL != header);
 #endif
 
 		// if sim is not active, then no new data
-		if(!(pHeader->status & irsdk_stConnected))
+		if(!(header->status & irsdk_stConnected))
 		{
 			lastTickCount = INT_MAX;
+			clearVarIndex();
 			return false;
 		}
 
 		int latest = 0;
-		for(int i=1; i<pHeader->numBuf; i++)
-			if(pHeader->varBuf[latest].tickCount < pHeader->varBuf[i].tickCount)
+		for(int i=1; i<header->numBuf; i++)
+			if(header->varBuf[latest].tickCount < header->varBuf[i].tickCount)
 			   latest = i;	
 
 		// if newer than last recieved, than report new data
-		if(lastTickCount < pHeader->varBuf[latest].tickCount)
+		if(lastTickCount < header->varBuf[latest].tickCount)
 		{
 			// if asked to retrieve the data
 			if(data)
 			{
+				// in catch up mode go for the oldest line we have not seen yet
+				int next = latest;
+				if(catchUp && lastTickCount != INT_MAX)
+				{
+					for(int i=0; i<header->numBuf; i++)
+						if(lastTickCount < header->varBuf[i].tickCount && header->varBuf[i].tickCount < header->varBuf[next].tickCount)
+							next = i;
+				}
+
 				// try twice to get the data out
 				for(int count = 0; count < 2; count++)
 				{
-					int curTickCount =  pHeader->varBuf[latest].tickCount;
-					memcpy(data, pSharedMem + pHeader->varBuf[latest].bufOffset, pHeader->bufLen);
-					if(curTickCount ==  pHeader->varBuf[latest].tickCount)
+					int curTickCount =  header->varBuf[next].tickCount;
+					copyData(data, sharedMem + header->varBuf[next].bufOffset, header->bufLen, ranges, numRanges);
+					if(curTickCount ==  header->varBuf[next].tickCount)
 					{
+						// count the lines that were overwritten before we got to them
+						if(lastTickCount != INT_MAX && curTickCount > lastTickCount + 1)
+							droppedTicks += curTickCount - lastTickCount - 1;
+
 						lastTickCount = curTickCount;
 						lastValidTime = time(NULL);
 						return true;
@@ -170,15 +224,16 @@ bool irsdk_getNewData(char *data)
 			}
 			else
 			{
-				lastTickCount =  pHeader->varBuf[latest].tickCount;
+				lastTickCount =  header->varBuf[latest].tickCount;
 				lastValidTime = time(NULL);
 				return true;
 			}
 		}
 		// if older than last recieved, than reset, we probably disconnected
-		else if(lastTickCount >  pHeader->varBuf[latest].tickCount)
+		else if(lastTickCount >  header->varBuf[latest].tickCount)
 		{
-			lastTickCount =  pHeader->varBuf[latest].tickCount;
+			lastTickCount =  header->varBuf[latest].tickCount;
+			clearVarIndex();
 			return false;
 		}
 		// else the same, and nothing changed this tick
@@ -189,6 +244,11 @@ bool irsdk_getNewData(char *data)
 
 
 bool irsdk_waitForDataReady(int timeOut, char *data)
+{
+	return irsdk_waitForDataReadyRanges(timeOut, data, NULL, 0);
+}
+
+bool irsdk_waitForDataReadyRanges(int timeOut, char *data, const irsdk_dataRange *ranges, int numRanges)
 {
 #ifdef _MSC_VER
 	_ASSERTE(timeOut >= 0);
@@ -197,14 +257,14 @@ bool irsdk_waitForDataReady(int timeOut, char *data)
 	if(isInitialized || irsdk_startup())
 	{
 		// just to be sure, check before we sleep
-		if(irsdk_getNewData(data))
+		if(irsdk_getNewDataRanges(data, ranges, numRanges))
 			return true;
 
 		// sleep till signaled
-		WaitForSingleObject(hDataValidEvent, timeOut);
+		pTransport->waitForDataValid(timeOut);
 
 		// we woke up, so check for data
-		if(irsdk_getNewData(data))
+		if(irsdk_getNewDataRanges(data, ranges, numRanges))
 			return true;
 		else
 			return false;
@@ -212,17 +272,18 @@ bool irsdk_waitForDataReady(int timeOut, char *data)
 
 	// sleep if error
 	if(timeOut > 0)
-		Sleep(timeOut);
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeOut));
 
 	return false;
 }
 
 bool irsdk_isConnected()
 {
-	if(isInitialized)
+	const irsdk_header *header = liveHeader();
+	if(header)
 	{
 		int elapsed = (int)difftime(time(NULL), lastValidTime);
-		return (pHeader->status & irsdk_stConnected) > 0 && elapsed < timeout;
+		return (header->status & irsdk_stConnected) > 0 && elapsed < timeout;
 	}
 
 	return false;
@@ -230,12 +291,7 @@ bool irsdk_isConnected()
 
 const irsdk_header *irsdk_getHeader()
 {
-	if(isInitialized)
-	{
-		return pHeader;
-	}
-
-	return NULL;
+	return liveHeader();
 }
 
 // direct access to the data buffer
@@ -243,9 +299,10 @@ const irsdk_header *irsdk_getHeader()
 // Use the cached copy from irsdk_waitForDataReady() or irsdk_getNewData() instead
 const char *irsdk_getData(int index)
 {
-	if(isInitialized)
+	const irsdk_header *header = liveHeader();
+	if(header)
 	{
-		return pSharedMem + pHeader->varBuf[index].bufOffset;
+		return (const char *)header + header->varBuf[index].bufOffset;
 	}
 
 	return NULL;
@@ -253,58 +310,88 @@ const char *irsdk_getData(int index)
 
 const char *irsdk_getSessionInfoStr()
 {
-	if(isInitialized)
+	const irsdk_header *header = liveHeader();
+	if(header)
 	{
-		return pSharedMem + pHeader->sessionInfoOffset;
+		return (const char *)header + header->sessionInfoOffset;
 	}
 	return NULL;
 }
 
-int irsdk_getSessionInfoStrUpdate()
+void irsdk_setTransport(irsdkTransport *transport)
+{
+	irsdk_shutdown();
+	pTransport = transport;
+}
+
+void irsdk_setCatchUp(bool enable)
+{
+	catchUp = enable;
+}
+
+int irsdk_getDroppedTicks()
+{
+	return droppedTicks;
+}
+
+int irsdk_getLastTickCount()
+{
+	return lastTickCount == INT_MAX ? -1 : lastTickCount;
+}
+
+void irsdk_ackTick(int tickCount)
 {
 	if(isInitialized)
+		pTransport->ackTick(tickCount);
+}
+
+int irsdk_getSessionInfoStrUpdate()
+{
+	const irsdk_header *header = liveHeader();
+	if(header)
 	{
-		return pHeader->sessionInfoUpdate;
+		// the sim bumps this while we look, don't let it be cached
+		return ((volatile const irsdk_header*)header)->sessionInfoUpdate;
 	}
 	return -1;
 }
 
 const irsdk_varHeader *irsdk_getVarHeaderPtr()
 {
-	if(isInitialized)
+	const irsdk_header *header = liveHeader();
+	if(header)
 	{
-		return ((irsdk_varHeader*)(pSharedMem + pHeader->varHeaderOffset));
+		return ((const irsdk_varHeader*)((const char *)header + header->varHeaderOffset));
 	}
 	return NULL;
 }
 
 const irsdk_varHeader *irsdk_getVarHeaderEntry(int index)
 {
-	if(isInitialized)
+	const irsdk_header *header = liveHeader();
+	if(header)
 	{
-		if(index >= 0 && index < pHeader->numVars)
+		if(index >= 0 && index < header->numVars)
 		{
-			return &((irsdk_varHeader*)(pSharedMem + pHeader->varHeaderOffset))[index];
+			return &((const irsdk_varHeader*)((const char *)header + header->varHeaderOffset))[index];
 		}
 	}
 	return NULL;
 }
 
-// Note: this is a linear search, so cache the results
+// hashed lookup, the index is built on first use after a (re)connect
 int irsdk_varNameToIndex(const char *name)
 {
-	const irsdk_varHeader *pVar;
-
-	if(name)
+	const irsdk_header *header = liveHeader();
+	if(name && header)
 	{
-		for(int index=0; index<pHeader->numVars; index++)
-		{
-			pVar = irsdk_getVarHeaderEntry(index);
-			if(pVar && 0 == strncmp(name, pVar->name, IRSDK_MAX_STRING))
-			{
-				return index;
-			}
-		}
+		const irsdk_varHeader *pVarHeaders = (const irsdk_varHeader*)((const char *)header + header->varHeaderOffset);
+		std::lock_guard<std::mutex> lock(varIndexLock);
+
+		if(!varIndex.isBuilt() || varIndex.getNumVars() != header->numVars)
+			varIndex.build(pVarHeaders, header->numVars);
+
+		return varIndex.find(pVarHeaders, name);
 	}
 
 	return -1;
@@ -312,33 +399,31 @@ int irsdk_varNameToIndex(const char *name)
 
 int irsdk_varNameToOffset(const char *name)
 {
-	const irsdk_varHeader *pVar;
+	const irsdk_varHeader *pVar = irsdk_getVarHeaderEntry(irsdk_varNameToIndex(name));
 
-	if(name)
+	if(pVar)
 	{
-		for(int index=0; index<pHeader->numVars; index++)
-		{
-			pVar = irsdk_getVarHeaderEntry(index);
-			if(pVar && 0 == strncmp(name, pVar->name, IRSDK_MAX_STRING))
-			{
-				return pVar->offset;
-			}
-		}
+		return pVar->offset;
 	}
 
 	return -1;
 }
 
+// remote control goes through window messages, so there is none without windows
 unsigned int irsdk_getBroadcastMsgID()
 {
+#ifdef _WIN32
 	static unsigned int msgId = RegisterWindowMessage(IRSDK_BROADCASTMSGNAME); 
+#else
+	static unsigned int msgId = 0;
+#endif
 
 	return msgId;
 }
 
 void irsdk_broadcastMsg(irsdk_BroadcastMsg msg, int var1, int var2, int var3)
 {
-	irsdk_broadcastMsg(msg, var1, (int)MAKELONG(var2, var3));
+	irsdk_broadcastMsg(msg, var1, (int)(((unsigned int)var2 & 0xffff) | (((unsigned int)var3 & 0xffff) << 16)));
 }
 
 void irsdk_broadcastMsg(irsdk_BroadcastMsg msg, int var1, float var2)
@@ -351,12 +436,16 @@ void irsdk_broadcastMsg(irsdk_BroadcastMsg msg, int var1, float var2)
 
 void irsdk_broadcastMsg(irsdk_BroadcastMsg msg, int var1, int var2)
 {
+#ifdef _WIN32
 	static unsigned int msgId = irsdk_getBroadcastMsgID();
 
 	if(msgId && msg >= 0 && msg < irsdk_BroadcastLast)
 	{
 		SendNotifyMessage(HWND_BROADCAST, msgId, MAKELONG(msg, var1), var2);
 	}
+#else
+	(void)msg; (void)var1; (void)var2;
+#endif
 }
 
 int irsdk_padCarNum(int num, int zero)
@@ -0,0 +1,136 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IRSDKVARINDEX_H
+#define IRSDKVARINDEX_H
+
+// Open addressing hash table over an irsdk_varHeader array, so that
+// resolving a variable by name does not have to strncmp every header.
+// Requires irsdk_defines.h to be included first.
+class irsdkVarIndex
+{
+public:
+	irsdkVarIndex()
+		: m_slots(NULL)
+		, m_mask(0)
+		, m_numVars(0)
+	{ }
+
+	~irsdkVarIndex() { clear(); }
+
+	bool isBuilt() const { return m_slots != NULL; }
+	int getNumVars() const { return m_numVars; }
+
+	void clear()
+	{
+		if(m_slots)
+			delete [] m_slots;
+		m_slots = NULL;
+		m_mask = 0;
+		m_numVars = 0;
+	}
+
+	void build(const irsdk_varHeader *varHeaders, int numVars)
+	{
+		clear();
+
+		if(!varHeaders || numVars <= 0)
+			return;
+
+		// keep the load factor under 50% so probe chains stay short
+		int size = 16;
+		while(size < numVars * 2)
+			size <<= 1;
+
+		m_slots = new Slot[size];
+		memset(m_slots, 0, size * sizeof(Slot));
+		m_mask = size - 1;
+		m_numVars = numVars;
+
+		for(int idx=0; idx<numVars; idx++)
+		{
+			const unsigned int h = hash(varHeaders[idx].name);
+			int s = h & m_mask;
+			while(m_slots[s].idx)
+			{
+				// first entry wins, same as the linear search did
+				if(m_slots[s].hash == h && 0 == strncmp(varHeaders[m_slots[s].idx-1].name, varHeaders[idx].name, IRSDK_MAX_STRING))
+					break;
+				s = (s + 1) & m_mask;
+			}
+			if(!m_slots[s].idx)
+			{
+				m_slots[s].hash = h;
+				m_slots[s].idx = idx + 1;
+			}
+		}
+	}
+
+	// varHeaders must be the same table the index was built from
+	int find(const irsdk_varHeader *varHeaders, const char *name) const
+	{
+		if(!m_slots || !varHeaders || !name)
+			return -1;
+
+		const unsigned int h = hash(name);
+		for(int s = h & m_mask; m_slots[s].idx; s = (s + 1) & m_mask)
+		{
+			const int idx = m_slots[s].idx - 1;
+			if(m_slots[s].hash == h && 0 == strncmp(name, varHeaders[idx].name, IRSDK_MAX_STRING))
+				return idx;
+		}
+
+		return -1;
+	}
+
+	// FNV-1a over at most IRSDK_MAX_STRING chars, matching the strncmp above
+	static unsigned int hash(const char *name)
+	{
+		unsigned int h = 2166136261u;
+		for(int i=0; i<IRSDK_MAX_STRING && name[i]; i++)
+		{
+			h ^= (unsigned char)name[i];
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+protected:
+	struct Slot
+	{
+		unsigned int hash;
+		int idx; // var index + 1, 0 marks an empty slot
+	};
+
+	Slot *m_slots;
+	int m_mask;
+	int m_numVars;
+
+private:
+	irsdkVarIndex(const irsdkVarIndex&);
+	irsdkVarIndex& operator=(const irsdkVarIndex&);
+};
+
+#endif // IRSDKVARINDEX_H
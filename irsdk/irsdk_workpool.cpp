@@ -0,0 +1,149 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "irsdk_workpool.h"
+
+// which pool and queue the current thread works for, so push() from a task stays local
+static thread_local irsdkWorkPool *t_pool = NULL;
+static thread_local int t_queue = -1;
+
+irsdkWorkPool::irsdkWorkPool(int numThreads)
+	: m_queued(0)
+	, m_unfinished(0)
+	, m_nextQueue(0)
+	, m_numSteals(0)
+	, m_quit(false)
+{
+	if(numThreads <= 0)
+		numThreads = (int)std::thread::hardware_concurrency();
+	if(numThreads <= 0)
+		numThreads = 1;
+
+	for(int i=0; i<numThreads; i++)
+		m_queues.push_back(std::make_unique<Queue>());
+	for(int i=0; i<numThreads; i++)
+		m_threads.emplace_back(&irsdkWorkPool::run, this, i);
+}
+
+irsdkWorkPool::~irsdkWorkPool()
+{
+	wait();
+
+	{
+		std::lock_guard<std::mutex> lk(m_sleepLock);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+
+	for(std::thread &t : m_threads)
+		t.join();
+}
+
+void irsdkWorkPool::push(Task task)
+{
+	const int q = t_pool == this ? t_queue : (int)(m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size());
+
+	m_unfinished.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lk(m_queues[q]->lock);
+		m_queues[q]->tasks.push_back(std::move(task));
+	}
+
+	// counted under the sleep lock, so a worker that just found nothing can't miss it
+	{
+		std::lock_guard<std::mutex> lk(m_sleepLock);
+		m_queued.fetch_add(1, std::memory_order_release);
+	}
+	m_wake.notify_one();
+}
+
+void irsdkWorkPool::wait()
+{
+	std::unique_lock<std::mutex> lk(m_sleepLock);
+	m_done.wait(lk, [this] { return m_unfinished.load(std::memory_order_acquire) == 0; });
+}
+
+bool irsdkWorkPool::pop(int self, Task &task)
+{
+	// own queue, newest first
+	{
+		Queue &q = *m_queues[self];
+		std::lock_guard<std::mutex> lk(q.lock);
+		if(!q.tasks.empty())
+		{
+			task = std::move(q.tasks.back());
+			q.tasks.pop_back();
+			return true;
+		}
+	}
+
+	// someone else's, oldest first, starting next to us so thieves spread out
+	const int n = (int)m_queues.size();
+	for(int i=1; i<n; i++)
+	{
+		Queue &q = *m_queues[(self + i) % n];
+		std::lock_guard<std::mutex> lk(q.lock);
+		if(!q.tasks.empty())
+		{
+			task = std::move(q.tasks.front());
+			q.tasks.pop_front();
+			m_numSteals.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void irsdkWorkPool::run(int self)
+{
+	t_pool = this;
+	t_queue = self;
+
+	Task task;
+	for(;;)
+	{
+		{
+			std::unique_lock<std::mutex> lk(m_sleepLock);
+			m_wake.wait(lk, [this] { return m_quit || m_queued.load(std::memory_order_acquire) > 0; });
+			if(m_quit)
+				return;
+		}
+
+		// another worker may have got to it first, then just go back to sleep
+		if(!pop(self, task))
+			continue;
+		m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+		task();
+		task = nullptr;
+
+		if(m_unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::lock_guard<std::mutex> lk(m_sleepLock);
+			m_done.notify_all();
+		}
+	}
+}
@@ -0,0 +1,90 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IRSDKWORKPOOL_H
+#define IRSDKWORKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads with a task queue each. A worker runs its own newest task first
+// and, once it runs dry, takes the oldest one off another worker's queue.
+// Tasks pushed from a worker go onto that worker's queue, so a task that
+// splits itself up keeps its pieces close by until someone idle steals them.
+class irsdkWorkPool
+{
+public:
+	typedef std::function<void()> Task;
+
+	// 0 threads is one per core
+	explicit irsdkWorkPool(int numThreads = 0);
+	~irsdkWorkPool();
+
+	int getNumThreads() const { return (int)m_threads.size(); }
+
+	// from any thread, including from inside a task
+	void push(Task task);
+
+	// until every task pushed so far, and every task those pushed, has run
+	void wait();
+
+	// tasks taken off another worker's queue so far
+	long long getNumSteals() const { return m_numSteals.load(std::memory_order_relaxed); }
+
+protected:
+	struct Queue
+	{
+		std::mutex lock;
+		std::deque<Task> tasks;
+	};
+
+	void run(int self);
+	bool pop(int self, Task &task);
+
+	std::vector<std::unique_ptr<Queue>> m_queues;
+	std::vector<std::thread> m_threads;
+
+	std::atomic<int> m_queued;		// sitting in a queue
+	std::atomic<int> m_unfinished;	// pushed and not done yet
+	std::atomic<unsigned> m_nextQueue;
+	std::atomic<long long> m_numSteals;
+
+	std::mutex m_sleepLock;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	bool m_quit;
+
+private:
+	irsdkWorkPool(const irsdkWorkPool&);
+	irsdkWorkPool& operator=(const irsdkWorkPool&);
+};
+
+#endif // IRSDKWORKPOOL_H
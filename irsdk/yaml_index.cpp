@@ -0,0 +1,266 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <string.h>
+#include "yaml_parser.h"
+#include "yaml_index.h"
+
+void irsdkYamlIndex::clear()
+{
+	m_str = NULL;
+	m_nodes.clear();
+	m_children.clear();
+	m_stack.clear();
+}
+
+bool irsdkYamlIndex::build(const char *yaml)
+{
+	clear();
+
+	if(!yaml)
+		return false;
+
+	m_str = yaml;
+
+	Node root;
+	memset(&root, 0, sizeof(root));
+	root.depth = -1;
+	root.parent = -1;
+	m_nodes.push_back(root);
+	m_stack.push_back(0);
+
+	const char *p = yaml;
+	while(*p)
+	{
+		// indentation, list markers count towards it like they do in parseYaml()
+		const char *indent = p;
+		p = yaml_skipIndent(p);
+		const int depth = (int)(p - indent);
+		const bool isItem = depth && memchr(indent, '-', depth) != NULL;
+
+		const char *key = p;
+		p = yaml_findKeyEnd(p);
+
+		if(*p != ':')
+		{
+			// blank lines, the "---" and "..." document markers
+			while(*p == '\n' || *p == '\r')
+				p++;
+			continue;
+		}
+
+		const int keyLen = (int)(p - key);
+		p++;
+		while(*p == ' ')
+			p++;
+
+		const char *val = p;
+		p = yaml_findLineEnd(p);
+		const int valLen = (int)(p - val);
+		while(*p == '\n' || *p == '\r')
+			p++;
+
+		if(isItem)
+		{
+			// a new item closes the previous one at the same depth
+			while(m_nodes[m_stack.back()].depth >= depth)
+				m_stack.pop_back();
+
+			Node item;
+			memset(&item, 0, sizeof(item));
+			item.keyOfs = (int)(key - yaml);
+			item.valOfs = item.keyOfs;
+			item.depth = depth;
+			item.parent = m_stack.back();
+			item.isItem = true;
+			m_stack.push_back((int)m_nodes.size());
+			m_nodes.push_back(item);
+		}
+		else
+		{
+			// keys at the same depth as an open item belong to that item
+			while(m_nodes[m_stack.back()].depth > depth || (m_nodes[m_stack.back()].depth == depth && !m_nodes[m_stack.back()].isItem))
+				m_stack.pop_back();
+		}
+
+		Node n;
+		memset(&n, 0, sizeof(n));
+		n.keyOfs = (int)(key - yaml);
+		n.keyLen = keyLen;
+		n.valOfs = (int)(val - yaml);
+		n.valLen = valLen;
+		n.depth = depth;
+		n.endOfs = n.valOfs + valLen;
+		n.parent = m_stack.back();
+		m_stack.push_back((int)m_nodes.size());
+		m_nodes.push_back(n);
+	}
+
+	// lay the children out contiguously per parent, in document order, and
+	// extend every node over its children's lines
+	const int numNodes = (int)m_nodes.size();
+	for(int i=numNodes-1; i>0; i--)
+	{
+		Node &parent = m_nodes[m_nodes[i].parent];
+		parent.numChildren++;
+		if(parent.endOfs < m_nodes[i].endOfs)
+			parent.endOfs = m_nodes[i].endOfs;
+	}
+
+	int ofs = 0;
+	for(int i=0; i<numNodes; i++)
+	{
+		m_nodes[i].firstChild = ofs;
+		ofs += m_nodes[i].numChildren;
+		m_nodes[i].numChildren = 0;
+	}
+
+	m_children.resize(numNodes - 1);
+	for(int i=1; i<numNodes; i++)
+	{
+		Node &parent = m_nodes[m_nodes[i].parent];
+		m_children[parent.firstChild + parent.numChildren++] = i;
+	}
+
+	return true;
+}
+
+bool irsdkYamlIndex::keyEquals(const Node &n, const char *key, int keyLen) const
+{
+	return !n.isItem && n.keyLen == keyLen && 0 == strncmp(m_str + n.keyOfs, key, keyLen);
+}
+
+int irsdkYamlIndex::find(int node, const char *key, int keyLen, const char *val, int valLen) const
+{
+	const int numChildren = getNumChildren(node);
+	for(int i=0; i<numChildren; i++)
+	{
+		const int child = getChild(node, i);
+		const Node &n = m_nodes[child];
+
+		if(n.isItem)
+		{
+			const int found = find(child, key, keyLen, val, valLen);
+			if(found >= 0)
+				return found;
+		}
+		else if(keyEquals(n, key, keyLen))
+		{
+			if(!val || (n.valLen == valLen && 0 == strncmp(m_str + n.valOfs, val, valLen)))
+				return child;
+		}
+	}
+
+	return -1;
+}
+
+int irsdkYamlIndex::findPath(int node, const char *path) const
+{
+	if(!path)
+		return -1;
+
+	int found = -1;
+	while(*path && isValid(node))
+	{
+		const char *key = path;
+		while(*path && *path != ':')
+			path++;
+		const int keyLen = (int)(path - key);
+		if(*path == ':')
+			path++;
+
+		// optional {value} the key has to have
+		const char *val = NULL;
+		int valLen = 0;
+		if(*path == '{')
+		{
+			val = ++path;
+			while(*path && *path != '}')
+				path++;
+			valLen = (int)(path - val);
+			if(*path == '}')
+				path++;
+		}
+
+		found = find(node, key, keyLen, val, valLen);
+		if(found < 0)
+			return -1;
+
+		// keys without children carry on among their siblings, the way
+		// parseYaml() keeps going after a "CarIdx:{5}" match
+		node = m_nodes[found].numChildren ? found : m_nodes[found].parent;
+	}
+
+	return found;
+}
+
+bool irsdkYamlIndex::getVal(int node, const char **val, int *len) const
+{
+	if(!isValid(node) || node == 0 || m_nodes[node].isItem || !val || !len)
+		return false;
+
+	*val = m_str + m_nodes[node].valOfs;
+	*len = m_nodes[node].valLen;
+	return true;
+}
+
+unsigned long long irsdkYamlIndex::getHash(int node) const
+{
+	if(!isValid(node))
+		return 0;
+
+	const Node &n = m_nodes[node];
+	const unsigned long long h = hash(m_str + n.keyOfs, n.endOfs - n.keyOfs);
+	return h ? h : 1;
+}
+
+// 8 bytes per step, multiply and rotate mixing along the lines of xxHash.
+// Only ever compared against itself, so it does not need to match anything.
+unsigned long long irsdkYamlIndex::hash(const char *s, int len)
+{
+	const unsigned long long k1 = 0x9E3779B185EBCA87ULL;
+	const unsigned long long k2 = 0xC2B2AE3D27D4EB4FULL;
+
+	unsigned long long h = k2 ^ (unsigned long long)len;
+	while(len >= 8)
+	{
+		unsigned long long w;
+		memcpy(&w, s, 8);
+		h ^= w * k1;
+		h = ((h << 31) | (h >> 33)) * k2;
+		s += 8;
+		len -= 8;
+	}
+
+	unsigned long long w = 0;
+	memcpy(&w, s, len);
+	h ^= w * k1;
+	h = ((h << 31) | (h >> 33)) * k2;
+
+	h ^= h >> 29;
+	h *= k1;
+	h ^= h >> 32;
+	return h;
+}
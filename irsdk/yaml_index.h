@@ -0,0 +1,107 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef YAML_INDEX_H
+#define YAML_INDEX_H
+
+#include <stddef.h>
+#include <vector>
+
+// Offset tree over a whole session string, built in one pass. Where
+// parseYaml() rescans the string for every lookup, this tokenizes it once
+// and lookups walk the tree instead.
+//
+// Every "key: value" line is a node. A line starting with "- " also opens
+// a list item node (no key) that the keys of that item hang off, so
+// "Drivers:" has one child per driver and each of those has CarIdx,
+// UserName, ... as children. Nodes are numbered in document order, node 0
+// is the root.
+//
+// Offsets point into the string passed to build(), which has to stay
+// alive and unchanged for as long as the index is used.
+class irsdkYamlIndex
+{
+public:
+	struct Node
+	{
+		int keyOfs;
+		int keyLen;      // without the ':', 0 for list items and the root
+		int valOfs;
+		int valLen;      // raw, quotes included, same as parseYaml() returns
+		int depth;       // indentation, '-' counts as a space like in parseYaml()
+		int endOfs;      // end of the last line of this node and everything under it
+		int parent;
+		int firstChild;  // into the child table, see getChild()
+		int numChildren;
+		bool isItem;
+	};
+
+	irsdkYamlIndex() : m_str(NULL) { }
+
+	// storage is kept between builds, so re-indexing does not allocate in steady state
+	bool build(const char *yaml);
+	void clear();
+
+	const char *getStr() const { return m_str; }
+	int getNumNodes() const { return (int)m_nodes.size(); }
+	const Node &getNode(int node) const { return m_nodes[node]; }
+
+	int getRoot() const { return m_nodes.empty() ? -1 : 0; }
+	int getNumChildren(int node) const { return isValid(node) ? m_nodes[node].numChildren : 0; }
+	int getChild(int node, int i) const { return m_children[m_nodes[node].firstChild + i]; }
+
+	// key of a direct child, looking into list items too, -1 if not found.
+	// If val is given the value has to match as well.
+	int find(int node, const char *key, int keyLen, const char *val=NULL, int valLen=0) const;
+
+	// resolve a parseYaml() style path like "DriverInfo:Drivers:CarIdx:{5}UserName:"
+	// relative to node, -1 if not found
+	int findPath(int node, const char *path) const;
+
+	// value of a node, same pointer/length parseYaml() would hand out
+	bool getVal(int node, const char **val, int *len) const;
+
+	// hash of the text of a node and everything under it, to tell whether
+	// a section, list item etc. changed from one session string to the
+	// next. 0 for a node that does not exist.
+	unsigned long long getHash(int node) const;
+
+	static unsigned long long hash(const char *s, int len);
+
+protected:
+	bool isValid(int node) const { return node >= 0 && node < (int)m_nodes.size(); }
+	bool keyEquals(const Node &n, const char *key, int keyLen) const;
+
+	const char *m_str;
+	std::vector<Node> m_nodes;
+	std::vector<int> m_children;
+	std::vector<int> m_stack;
+
+private:
+	irsdkYamlIndex(const irsdkYamlIndex&);
+	irsdkYamlIndex& operator=(const irsdkYamlIndex&);
+};
+
+#endif // YAML_INDEX_H
@@ -26,7 +26,109 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
+#include "yaml_parser.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YAML_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+enum yaml_scan {
+	scan_lineEnd,
+	scan_keyEnd,
+	scan_indent
+};
+
+#ifdef YAML_HAVE_SSE2
+
+static inline int lowestBit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanForward(&idx, mask);
+	return (int)idx;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+static const int blockSize = 16;
+
+// one bit per byte of the block that ends the run
+static inline unsigned int stopMask(const char *p, yaml_scan what)
+{
+	const __m128i v = _mm_load_si128((const __m128i *)p);
+	if(what == scan_indent)
+	{
+		const __m128i indent = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('-')));
+		return ~(unsigned int)_mm_movemask_epi8(indent) & 0xFFFF;
+	}
+
+	__m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+	stop = _mm_or_si128(stop, _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+	if(what == scan_keyEnd)
+		stop = _mm_or_si128(stop, _mm_cmpeq_epi8(v, _mm_set1_epi8(':')));
+	return (unsigned int)_mm_movemask_epi8(stop);
+}
+
+// Loads are aligned to the block size so they never cross into the next
+// page, which makes reading past the terminating '\0' (always a stop) safe.
+static const char *scan(const char *s, yaml_scan what)
+{
+	const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)(blockSize - 1));
+	unsigned int mask = stopMask(p, what) & (~0u << (s - p));
+	while(!mask)
+	{
+		p += blockSize;
+		mask = stopMask(p, what);
+	}
+	return p + lowestBit(mask);
+}
+
+#else
+
+static const char *scan(const char *s, yaml_scan what)
+{
+	switch(what)
+	{
+	case scan_indent:
+		while(*s == ' ' || *s == '-')
+			s++;
+		break;
+	case scan_keyEnd:
+		while(*s && *s != ':' && *s != '\n' && *s != '\r')
+			s++;
+		break;
+	default:
+		while(*s && *s != '\n' && *s != '\r')
+			s++;
+		break;
+	}
+	return s;
+}
+
+#endif
+
+const char *yaml_findLineEnd(const char *s)
+{
+	return scan(s, scan_lineEnd);
+}
+
+const char *yaml_findKeyEnd(const char *s)
+{
+	return scan(s, scan_keyEnd);
+}
+
+const char *yaml_skipIndent(const char *s)
+{
+	return scan(s, scan_indent);
+}
 
 enum yaml_state {
 	space,
@@ -59,6 +161,32 @@ bool parseYaml(const char *data, const char* path, const char **val, int *len)
 
 		while(*data)
 		{
+			// Skip whole runs the state machine below would only count, the
+			// rest of the key or value and the indentation, in one go
+			if(state == value || state == key)
+			{
+				const char *end = (state == value) ? yaml_findLineEnd(data) : yaml_findKeyEnd(data);
+				if(state == value)
+					valuelen += (int)(end - data);
+				else
+					keylen += (int)(end - data);
+				data = end;
+				if(!*data)
+					break;
+			}
+			else if(state == space || state == newline)
+			{
+				const char *end = yaml_skipIndent(data);
+				if(end != data)
+				{
+					depth += (int)(end - data);
+					state = space;
+					data = end;
+					if(!*data)
+						break;
+				}
+			}
+
 			switch(*data)
 			{
 			case ' ':
@@ -109,7 +237,7 @@ bool parseYaml(const char *data, const char* path, const char **val, int *len)
 					{
 						return false;
 					}
-					else if(keylen && 0 == strncmp(keystr, pathptr, keylen))
+					else if(keylen && *keystr == *pathptr && 0 == strncmp(keystr, pathptr, keylen))
 					{
 						bool found = true;
 						//do we need to test the value?
@@ -174,3 +302,42 @@ bool parseYaml(const char *data, const char* path, const char **val, int *len)
 	return false;
 }
 
+
+bool irsdkYamlMemo::parse(const char *data, const char *path, const char **val, int *len)
+{
+	if(!data || !path || !val || !len)
+		return false;
+
+	if(data != m_data)
+	{
+		reset();
+		m_data = data;
+	}
+
+	auto it = m_spans.find(std::string_view(path));
+	if(it == m_spans.end())
+	{
+		Span span = { -1, 0 };
+		const char *tVal = NULL;
+		int tLen = 0;
+		if(parseYaml(data, path, &tVal, &tLen))
+		{
+			span.ofs = (int)(tVal - data);
+			span.len = tLen;
+		}
+		it = m_spans.emplace(path, span).first;
+	}
+
+	if(it->second.ofs < 0)
+		return false;
+
+	*val = data + it->second.ofs;
+	*len = it->second.len;
+	return true;
+}
+
+void irsdkYamlMemo::reset()
+{
+	m_data = NULL;
+	m_spans.clear();
+}
@@ -28,7 +28,52 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef YAML_PARSER_H
 #define YAML_PARSER_H
 
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
 // super simple YAML parser
 bool parseYaml(const char *data, const char* path, const char **val, int *len);
 
+// parseYaml() that remembers what it found for each path, including misses,
+// so asking for the same path in the same string again is a hash lookup.
+// Forgets everything when handed a different string pointer, call reset()
+// when the string at the same address changed.
+class irsdkYamlMemo
+{
+public:
+	bool parse(const char *data, const char *path, const char **val, int *len);
+	void reset();
+
+protected:
+	struct Span
+	{
+		int ofs; // into data, -1 if the path is not there
+		int len;
+	};
+
+	// looks up by string_view, so a hit does not build a std::string
+	struct PathHash
+	{
+		typedef void is_transparent;
+		size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+	};
+
+	const char *m_data = NULL;
+	std::unordered_map<std::string, Span, PathHash, std::equal_to<> > m_spans;
+};
+
+// Scanning primitives the parser and irsdkYamlIndex are built on. Each
+// returns the first character at or after s that ends the run, looking at
+// 16 bytes at a time where SSE2 is available. s must be '\0' terminated.
+
+// first '\n', '\r' or '\0'
+const char *yaml_findLineEnd(const char *s);
+
+// first ':', '\n', '\r' or '\0'
+const char *yaml_findKeyEnd(const char *s);
+
+// first character that is neither ' ' nor '-'
+const char *yaml_skipIndent(const char *s);
+
 #endif //YAML_PARSER_H
@@ -57,6 +57,7 @@ bool g_dbgOverlayEnabled;
     #include <chrono>
     
     //#define DEBUG_DUMP_VARS
+    //#define DEBUG_BENCH_VARS
 #endif
 using namespace Microsoft::WRL;
 using namespace std;
@@ -297,16 +298,20 @@ int main()
     g_dbgOverlayEnabled = g_cfg.getBool("OverlayDebug", "enabled", true);
 #endif
 
+    // Pull telemetry in on its own thread, so a slow frame doesn't make us miss sim ticks
+    irsdkClient::instance().startThread();
+
     ConnectionStatus  status   = ConnectionStatus::UNKNOWN;
     bool              uiEdit   = false;
     unsigned          frameCnt = 0;    
+    bool              quit     = false;
 #if defined(_DEBUG) or defined(DEBUG_OVERLAY_TIME)
     // Added in debug only for now
     std::chrono::steady_clock::time_point loopTimeStart, loopTimeEnd;
     long long loopTimeDiff;
 #endif
 
-    while( true )
+    while( !quit )
     {
         ConnectionStatus prevStatus       = status;
         SessionType      prevSessionType  = g_ir_session->sessionType;
@@ -329,6 +334,10 @@ int main()
 
 #if defined(_DEBUG) and defined(DEBUG_DUMP_VARS)
             ir_printVariables();
+#endif
+#if (defined(_DEBUG) or defined(DEBUG_OVERLAY_TIME)) and defined(DEBUG_BENCH_VARS)
+            ir_benchmarkVariables();
+            ir_benchmarkCarTable();
 #endif
         }
         
@@ -339,6 +348,9 @@ int main()
         }
 
         dbg( "connection status: %s, session type: %s, session state: %d, pace mode: %d, on track: %d, flags: 0x%X", ConnectionStatusStr[(int)status], SessionTypeStr[(int)g_ir_session->sessionType], ir_SessionState.getInt(), ir_PaceMode.getInt(), (int)ir_IsOnTrackCar.getBool(), ir_SessionFlags.getInt() );
+        dbg( "dropped ticks: %d", irsdkClient::instance().getDroppedTicks() );
+        dbg( "session parses: %d, coalesced: %d, cache loads: %d, parse: %.2f ms (max %.2f), latency: %.2f ms (max %.2f)", g_ir_sessionParseStats.numParsed.load(), g_ir_sessionParseStats.numCoalesced.load(), g_ir_sessionParseStats.numCacheLoads.load(),
+             g_ir_sessionParseStats.lastParseMs.load(), g_ir_sessionParseStats.maxParseMs.load(), g_ir_sessionParseStats.lastLatencyMs.load(), g_ir_sessionParseStats.maxLatencyMs.load() );
         
         // Update/render overlays
         {
@@ -374,6 +386,9 @@ int main()
         MSG msg = {};
         while(PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
         {
+            if( msg.message == WM_QUIT )
+                quit = true;
+
             // Handle hotkeys
             if( msg.message == WM_HOTKEY )
             {
@@ -464,6 +479,9 @@ int main()
 #endif
     }
 
+    // Background threads first, they use the session data and the sdk
+    ir_shutdown();
+
     for( Overlay* o : overlays )
         delete o;
 
@@ -0,0 +1,270 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+// Times what iRon does with the per-car variables every tick on a full,
+// multi-class field: reading them car by car through irsdkCVar, the way the
+// overlays used to, against copying each into a table once, the way
+// ir_updateCarTable() does. The line comes from irsdkSimField through a
+// producer in this process, so nothing else has to be running.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <span>
+#include <string>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_client.h"
+#include "../irsdk/yaml_parser.h"
+#include "irsdk_producer.h"
+#include "irsdk_sessionstr.h"
+#include "irsdk_simfield.h"
+
+// same as the sim, see IR_MAX_CARS
+static const int MAX_CARS = 64;
+
+// the per-car variables the CarTable in iracing.h holds
+static irsdkCVar g_classPosition( "CarIdxClassPosition" );
+static irsdkCVar g_overallPosition( "CarIdxPosition" );
+static irsdkCVar g_classId( "CarIdxClass" );
+static irsdkCVar g_lap( "CarIdxLap" );
+static irsdkCVar g_lapCompleted( "CarIdxLapCompleted" );
+static irsdkCVar g_lapDistPct( "CarIdxLapDistPct" );
+static irsdkCVar g_estTime( "CarIdxEstTime" );
+static irsdkCVar g_f2Time( "CarIdxF2Time" );    // not simulated, reads as 0 like any variable the sim leaves out
+static irsdkCVar g_lastLapTime( "CarIdxLastLapTime" );
+static irsdkCVar g_bestLapTime( "CarIdxBestLapTime" );
+static irsdkCVar g_trackSurface( "CarIdxTrackSurface" );
+static irsdkCVar g_onPitRoad( "CarIdxOnPitRoad" );
+
+// same layout as the CarTable in iracing.h
+struct CarTable
+{
+    int     position[MAX_CARS];
+    int     classId[MAX_CARS];
+    int     classPosition[MAX_CARS];
+    int     overallPosition[MAX_CARS];
+    int     lap[MAX_CARS];
+    int     lapCompleted[MAX_CARS];
+    float   lapDistPct[MAX_CARS];
+    float   estTime[MAX_CARS];
+    float   f2Time[MAX_CARS];
+    float   lastLapTime[MAX_CARS];
+    float   bestLapTime[MAX_CARS];
+    int     trackSurface[MAX_CARS];
+    bool    onPitRoad[MAX_CARS];
+};
+
+// what the session string has for each car, where the position and class
+// fall back to when the sim has nothing, like ir_resolvePosition() does
+struct SessionCar
+{
+    int     classId;
+    int     racePosition;
+};
+static SessionCar g_sessionCars[MAX_CARS];
+
+static int resolvePosition( int classPosition, const SessionCar& car )
+{
+    return classPosition > 0 ? classPosition : car.racePosition;
+}
+
+static int resolveClassId( int carClass, const SessionCar& car )
+{
+    return carClass > 0 ? carClass : car.classId;
+}
+
+template<typename T>
+static void copyCarVar( irsdkCVar& var, T (&dst)[MAX_CARS] )
+{
+    const std::span<const T> src = var.span<T>();
+    const int n = (int)std::min<size_t>( MAX_CARS, src.size() );
+    std::copy_n( src.begin(), n, dst );
+    std::fill( dst + n, dst + MAX_CARS, T() );
+}
+
+static void buildCarTable( CarTable& t )
+{
+    copyCarVar( g_classPosition, t.classPosition );
+    copyCarVar( g_overallPosition, t.overallPosition );
+    copyCarVar( g_classId, t.classId );
+    copyCarVar( g_lap, t.lap );
+    copyCarVar( g_lapCompleted, t.lapCompleted );
+    copyCarVar( g_lapDistPct, t.lapDistPct );
+    copyCarVar( g_estTime, t.estTime );
+    copyCarVar( g_f2Time, t.f2Time );
+    copyCarVar( g_lastLapTime, t.lastLapTime );
+    copyCarVar( g_bestLapTime, t.bestLapTime );
+    copyCarVar( g_trackSurface, t.trackSurface );
+    copyCarVar( g_onPitRoad, t.onPitRoad );
+
+    for( int carIdx=0; carIdx<MAX_CARS; ++carIdx )
+    {
+        t.position[carIdx] = resolvePosition( t.classPosition[carIdx], g_sessionCars[carIdx] );
+        t.classId[carIdx] = resolveClassId( t.classId[carIdx], g_sessionCars[carIdx] );
+    }
+}
+
+static void usage()
+{
+    printf( "Usage: irsdk_carbench [options]\n" );
+    printf( "  --cars <n>          cars on track, 1-64 (default 64)\n" );
+    printf( "  --classes <n>       car classes the field is split into (default 4)\n" );
+    printf( "  --iterations <n>    ticks to time per method (default 20000)\n" );
+}
+
+int main( int argc, char** argv )
+{
+    int numCars    = MAX_CARS;
+    int numClasses = 4;
+    int iterations = 20000;
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool hasArg = i+1 < argc;
+        if( !strcmp(argv[i],"--cars") && hasArg )
+            numCars = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--classes") && hasArg )
+            numClasses = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--iterations") && hasArg )
+            iterations = atoi( argv[++i] );
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if( numCars < 1 || numCars > MAX_CARS || numClasses < 1 || iterations < 1 ) {
+        usage();
+        return 1;
+    }
+
+    // One line of a field a few laps in, published like the simulator does
+    irsdkSimField field( numCars, numClasses );
+    irsdkProducer producer;
+    const std::string sessionStr = irsdk_makeSessionStr( numCars, numClasses, 1 );
+    if( !producer.open( field.getVarHeaders(), field.getNumVars(), 60, 512*1024 ) )
+        return 1;
+    producer.setSessionStr( sessionStr.c_str(), (int)sessionStr.size() );
+    for( int tick=0; tick<60*300; ++tick ) {
+        field.step( producer.beginLine(), producer.getTickCount(), 1.0/60 );
+        producer.endLine();
+    }
+
+    irsdkClient& irsdk = irsdkClient::instance();
+    // the client only takes a line that is newer than what it found when it connected
+    for( int i=0; i<100 && !(irsdk.isConnected() && irsdk.getData()); ++i ) {
+        field.step( producer.beginLine(), producer.getTickCount(), 1.0/60 );
+        producer.endLine();
+        irsdk.waitForData( 0 );
+    }
+    if( !irsdk.isConnected() || !g_lapDistPct.isValid() ) {
+        printf( "Could not read back the simulated line\n" );
+        producer.close();
+        return 1;
+    }
+
+    for( int carIdx=0; carIdx<numCars; ++carIdx )
+    {
+        char path[128];
+        const char* val = nullptr;
+        int len = 0;
+        snprintf( path, sizeof(path), "DriverInfo:Drivers:CarIdx:{%d}CarClassID:", carIdx );
+        if( parseYaml( sessionStr.c_str(), path, &val, &len ) )
+            g_sessionCars[carIdx].classId = atoi( val );
+        snprintf( path, sizeof(path), "SessionInfo:Sessions:SessionNum:{0}ResultsPositions:CarIdx:{%d}Position:", carIdx );
+        if( parseYaml( sessionStr.c_str(), path, &val, &len ) )
+            g_sessionCars[carIdx].racePosition = atoi( val );
+    }
+
+    using clock = std::chrono::steady_clock;
+    volatile float sink = 0;
+
+    auto timeIt = [&]( const char* name, auto&& fn ) {
+        // untimed first, so whichever runs first doesn't pay for a cold cache and a slow clock
+        for( int i=0; i<iterations/4; ++i )
+            fn();
+        const clock::time_point start = clock::now();
+        for( int i=0; i<iterations; ++i )
+            fn();
+        const double ns = std::chrono::duration<double,std::nano>( clock::now() - start ).count();
+        printf( "    %-36s %8.0f ns/tick\n", name, ns / iterations );
+        return ns / iterations;
+    };
+
+    printf( "Per-car variables, %d cars in %d classes, %d iterations:\n", numCars, numClasses, iterations );
+
+    // every value of every car once, as the overlays read them before the table
+    const double perCarNs = timeIt( "per-car irsdkCVar::getInt/getFloat()", [&]() {
+        for( int i=0; i<MAX_CARS; ++i )
+            sink = sink + (float)resolvePosition( g_classPosition.getInt(i), g_sessionCars[i] )
+                + (float)resolveClassId( g_classId.getInt(i), g_sessionCars[i] ) + (float)g_overallPosition.getInt(i)
+                + (float)g_lap.getInt(i) + (float)g_lapCompleted.getInt(i) + g_lapDistPct.getFloat(i)
+                + g_estTime.getFloat(i) + g_f2Time.getFloat(i) + g_lastLapTime.getFloat(i)
+                + g_bestLapTime.getFloat(i) + (float)g_trackSurface.getInt(i) + (float)g_onPitRoad.getBool(i);
+    } );
+
+    timeIt( "per-car irsdkCVar::get<T>()", [&]() {
+        for( int i=0; i<MAX_CARS; ++i )
+            sink = sink + (float)resolvePosition( g_classPosition.get<int>(i), g_sessionCars[i] )
+                + (float)resolveClassId( g_classId.get<int>(i), g_sessionCars[i] ) + (float)g_overallPosition.get<int>(i)
+                + (float)g_lap.get<int>(i) + (float)g_lapCompleted.get<int>(i) + g_lapDistPct.get<float>(i)
+                + g_estTime.get<float>(i) + g_f2Time.get<float>(i) + g_lastLapTime.get<float>(i)
+                + g_bestLapTime.get<float>(i) + (float)g_trackSurface.get<int>(i) + (float)g_onPitRoad.get<bool>(i);
+    } );
+
+    static CarTable table;
+    const double tableNs = timeIt( "CarTable build", [&]() {
+        buildCarTable( table );
+        sink = sink + table.lapDistPct[MAX_CARS-1];
+    } );
+
+    // and then reading it all back, which is what the overlays do with it
+    timeIt( "CarTable build and read", [&]() {
+        buildCarTable( table );
+        for( int i=0; i<MAX_CARS; ++i )
+            sink = sink + (float)table.position[i] + (float)table.classId[i] + (float)table.overallPosition[i]
+                + (float)table.lap[i] + (float)table.lapCompleted[i] + table.lapDistPct[i]
+                + table.estTime[i] + table.f2Time[i] + table.lastLapTime[i]
+                + table.bestLapTime[i] + (float)table.trackSurface[i] + (float)table.onPitRoad[i];
+    } );
+
+    // the table has to agree with reading the variables directly
+    buildCarTable( table );
+    int mismatches = 0;
+    for( int i=0; i<MAX_CARS; ++i )
+        if( table.position[i] != resolvePosition( g_classPosition.getInt(i), g_sessionCars[i] )
+            || table.classId[i] != resolveClassId( g_classId.getInt(i), g_sessionCars[i] )
+            || table.lap[i] != g_lap.getInt(i) || table.lapDistPct[i] != g_lapDistPct.getFloat(i)
+            || table.bestLapTime[i] != g_bestLapTime.getFloat(i) || table.onPitRoad[i] != g_onPitRoad.getBool(i) )
+            mismatches++;
+
+    printf( "CarTable is %.1fx faster than per-car reads, %d of %d cars differ\n", perCarNs / tableNs, mismatches, MAX_CARS );
+
+    irsdk.stopThread();
+    producer.close();
+    return mismatches ? 1 : 0;
+}
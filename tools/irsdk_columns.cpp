@@ -0,0 +1,220 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Per channel queries over a .ibt, once reading every line and once off the
+// columnar sidecar irsdkColumnFile writes next to it, and checks both agree.
+// Splits the file into laps by the lap channel and reports, per lap, the
+// first, last, min and max of the other one: SessionTime gives lap times,
+// FuelLevel the fuel used per lap.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_diskclient.h"
+#include "../irsdk/irsdk_columns.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static void usage()
+{
+    printf( "Usage: irsdk_columns <file.ibt> [options]\n" );
+    printf( "  --channel <name>  variable to summarize per lap (default FuelLevel)\n" );
+    printf( "  --lap <name>      variable that counts the laps (default Lap)\n" );
+    printf( "  --out <file>      sidecar to use or write (default <file.ibt>.columns)\n" );
+    printf( "  --rebuild         write the sidecar even if it is current\n" );
+}
+
+static double secondsSince( Clock::time_point t0 )
+{
+    return std::chrono::duration<double>( Clock::now() - t0 ).count();
+}
+
+struct LapStats
+{
+    int    lap      = 0;
+    int    numLines = 0;
+    double first    = 0;
+    double last     = 0;
+    double min      = 0;
+    double max      = 0;
+
+    bool operator==( const LapStats& o ) const = default;
+};
+
+// feed lines in order, a new lap starts whenever the lap channel changes
+struct LapSplitter
+{
+    std::vector<LapStats> laps;
+
+    void add( int lap, double v )
+    {
+        if( laps.empty() || laps.back().lap != lap )
+            laps.push_back( { lap, 0, v, v, v, v } );
+
+        LapStats& s = laps.back();
+        s.numLines++;
+        s.last = v;
+        s.min  = std::min( s.min, v );
+        s.max  = std::max( s.max, v );
+    }
+};
+
+// the same off the columns, a lap at a time over the contiguous slice it covers
+template<class T, class L>
+static void splitColumns( std::span<const L> lapCol, std::span<const T> col, LapSplitter& out )
+{
+    const size_t n = lapCol.size();
+    for( size_t begin=0; begin<n; )
+    {
+        size_t end = begin + 1;
+        while( end < n && lapCol[end] == lapCol[begin] )
+            end++;
+
+        const auto mm = std::minmax_element( col.begin() + begin, col.begin() + end );
+        out.laps.push_back( { (int)lapCol[begin], (int)(end - begin), (double)col[begin], (double)col[end-1], (double)*mm.first, (double)*mm.second } );
+        begin = end;
+    }
+}
+
+template<class L>
+static bool splitColumns( const irsdkColumnFile& cols, int lapIdx, int idx, LapSplitter& out )
+{
+    const std::span<const L> lapCol = cols.getColumn<L>( lapIdx );
+    switch( cols.getVarHeader(idx)->type )
+    {
+    case irsdk_char:
+    case irsdk_bool:     splitColumns( lapCol, cols.getColumn<char>( idx ), out ); return true;
+    case irsdk_int:
+    case irsdk_bitField: splitColumns( lapCol, cols.getColumn<int>( idx ), out ); return true;
+    case irsdk_float:    splitColumns( lapCol, cols.getColumn<float>( idx ), out ); return true;
+    case irsdk_double:   splitColumns( lapCol, cols.getColumn<double>( idx ), out ); return true;
+    }
+    return false;
+}
+
+int main( int argc, char** argv )
+{
+    const char* path    = nullptr;
+    const char* channel = "FuelLevel";
+    const char* lapName = "Lap";
+    std::string outPath;
+    bool        rebuild = false;
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool hasArg = i+1 < argc;
+        if( !strcmp(argv[i],"--channel") && hasArg )
+            channel = argv[++i];
+        else if( !strcmp(argv[i],"--lap") && hasArg )
+            lapName = argv[++i];
+        else if( !strcmp(argv[i],"--out") && hasArg )
+            outPath = argv[++i];
+        else if( !strcmp(argv[i],"--rebuild") )
+            rebuild = true;
+        else if( argv[i][0] != '-' && !path )
+            path = argv[i];
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if( !path ) {
+        usage();
+        return 1;
+    }
+    if( outPath.empty() )
+        outPath = std::string( path ) + ".columns";
+
+    irsdkDiskClient ibt;
+    if( !ibt.openFile( path ) ) {
+        printf( "Could not open %s\n", path );
+        return 1;
+    }
+
+    const int idx    = ibt.getVarIdx( channel );
+    const int lapIdx = ibt.getVarIdx( lapName );
+    if( idx < 0 || lapIdx < 0 ) {
+        printf( "%s has no %s\n", path, idx < 0 ? channel : lapName );
+        return 1;
+    }
+    const irsdk_VarType lapType = ibt.getVarType( lapIdx );
+    if( lapType != irsdk_int && lapType != irsdk_bitField ) {
+        printf( "%s is not an int\n", lapName );
+        return 1;
+    }
+
+    const double mb = (double)ibt.getRecordCount() * ibt.getHeader()->bufLen / (1024 * 1024);
+    printf( "%s: %d lines, %d variables, %.0f MB\n", path, ibt.getRecordCount(), ibt.getNumVars(), mb );
+
+    irsdkColumnFile cols;
+    if( rebuild || !cols.open( outPath.c_str() ) || !cols.isCurrent( ibt ) )
+    {
+        cols.close();
+        Clock::time_point t0 = Clock::now();
+        if( !irsdkColumnFile::transcode( ibt, outPath.c_str() ) || !cols.open( outPath.c_str() ) ) {
+            printf( "Could not write %s\n", outPath.c_str() );
+            return 1;
+        }
+        const double sec = secondsSince( t0 );
+        printf( "transcoded to %s in %.1f ms, %.0f MB/s\n", outPath.c_str(), sec * 1000, mb / sec );
+    }
+    else
+        printf( "using %s\n", outPath.c_str() );
+
+    // every line
+    Clock::time_point t0 = Clock::now();
+    LapSplitter rows;
+    while( ibt.getNextData() )
+        rows.add( ibt.getVarInt( lapIdx ), ibt.getVarDouble( idx ) );
+    const double rowSec = secondsSince( t0 );
+
+    // two columns, the first time round that includes faulting their pages in
+    double colSec[2];
+    LapSplitter columns;
+    for( int pass=0; pass<2; ++pass )
+    {
+        t0 = Clock::now();
+        columns.laps.clear();
+        splitColumns<int>( cols, cols.getVarIdx( lapName ), cols.getVarIdx( channel ), columns );
+        colSec[pass] = secondsSince( t0 );
+    }
+
+    const double colMb = (double)cols.getNumRecords() * (irsdk_VarTypeBytes[ibt.getVarType( idx )] + 4) / (1024 * 1024);
+    printf( "rows           %8.2f ms\n", rowSec * 1000 );
+    printf( "columns        %8.2f ms  %8.0f MB/s of the two columns, %.0fx\n", colSec[0] * 1000, colMb / colSec[0], rowSec / colSec[0] );
+    printf( "columns again  %8.2f ms  %8.0f MB/s of the two columns, %.0fx\n", colSec[1] * 1000, colMb / colSec[1], rowSec / colSec[1] );
+
+    printf( "%-6s %8s %12s %12s %12s %12s %12s\n", lapName, "lines", "first", "last", "first-last", "min", "max" );
+    for( const LapStats& s : columns.laps )
+        printf( "%-6d %8d %12.4f %12.4f %12.4f %12.4f %12.4f\n", s.lap, s.numLines, s.first, s.last, s.first - s.last, s.min, s.max );
+
+    const bool ok = rows.laps == columns.laps;
+    printf( ok ? "Rows and columns agree\n" : "Rows and columns DIFFER\n" );
+    return ok ? 0 : 1;
+}
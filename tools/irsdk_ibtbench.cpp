@@ -0,0 +1,250 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Times reading a .ibt through irsdkDiskClient's FILE* path against the
+// mapped one: a sequential pass, random lines, walking backwards and several
+// cursors at once, and checks every way reads the same values. --generate
+// writes a synthetic file of the given size to try it on, endurance
+// recordings run to several GB.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_diskclient.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static void usage()
+{
+    printf( "Usage: irsdk_ibtbench <file.ibt> [options]\n" );
+    printf( "  --generate <mb>  write a synthetic file of about this size first\n" );
+    printf( "  --random <n>     random lines to read (default 100000)\n" );
+    printf( "  --cursors <n>    threads walking the mapping at once (default 4)\n" );
+}
+
+static double secondsSince( Clock::time_point t0 )
+{
+    return std::chrono::duration<double>( Clock::now() - t0 ).count();
+}
+
+// roughly what the sim logs: a few hundred scalars plus the CarIdx arrays
+static bool generate( const char* path, double mb )
+{
+    irsdkDiskWriter ibt;
+    if( !ibt.openFile( path ) )
+        return false;
+
+    char name[32];
+    for( int i=0; i<200; ++i ) {
+        snprintf( name, sizeof(name), "Var%d", i );
+        ibt.addNewVariable( name, "", "", i % 4 ? irsdk_float : irsdk_double );
+    }
+    for( int i=0; i<8; ++i ) {
+        snprintf( name, sizeof(name), "CarIdxVar%d", i );
+        ibt.addNewVariable( name, "", "", irsdk_float, 64 );
+    }
+    ibt.addNewVariable( "Lap", "", "", irsdk_int );
+    ibt.finalizeHeader();
+
+    const int bufLen = 150 * 4 + 50 * 8 + 8 * 64 * 4 + 4;
+    const long long lines = (long long)(mb * 1024 * 1024 / bufLen);
+    for( long long line=0; line<lines; ++line )
+    {
+        for( int i=0; i<200; ++i )
+            ibt.setVar( (double)(line * 200 + i), i );
+        for( int i=0; i<8; ++i )
+            for( int car=0; car<64; ++car )
+                ibt.setVar( (float)(line + car), 200 + i, car );
+        ibt.setVar( (int)(line / 5000), "Lap" );
+        ibt.writeLine();
+    }
+    printf( "Wrote %lld lines of %d bytes to %s\n", lines, bufLen, path );
+    return true;
+}
+
+// what a consumer of every line would do, sum a handful of variables
+struct Sum
+{
+    double v = 0;
+    template<class Reader> void add( Reader& r, const std::vector<int>& vars )
+    {
+        for( int idx : vars )
+            v += r.getVarDouble( idx );
+    }
+};
+
+int main( int argc, char** argv )
+{
+    const char* path       = nullptr;
+    double      generateMb = 0;
+    int         numRandom  = 100000;
+    int         numCursors = 4;
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool hasArg = i+1 < argc;
+        if( !strcmp(argv[i],"--generate") && hasArg )
+            generateMb = atof( argv[++i] );
+        else if( !strcmp(argv[i],"--random") && hasArg )
+            numRandom = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--cursors") && hasArg )
+            numCursors = atoi( argv[++i] );
+        else if( argv[i][0] != '-' && !path )
+            path = argv[i];
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if( !path || numRandom < 0 || numCursors < 1 ) {
+        usage();
+        return 1;
+    }
+
+    if( generateMb > 0 && !generate( path, generateMb ) ) {
+        printf( "Could not write %s\n", path );
+        return 1;
+    }
+
+    irsdkDiskClient fileIbt, mapIbt;
+    if( !fileIbt.openFile( path, false ) || !mapIbt.openFile( path, true ) ) {
+        printf( "Could not open %s\n", path );
+        return 1;
+    }
+    if( !mapIbt.isMapped() )
+        printf( "Warning: could not map %s, both runs read through FILE*\n", path );
+
+    const int    numLines = mapIbt.getRecordCount();
+    const double mb       = (double)numLines * mapIbt.getHeader()->bufLen / (1024 * 1024);
+    printf( "%s: %d lines, %d variables, %d bytes per line, %.0f MB\n", path, numLines, mapIbt.getNumVars(), mapIbt.getHeader()->bufLen, mb );
+
+    // every 16th variable, both scalars and arrays
+    std::vector<int> vars;
+    for( int i=0; i<mapIbt.getNumVars(); i+=16 )
+        vars.push_back( i );
+
+    bool ok = true;
+    auto check = []( const char* what, double a, double b ) {
+        if( a != b )
+            printf( "MISMATCH %s: %f != %f\n", what, a, b );
+        return a == b;
+    };
+
+    // sequential
+    Clock::time_point t0 = Clock::now();
+    Sum fileSeq;
+    while( fileIbt.getNextData() )
+        fileSeq.add( fileIbt, vars );
+    const double fileSeqSec = secondsSince( t0 );
+
+    t0 = Clock::now();
+    Sum mapSeq;
+    while( mapIbt.getNextData() )
+        mapSeq.add( mapIbt, vars );
+    const double mapSeqSec = secondsSince( t0 );
+
+    printf( "sequential  fread %8.1f ms %8.0f MB/s   mapped %8.1f ms %8.0f MB/s\n",
+        fileSeqSec * 1000, mb / fileSeqSec, mapSeqSec * 1000, mb / mapSeqSec );
+    ok &= check( "sequential", fileSeq.v, mapSeq.v );
+
+    // random lines
+    std::vector<int> lines( numLines ? numRandom : 0 );
+    std::mt19937 rng( 1234 );
+    for( int& line : lines )
+        line = (int)(rng() % numLines);
+
+    mapIbt.setAccessHint( irsdkFileMap::Access_Random );
+
+    t0 = Clock::now();
+    Sum fileRnd;
+    for( int line : lines )
+        if( fileIbt.readData( line ) )
+            fileRnd.add( fileIbt, vars );
+    const double fileRndSec = secondsSince( t0 );
+
+    t0 = Clock::now();
+    Sum mapRnd;
+    irsdkDiskCursor cursor( mapIbt );
+    for( int line : lines )
+        if( cursor.seek( line ) )
+            mapRnd.add( cursor, vars );
+    const double mapRndSec = secondsSince( t0 );
+
+    printf( "random      fread %8.1f ms %8.2f us/line  mapped %8.1f ms %8.2f us/line\n",
+        fileRndSec * 1000, lines.empty() ? 0 : fileRndSec * 1e6 / lines.size(), mapRndSec * 1000, lines.empty() ? 0 : mapRndSec * 1e6 / lines.size() );
+    ok &= check( "random", fileRnd.v, mapRnd.v );
+
+    // backwards, which the FILE* path can only do by seeking for every line
+    mapIbt.setAccessHint( irsdkFileMap::Access_Normal );
+
+    t0 = Clock::now();
+    Sum mapRev;
+    cursor.seek( numLines - 1 );
+    do
+        mapRev.add( cursor, vars );
+    while( numLines && cursor.prev() );
+    const double mapRevSec = secondsSince( t0 );
+
+    printf( "backwards   mapped %8.1f ms %8.0f MB/s\n", mapRevSec * 1000, mb / mapRevSec );
+    ok &= check( "backwards", mapSeq.v, mapRev.v );
+
+    // several cursors over the one mapping, each with a slice of the file
+    t0 = Clock::now();
+    std::vector<Sum> sums( numCursors );
+    std::vector<std::thread> threads;
+    for( int t=0; t<numCursors; ++t )
+    {
+        threads.emplace_back( [&, t]() {
+            irsdkDiskCursor c( mapIbt );
+            const int end = (int)((long long)numLines * (t + 1) / numCursors);
+            if( !c.seek( (int)((long long)numLines * t / numCursors) ) )
+                return;
+            do
+                sums[t].add( c, vars );
+            while( c.getRecordIdx() + 1 < end && c.next() );
+        } );
+    }
+    for( std::thread& th : threads )
+        th.join();
+    const double mapParSec = secondsSince( t0 );
+
+    double mapPar = 0;
+    for( const Sum& s : sums )
+        mapPar += s.v;
+    printf( "%d cursors   mapped %8.1f ms %8.0f MB/s\n", numCursors, mapParSec * 1000, mb / mapParSec );
+    // summed in a different order, so only close
+    const double tolerance = 1e-9 * (mapSeq.v < 0 ? -mapSeq.v : mapSeq.v);
+    if( mapPar - mapSeq.v > tolerance || mapSeq.v - mapPar > tolerance ) {
+        printf( "MISMATCH cursors: %f != %f\n", mapPar, mapSeq.v );
+        ok = false;
+    }
+
+    printf( ok ? "All reads agree\n" : "Reads DIFFER\n" );
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+// Runs irsdkClient against whatever is producing live data (the sim, or
+// irsdk_simulator) and reports how well it keeps up.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_client.h"
+
+// same as the sim, see IR_MAX_CARS
+static const int MAX_CARS = 64;
+
+static irsdkCVar ir_SessionTick( "SessionTick" );
+static irsdkCVar ir_SimulatorClock( "SimulatorClock" );
+static irsdkCVar ir_CarIdxLapDistPct( "CarIdxLapDistPct" );
+
+static void usage()
+{
+    printf( "Usage: irsdk_loadtest [options]\n" );
+    printf( "  --seconds <s>     how long to run (default 10)\n" );
+    printf( "  --thread          ingest on a thread of its own\n" );
+    printf( "  --subscribe       only copy the variables we read\n" );
+    printf( "  --catchup         read every line in order\n" );
+    printf( "  --work <ms>       simulated render time per frame (default 0)\n" );
+}
+
+int main( int argc, char** argv )
+{
+    double seconds   = 10;
+    bool   useThread = false;
+    bool   subscribe = false;
+    bool   catchUp   = false;
+    double workMs    = 0;
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool hasArg = i+1 < argc;
+        if( !strcmp(argv[i],"--seconds") && hasArg )
+            seconds = atof( argv[++i] );
+        else if( !strcmp(argv[i],"--thread") )
+            useThread = true;
+        else if( !strcmp(argv[i],"--subscribe") )
+            subscribe = true;
+        else if( !strcmp(argv[i],"--catchup") )
+            catchUp = true;
+        else if( !strcmp(argv[i],"--work") && hasArg )
+            workMs = atof( argv[++i] );
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    irsdkClient& irsdk = irsdkClient::instance();
+    irsdk.setSubscriptionMode( subscribe );
+    irsdk.setCatchUpMode( catchUp );
+    if( useThread )
+        irsdk.startThread();
+
+    using clock = std::chrono::steady_clock;
+
+    printf( "Waiting for data...\n" );
+    while( !irsdk.isConnected() )
+        irsdk.waitForData( 100 );
+
+    std::vector<double> latencies;
+    long long frames = 0, snapshots = 0, queued = 0, tickGaps = 0, dirtyVars = 0, unchanged = 0;
+    int lastTick = -1;
+    const int startDropped = irsdk.getDroppedTicks();
+    volatile float sink = 0;
+
+    const clock::time_point start = clock::now();
+    while( std::chrono::duration<double>(clock::now() - start).count() < seconds && irsdk.isConnected() )
+    {
+        frames++;
+        if( irsdk.waitForData(16) )
+        {
+            snapshots++;
+
+            // what the change tracking saw
+            if( !irsdk.isAnyVarDirty() )
+                unchanged++;
+            for( int i=0, n=irsdk_getHeader() ? irsdk_getHeader()->numVars : 0; i<n; ++i )
+                dirtyVars += irsdk.isVarDirty( i );
+
+            // how old the line is by the time we get to see it
+            if( ir_SimulatorClock.isValid() ) {
+                const double now = std::chrono::duration<double>( clock::now().time_since_epoch() ).count();
+                latencies.push_back( now - ir_SimulatorClock.getDouble() );
+            }
+
+            // ticks we never got to look at, either on the queue or as the current line
+            const char* line = irsdk.popQueuedData();
+            if( !line && !catchUp )
+                line = irsdk.getData();
+            for( ; line; line = catchUp ? irsdk.popQueuedData() : nullptr )
+            {
+                const int tick = ir_SessionTick.get<int>( line );
+                if( lastTick >= 0 && tick > lastTick+1 )
+                    tickGaps += tick - lastTick - 1;
+                lastTick = std::max( lastTick, tick );
+                if( catchUp )
+                    queued++;
+            }
+
+            // touch a typical amount of data
+            for( int i=0; i<MAX_CARS; ++i )
+                sink = sink + ir_CarIdxLapDistPct.getFloat( i );
+        }
+
+        if( workMs > 0 )
+            std::this_thread::sleep_for( std::chrono::duration<double,std::milli>(workMs) );
+    }
+    const double elapsed = std::chrono::duration<double>( clock::now() - start ).count();
+
+    irsdk.stopThread();
+
+    printf( "mode: %s%s%s, work %.1f ms/frame\n", useThread ? "thread" : "inline", subscribe ? " subscribe" : "", catchUp ? " catchup" : "", workMs );
+    printf( "frames:      %lld (%.1f/s)\n", frames, frames/elapsed );
+    printf( "snapshots:   %lld (%.1f/s)\n", snapshots, snapshots/elapsed );
+    if( catchUp )
+        printf( "queued:      %lld (%.1f/s)\n", queued, queued/elapsed );
+    printf( "tick gaps:   %lld\n", tickGaps );
+    printf( "dirty vars:  %.1f per snapshot, %lld snapshots unchanged\n", snapshots ? (double)dirtyVars/snapshots : 0.0, unchanged );
+    printf( "dropped:     %d\n", irsdk.getDroppedTicks() - startDropped );
+    if( !latencies.empty() )
+    {
+        std::sort( latencies.begin(), latencies.end() );
+        double sum = 0;
+        for( double l : latencies )
+            sum += l;
+        printf( "latency:     avg %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            1000*sum/latencies.size(), 1000*latencies[latencies.size()*99/100], 1000*latencies.back() );
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Rewrites a .ibt as a compressed one, see irsdk/irsdk_pack.h, checks every
+// line reads back the same and times decoding it on one thread against
+// cursors decoding blocks side by side on several.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_diskclient.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static void usage()
+{
+    printf( "Usage: irsdk_pack <in.ibt> <out.ibt> [options]\n" );
+    printf( "  --block <n>    lines per block (default %d)\n", IRSDK_PACK_BLOCK_RECORDS );
+    printf( "  --threads <n>  decoding threads (default all cores)\n" );
+}
+
+static double secondsSince( Clock::time_point t0 )
+{
+    return std::chrono::duration<double>( Clock::now() - t0 ).count();
+}
+
+static long long fileBytes( const char* path )
+{
+    FILE* f = fopen( path, "rb" );
+    if( !f )
+        return 0;
+#ifdef _WIN32
+    _fseeki64( f, 0, SEEK_END );
+    const long long size = _ftelli64( f );
+#else
+    fseeko( f, 0, SEEK_END );
+    const long long size = (long long)ftello( f );
+#endif
+    fclose( f );
+    return size;
+}
+
+static bool copyFile( irsdkDiskClient& in, const char* outPath, int blockRecords )
+{
+    irsdkDiskWriter* out = new irsdkDiskWriter();  // too big for the stack
+    bool ok = out->openFile( outPath, true, blockRecords );
+
+    const int numVars = in.getNumVars();
+    for( int i=0; ok && i<numVars; ++i )
+        ok = out->addNewVariable( in.getVarName(i), in.getVarDesc(i), in.getVarUnit(i), in.getVarType(i), in.getVarCount(i) ) == i;
+
+    if( ok )
+    {
+        const irsdk_diskSubHeader* sub = in.getDiskSubHeader();
+        out->setSessionStr( in.getSessionStr() );
+        out->setSessionStartDate( sub->sessionStartDate );
+        out->setSessionStartTime_s( sub->sessionStartTime );
+        out->setSessionEndTime_s( sub->sessionEndTime );
+        out->setSessionLapCount( sub->sessionLapCount );
+        out->finalizeHeader();
+
+        // the writer packs the variables without gaps, so copy them one by one
+        const irsdk_varHeader* src = in.getVarHeaders();
+        const irsdk_varHeader* dst = out->getVarHeaders();
+        in.rewind();
+        while( in.getNextData() )
+        {
+            for( int i=0; i<numVars; ++i )
+                memcpy( out->getLineBuf() + dst[i].offset, in.getData() + src[i].offset, irsdk_VarTypeBytes[src[i].type] * src[i].count );
+            out->writeLine();
+        }
+    }
+
+    out->closeFile();
+    delete out;
+    return ok;
+}
+
+int main( int argc, char** argv )
+{
+    const char* inPath       = nullptr;
+    const char* outPath      = nullptr;
+    int         blockRecords = IRSDK_PACK_BLOCK_RECORDS;
+    int         numThreads   = (int)std::thread::hardware_concurrency();
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool hasArg = i+1 < argc;
+        if( !strcmp(argv[i],"--block") && hasArg )
+            blockRecords = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--threads") && hasArg )
+            numThreads = atoi( argv[++i] );
+        else if( argv[i][0] != '-' && !inPath )
+            inPath = argv[i];
+        else if( argv[i][0] != '-' && !outPath )
+            outPath = argv[i];
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if( !inPath || !outPath || blockRecords < 1 ) {
+        usage();
+        return 1;
+    }
+    if( numThreads < 1 )
+        numThreads = 1;
+
+    irsdkDiskClient in;
+    if( !in.openFile( inPath ) ) {
+        printf( "Could not open %s\n", inPath );
+        return 1;
+    }
+    const int numRecords = in.getRecordCount();
+    const double mb = (double)numRecords * in.getHeader()->bufLen / (1024 * 1024);
+    printf( "%s: %d lines, %d variables, %.0f MB of lines\n", inPath, numRecords, in.getNumVars(), mb );
+
+    Clock::time_point t0 = Clock::now();
+    if( !copyFile( in, outPath, blockRecords ) ) {
+        printf( "Could not write %s\n", outPath );
+        return 1;
+    }
+    const double encodeSec = secondsSince( t0 );
+
+    const long long inBytes  = fileBytes( inPath );
+    const long long outBytes = fileBytes( outPath );
+    printf( "%s: %lld -> %lld bytes, %.2fx, encoded at %.0f MB/s\n", outPath, inBytes, outBytes, (double)inBytes / outBytes, mb / encodeSec );
+
+    irsdkDiskClient packed;
+    if( !packed.openFile( outPath ) || !packed.isPacked() || packed.getRecordCount() != numRecords ) {
+        printf( "Could not read back %s\n", outPath );
+        return 1;
+    }
+
+    // one thread, every line in order
+    t0 = Clock::now();
+    int count = 0;
+    while( packed.getNextData() )
+        count++;
+    const double seqSec = secondsSince( t0 );
+    printf( "decode 1 thread     %8.1f ms  %6.0f MB/s\n", seqSec * 1000, mb / seqSec );
+
+    // whole blocks handed out to threads, each with a cursor of its own
+    const int numBlocks = (numRecords + packed.getPackBlockRecords() - 1) / packed.getPackBlockRecords();
+    std::atomic<int> nextBlock( 0 );
+    std::atomic<int> parCount( 0 );
+    t0 = Clock::now();
+    std::vector<std::thread> threads;
+    for( int t=0; t<numThreads; ++t )
+    {
+        threads.emplace_back( [&] {
+            irsdkDiskCursor c( packed );
+            int n = 0;
+            for( int b; (b = nextBlock.fetch_add( 1 )) < numBlocks; )
+            {
+                const int first = b * packed.getPackBlockRecords();
+                for( int r=first; r<first + packed.getPackBlockRecords() && c.seek( r ); ++r )
+                    n++;
+            }
+            parCount += n;
+        } );
+    }
+    for( std::thread& t : threads )
+        t.join();
+    const double parSec = secondsSince( t0 );
+    printf( "decode %d threads %s %8.1f ms  %6.0f MB/s, %.1fx\n", numThreads, numThreads < 10 ? " " : "", parSec * 1000, mb / parSec, seqSec / parSec );
+
+    // every variable of every line against the original
+    const int numVars = in.getNumVars();
+    const irsdk_varHeader* src = in.getVarHeaders();
+    const irsdk_varHeader* dst = packed.getVarHeaders();
+    long long mismatches = 0;
+    in.rewind();
+    packed.rewind();
+    for( int r=0; r<numRecords; ++r )
+    {
+        if( !in.getNextData() || !packed.getNextData() ) {
+            mismatches++;
+            break;
+        }
+        for( int i=0; i<numVars; ++i )
+            if( memcmp( in.getData() + src[i].offset, packed.getData() + dst[i].offset, irsdk_VarTypeBytes[src[i].type] * src[i].count ) )
+                mismatches++;
+    }
+
+    const bool ok = mismatches == 0 && count == numRecords && parCount == numRecords;
+    if( ok )
+        printf( "All %d lines match\n", numRecords );
+    else
+        printf( "MISMATCH, %lld variables differ\n", mismatches );
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <atomic>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_transport.h"
+#include "irsdk_producer.h"
+
+static int align16( int x )
+{
+    return (x + 15) & ~15;
+}
+
+irsdkProducer::irsdkProducer()
+{
+}
+
+irsdkProducer::~irsdkProducer()
+{
+    close();
+    delete m_transport;
+}
+
+bool irsdkProducer::open( irsdk_varHeader* varHeaders, int numVars, int tickRate, int maxSessionInfoLen, bool keepOffsets, int bufLen )
+{
+    close();
+
+    if( !keepOffsets )
+    {
+        bufLen = 0;
+        for( int i=0; i<numVars; ++i )
+        {
+            const int bytes = irsdk_VarTypeBytes[varHeaders[i].type];
+            bufLen = (bufLen + bytes - 1) / bytes * bytes;  // natural alignment
+            varHeaders[i].offset = bufLen;
+            bufLen += bytes * varHeaders[i].count;
+        }
+    }
+    bufLen = align16( bufLen );
+
+    // header, var headers, session string, then the rotating lines
+    const int numBuf         = 3;
+    const int varHeaderOfs   = align16( (int)sizeof(irsdk_header) );
+    const int sessionInfoOfs = align16( varHeaderOfs + numVars*(int)sizeof(irsdk_varHeader) );
+    const int firstBufOfs    = align16( sessionInfoOfs + maxSessionInfoLen );
+    const int size           = firstBufOfs + numBuf*bufLen;
+
+    if( !m_transport )
+        m_transport = irsdk_createTransportProducer();
+    if( !m_transport->create(size) )
+    {
+        printf( "Could not create shared memory (%d bytes)\n", size );
+        return false;
+    }
+
+    m_mem = m_transport->getSharedMem();
+    memset( m_mem, 0, size );
+
+    m_header = (irsdk_header*)m_mem;
+    m_header->ver               = IRSDK_VER;
+    m_header->tickRate          = tickRate;
+    m_header->sessionInfoLen    = maxSessionInfoLen;
+    m_header->sessionInfoOffset = sessionInfoOfs;
+    m_header->numVars           = numVars;
+    m_header->varHeaderOffset   = varHeaderOfs;
+    m_header->numBuf            = numBuf;
+    m_header->bufLen            = bufLen;
+    for( int i=0; i<numBuf; ++i )
+    {
+        m_header->varBuf[i].tickCount = -1;
+        m_header->varBuf[i].bufOffset = firstBufOfs + i*bufLen;
+    }
+    memcpy( m_mem + varHeaderOfs, varHeaders, numVars*sizeof(irsdk_varHeader) );
+
+    m_tickCount = 0;
+    m_curBuf    = 0;
+
+    std::atomic_thread_fence( std::memory_order_release );
+    m_header->status = irsdk_stConnected;
+    return true;
+}
+
+void irsdkProducer::close()
+{
+    if( m_header )
+    {
+        // let clients know we're gone
+        m_header->status = 0;
+        std::atomic_thread_fence( std::memory_order_release );
+        m_transport->signalDataValid();
+        m_transport->close();
+    }
+    m_header = nullptr;
+    m_mem = nullptr;
+}
+
+void irsdkProducer::setSessionStr( const char* str, int len )
+{
+    if( len > m_header->sessionInfoLen-1 )
+        len = m_header->sessionInfoLen-1;
+
+    char* dst = m_mem + m_header->sessionInfoOffset;
+    memcpy( dst, str, len );
+    dst[len] = '\0';
+
+    std::atomic_thread_fence( std::memory_order_release );
+    m_header->sessionInfoUpdate++;
+}
+
+char* irsdkProducer::beginLine()
+{
+    // reuse the oldest of the lines, and take it out of the running while we
+    // write, so a client copying it right now sees the tick count change
+    m_curBuf = (m_curBuf + 1) % m_header->numBuf;
+    m_header->varBuf[m_curBuf].tickCount = -1;
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    return m_mem + m_header->varBuf[m_curBuf].bufOffset;
+}
+
+int irsdkProducer::getAckTick() const
+{
+    return m_transport && m_header ? m_transport->getAckTick() : -1;
+}
+
+void irsdkProducer::endLine()
+{
+    // tick count goes last, clients check it on both sides of their copy
+    std::atomic_thread_fence( std::memory_order_release );
+    m_header->varBuf[m_curBuf].tickCount = ++m_tickCount;
+    m_transport->signalDataValid();
+}
@@ -0,0 +1,65 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+// Writes the same header/varBuf layout the sim does, through an
+// irsdkTransportProducer, so irsdkClient can be run against something
+// other than iRacing. Shared by the stand-in tools in this directory.
+// Requires irsdk_defines.h to be included first.
+
+class irsdkTransportProducer;
+
+class irsdkProducer
+{
+public:
+    irsdkProducer();
+    ~irsdkProducer();
+
+    // lay out and create the shared memory, varHeaders give type, count and name of each
+    // variable, offsets are filled in here unless keepOffsets is set (bufLen is then required)
+    bool open( irsdk_varHeader* varHeaders, int numVars, int tickRate, int maxSessionInfoLen, bool keepOffsets=false, int bufLen=0 );
+    void close();
+
+    // replace the session string and bump sessionInfoUpdate
+    void setSessionStr( const char* str, int len );
+
+    // line to fill in for the next tick, then publish it with endLine()
+    char* beginLine();
+    void endLine();
+
+    int getTickCount() const { return m_tickCount; }
+
+    // last tick a client acknowledged, -1 if none has
+    int getAckTick() const;
+    int getBufLen() const { return m_header ? m_header->bufLen : 0; }
+
+private:
+    irsdkTransportProducer* m_transport = nullptr;
+    irsdk_header*           m_header = nullptr;
+    char*                   m_mem = nullptr;
+    int                     m_tickCount = 0;
+    int                     m_curBuf = 0;
+};
@@ -0,0 +1,250 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+// Plays a recorded .ibt back as live data, at its own tick rate or faster,
+// so a real race can be used as a repeatable load for the client side.
+// Reports how far behind the client is, from the ticks it acknowledges.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_diskclient.h"
+#include "../irsdk/irsdk_lapindex.h"
+#include "irsdk_producer.h"
+
+static std::atomic<bool> g_quit = false;
+
+static void onSignal( int )
+{
+    g_quit = true;
+}
+
+static void usage()
+{
+    printf( "Usage: irsdk_replay <file.ibt> [options]\n" );
+    printf( "  --rate <x>          playback speed, 1-100 times the recorded tick rate (default 1)\n" );
+    printf( "  --unthrottled       publish lines as fast as possible\n" );
+    printf( "  --session-bump <s>  republish the session string every s seconds of recorded time (default 0, only at start)\n" );
+    printf( "  --loop              start over at the end of the file\n" );
+    printf( "  --start-lap <n>     start at lap n, through the lap index kept next to the file\n" );
+    printf( "  --start-time <s>    start s seconds into the session instead\n" );
+    printf( "  --session <n>       session of those two (default 0)\n" );
+}
+
+struct LagStats
+{
+    long long samples = 0;
+    long long sum = 0;
+    int       max = 0;
+
+    void add( int lag )
+    {
+        samples++;
+        sum += lag;
+        max = std::max( max, lag );
+    }
+
+    double avg() const { return samples ? (double)sum / samples : 0; }
+};
+
+int main( int argc, char** argv )
+{
+    const char* path        = nullptr;
+    double      rate        = 1;
+    bool        unthrottled = false;
+    double      bumpSeconds = 0;
+    bool        loop        = false;
+    int         startLap    = -1;
+    double      startTime   = -1;
+    int         sessionNum  = 0;
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool hasArg = i+1 < argc;
+        if( !strcmp(argv[i],"--rate") && hasArg )
+            rate = atof( argv[++i] );
+        else if( !strcmp(argv[i],"--unthrottled") )
+            unthrottled = true;
+        else if( !strcmp(argv[i],"--session-bump") && hasArg )
+            bumpSeconds = atof( argv[++i] );
+        else if( !strcmp(argv[i],"--loop") )
+            loop = true;
+        else if( !strcmp(argv[i],"--start-lap") && hasArg )
+            startLap = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--start-time") && hasArg )
+            startTime = atof( argv[++i] );
+        else if( !strcmp(argv[i],"--session") && hasArg )
+            sessionNum = atoi( argv[++i] );
+        else if( argv[i][0] != '-' && !path )
+            path = argv[i];
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if( !path || rate < 1 || rate > 100 || bumpSeconds < 0 ) {
+        usage();
+        return 1;
+    }
+
+    irsdkDiskClient ibt;
+    if( !ibt.openFile( path ) ) {
+        printf( "Could not open %s\n", path );
+        return 1;
+    }
+
+    if( startLap >= 0 || startTime >= 0 )
+    {
+        using clock = std::chrono::steady_clock;
+        const std::string indexPath = std::string( path ) + ".laps";
+
+        clock::time_point t0 = clock::now();
+        irsdkLapIndex index;
+        if( !index.openFor( ibt, indexPath.c_str() ) ) {
+            printf( "Could not index %s, it needs SessionTime\n", path );
+            return 1;
+        }
+        const double openMs = std::chrono::duration<double, std::milli>( clock::now() - t0 ).count();
+
+        t0 = clock::now();
+        const int record = startLap >= 0 ? index.findLap( sessionNum, startLap ) : index.findTime( ibt, sessionNum, startTime );
+        const double seekUs = std::chrono::duration<double, std::micro>( clock::now() - t0 ).count();
+
+        if( record < 0 ) {
+            printf( "Session %d has no %s %g\n", sessionNum, startLap >= 0 ? "lap" : "time", startLap >= 0 ? (double)startLap : startTime );
+            return 1;
+        }
+        printf( "Starting at line %d: lap index %s in %.1f ms, found in %.1f us\n", record, indexPath.c_str(), openMs, seekUs );
+
+        ibt.rewind();
+        ibt.skipData( record );
+    }
+
+    // republish with the recorded layout, so lines can be copied over as they are
+    const irsdk_header* hdr = ibt.getHeader();
+    const int tickRate = hdr->tickRate > 0 ? hdr->tickRate : 60;
+    std::vector<irsdk_varHeader> varHeaders( ibt.getVarHeaders(), ibt.getVarHeaders() + hdr->numVars );
+    const char* sessionStr = ibt.getSessionStr();
+    const int   sessionLen = (int)strlen( sessionStr );
+
+    irsdkProducer producer;
+    if( !producer.open( varHeaders.data(), hdr->numVars, tickRate, std::max(sessionLen+1, 512*1024), true, hdr->bufLen ) )
+        return 1;
+    producer.setSessionStr( sessionStr, sessionLen );
+
+    printf( "Replaying %s: %d lines, %d variables, %d bytes per line, %d Hz", path, ibt.getDataCount(), hdr->numVars, hdr->bufLen, tickRate );
+    if( unthrottled )
+        printf( ", unthrottled\n" );
+    else
+        printf( " at %gx\n", rate );
+
+    signal( SIGINT, onSignal );
+    signal( SIGTERM, onSignal );
+
+    using clock = std::chrono::steady_clock;
+    const clock::duration tickLen = std::chrono::duration_cast<clock::duration>( std::chrono::duration<double>(1.0/(tickRate*rate)) );
+    const int bumpTicks = (int)(bumpSeconds * tickRate);
+    const clock::time_point start = clock::now();
+    clock::time_point next = start;
+    clock::time_point nextReport = start + std::chrono::seconds(1);
+    LagStats total, interval;
+    int lastAck = -1, lastAckLine = 0;
+    int lines = 0, bumps = 0, passes = 1;
+    long long late = 0;
+
+    while( !g_quit )
+    {
+        if( !ibt.getNextData() )
+        {
+            if( !loop || !ibt.rewind() || !ibt.getNextData() )
+                break;
+            passes++;
+        }
+
+        memcpy( producer.beginLine(), ibt.getData(), hdr->bufLen );
+        producer.endLine();
+        lines++;
+
+        if( bumpTicks > 0 && lines % bumpTicks == 0 ) {
+            producer.setSessionStr( sessionStr, sessionLen );
+            bumps++;
+        }
+
+        // a client that has not acknowledged anything yet is not counted, nor
+        // one whose ack has not moved for a second of ticks, it has gone away
+        const int ack = producer.getAckTick();
+        if( ack != lastAck ) {
+            lastAck = ack;
+            lastAckLine = lines;
+        }
+        if( ack >= 0 && lines - lastAckLine <= tickRate ) {
+            const int lag = std::max( 0, producer.getTickCount() - ack );
+            total.add( lag );
+            interval.add( lag );
+        }
+
+        const clock::time_point now = clock::now();
+        if( now >= nextReport )
+        {
+            if( interval.samples )
+                printf( "tick %d, acked %d, lag avg %.1f max %d ticks (%.1f ms recorded time)\n",
+                    producer.getTickCount(), ack, interval.avg(), interval.max, 1000.0*interval.avg()/tickRate );
+            else
+                printf( "tick %d, no client acknowledging\n", producer.getTickCount() );
+            interval = LagStats();
+            nextReport += std::chrono::seconds(1);
+        }
+
+        if( unthrottled )
+            continue;
+
+        // hold the rate on average, without drifting if a line runs long
+        next += tickLen;
+        if( next > now )
+            std::this_thread::sleep_until( next );
+        else
+            late++;
+    }
+
+    const double elapsed = std::chrono::duration<double>( clock::now() - start ).count();
+    printf( "Published %d lines in %.2fs (%.1f/s), %d pass(es), %d session string updates, %lld lines late\n",
+        lines, elapsed, lines/elapsed, passes, bumps + 1, late );
+    if( total.samples )
+        printf( "Consumer lag: avg %.2f ticks, max %d ticks, last acked %d of %d\n",
+            total.avg(), total.max, producer.getAckTick(), producer.getTickCount() );
+    else
+        printf( "Consumer lag: no client acknowledged any ticks\n" );
+
+    producer.close();
+    return 0;
+}
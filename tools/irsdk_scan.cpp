@@ -0,0 +1,257 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Summarizes every .ibt under the given files and directories on all cores:
+// best lap, fuel per lap and stints per file, then per car and track across
+// them, and how fast it got through them. --generate writes synthetic
+// recordings to try it on.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_diskclient.h"
+#include "../irsdk/irsdk_scan.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static void usage()
+{
+    printf( "Usage: irsdk_scan <file.ibt or directory>... [options]\n" );
+    printf( "  --threads <n>     worker threads (default one per core)\n" );
+    printf( "  --chunk <lines>   lines per task (default 65536)\n" );
+    printf( "  --laps            list every lap\n" );
+    printf( "  --generate <n>    first write n synthetic recordings into the (one) directory given\n" );
+    printf( "  --size <mb>       size of each of those (default 64)\n" );
+}
+
+static std::string formatLapTime( double t )
+{
+    char s[32];
+    if( t <= 0 )
+        return "-";
+    snprintf( s, sizeof(s), "%d:%06.3f", (int)(t / 60), t - 60 * (int)(t / 60) );
+    return s;
+}
+
+static const char* const g_genTracks[] = { "spa", "monza full", "suzuka grandprix" };
+static const char* const g_genCars[] = { "Porsche 911 GT3 R", "Mazda MX-5 Cup" };
+
+// laps of about 90s at 60Hz, fuel running down and a pit stop every 20 laps,
+// on a few tracks in a few cars so the per car and track summary has something to merge
+static bool generate( const std::string& path, double mb, int seed )
+{
+    irsdkDiskWriter ibt;
+    if( !ibt.openFile( path.c_str() ) )
+        return false;
+
+    // just the parts of the session string the scan reads
+    char sessionStr[512];
+    snprintf( sessionStr, sizeof(sessionStr),
+        "---\n"
+        "WeekendInfo:\n"
+        " TrackName: %s\n"
+        "\n"
+        "DriverInfo:\n"
+        " DriverCarIdx: 0\n"
+        " Drivers:\n"
+        " - CarIdx: 0\n"
+        "   UserName: Generated Driver\n"
+        "   CarScreenName: %s\n"
+        "\n"
+        "...\n",
+        g_genTracks[seed % 3], g_genCars[(seed / 3) % 2] );
+    ibt.setSessionStr( sessionStr );
+
+    const int lapIdx  = ibt.addNewVariable( "Lap", "", "", irsdk_int );
+    const int timeIdx = ibt.addNewVariable( "SessionTime", "", "s", irsdk_double );
+    const int fuelIdx = ibt.addNewVariable( "FuelLevel", "", "l", irsdk_float );
+    const int pitIdx  = ibt.addNewVariable( "OnPitRoad", "", "", irsdk_bool );
+    // the rest of what the sim logs, so lines are a realistic size
+    char name[32];
+    for( int i=0; i<150; ++i ) {
+        snprintf( name, sizeof(name), "Var%d", i );
+        ibt.addNewVariable( name, "", "", irsdk_float );
+    }
+    for( int i=0; i<6; ++i ) {
+        snprintf( name, sizeof(name), "CarIdxVar%d", i );
+        ibt.addNewVariable( name, "", "", irsdk_float, 64 );
+    }
+    ibt.finalizeHeader();
+
+    const int    bufLen = 4 + 8 + 4 + 1 + 150 * 4 + 6 * 64 * 4;
+    const long long lines = (long long)(mb * 1024 * 1024 / bufLen);
+    const double lapLen = 90 + seed % 7;
+    double t = 0, lapStart = 0, fuel = 100;
+    int    lap = 1;
+    for( long long line=0; line<lines; ++line )
+    {
+        t += 1.0 / 60;
+        if( t - lapStart >= lapLen + 0.01 * (line % 37) ) {
+            lap++;
+            lapStart = t;
+        }
+        const bool inPit = lap % 20 == 0 && t - lapStart < 30;
+        fuel = inPit ? 100.0 : fuel - 2.5 / (60 * lapLen);
+
+        ibt.setVar( lap, lapIdx );
+        ibt.setVar( t, timeIdx );
+        ibt.setVar( (float)fuel, fuelIdx );
+        ibt.setVar( inPit, pitIdx );
+        for( int i=0; i<150; ++i )
+            ibt.setVar( (float)(line + i), pitIdx + 1 + i );
+        ibt.writeLine();
+    }
+    return true;
+}
+
+int main( int argc, char** argv )
+{
+    std::vector<std::string> args;
+    int    numThreads   = 0;
+    int    chunkRecords = 64 * 1024;
+    bool   listLaps     = false;
+    int    numGenerate  = 0;
+    double generateMb   = 64;
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool hasArg = i+1 < argc;
+        if( !strcmp(argv[i],"--threads") && hasArg )
+            numThreads = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--chunk") && hasArg )
+            chunkRecords = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--laps") )
+            listLaps = true;
+        else if( !strcmp(argv[i],"--generate") && hasArg )
+            numGenerate = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--size") && hasArg )
+            generateMb = atof( argv[++i] );
+        else if( argv[i][0] != '-' )
+            args.push_back( argv[i] );
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if( args.empty() || numThreads < 0 || chunkRecords < 1 || (numGenerate && args.size() != 1) ) {
+        usage();
+        return 1;
+    }
+
+    if( numGenerate )
+    {
+        std::filesystem::create_directories( args[0] );
+        for( int i=0; i<numGenerate; ++i )
+        {
+            char name[32];
+            snprintf( name, sizeof(name), "gen%04d.ibt", i );
+            if( !generate( (std::filesystem::path(args[0]) / name).string(), generateMb, i ) ) {
+                printf( "Could not write %s\n", name );
+                return 1;
+            }
+        }
+        printf( "Wrote %d files of %.0f MB to %s\n", numGenerate, generateMb, args[0].c_str() );
+    }
+
+    std::vector<std::string> paths;
+    for( const std::string& arg : args )
+    {
+        std::error_code ec;
+        if( std::filesystem::is_directory( arg, ec ) ) {
+            for( const auto& e : std::filesystem::recursive_directory_iterator( arg, ec ) )
+                if( e.is_regular_file() && e.path().extension() == ".ibt" )
+                    paths.push_back( e.path().string() );
+        }
+        else
+            paths.push_back( arg );
+    }
+
+    Clock::time_point t0 = Clock::now();
+    std::vector<irsdkFileSummary> results;
+    irsdk_scanFiles( paths, results, numThreads, chunkRecords );
+    const double sec = std::chrono::duration<double>( Clock::now() - t0 ).count();
+
+    // per file
+    long long bytes = 0;
+    int numFailed = 0;
+    for( const irsdkFileSummary& r : results )
+    {
+        if( !r.ok ) {
+            printf( "%s: could not read, or no Lap/SessionTime\n", r.path.c_str() );
+            numFailed++;
+            continue;
+        }
+        bytes += r.bytes;
+        printf( "%s: %s, %s, %d laps, best %s, %.3f fuel/lap, %d stints\n", r.path.c_str(), r.track.c_str(), r.car.c_str(),
+            (int)r.laps.size(), formatLapTime( r.bestLapTime ).c_str(), r.fuelPerLap, (int)r.stints.size() );
+
+        for( const irsdkStintSummary& st : r.stints )
+            printf( "    stint from lap %d: %d laps, best %s, avg %s, %.2f fuel\n", st.firstLap, st.numLaps,
+                formatLapTime( st.bestLapTime ).c_str(), formatLapTime( st.avgLapTime ).c_str(), st.fuelUsed );
+
+        if( listLaps )
+            for( const irsdkLapSummary& l : r.laps )
+                printf( "    lap %4d %10s %8.3f fuel%s%s\n", l.lap, formatLapTime( l.lapTime ).c_str(), l.fuelUsed,
+                    l.pitted ? " pit" : "", l.complete ? "" : " partial" );
+    }
+
+    // per car and track
+    struct Combo
+    {
+        int         numFiles   = 0;
+        double      best       = 0;
+        std::string bestPath;
+        double      fuelSum    = 0;
+        int         numFuelLaps = 0;
+    };
+    std::map<std::string, Combo> combos;
+    for( const irsdkFileSummary& r : results )
+    {
+        if( !r.ok )
+            continue;
+        Combo& c = combos[ (r.car.empty() ? "?" : r.car) + " @ " + (r.track.empty() ? "?" : r.track) ];
+        c.numFiles++;
+        if( r.bestLapTime > 0 && (c.best <= 0 || r.bestLapTime < c.best) ) {
+            c.best = r.bestLapTime;
+            c.bestPath = r.path;
+        }
+        c.fuelSum     += (double)r.fuelPerLap * r.numFuelLaps;
+        c.numFuelLaps += r.numFuelLaps;
+    }
+    printf( "\n" );
+    for( const auto& kv : combos )
+        printf( "%s: %d files, best %s (%s), %.3f fuel/lap over %d laps\n", kv.first.c_str(), kv.second.numFiles,
+            formatLapTime( kv.second.best ).c_str(), kv.second.bestPath.c_str(),
+            kv.second.numFuelLaps ? kv.second.fuelSum / kv.second.numFuelLaps : 0.0, kv.second.numFuelLaps );
+
+    const double gb = bytes / (1024.0 * 1024 * 1024);
+    printf( "\n%d files, %.2f GB in %.1f ms: %.0f files/s, %.2f GB/s\n", (int)results.size(), gb, sec * 1000, results.size() / sec, gb / sec );
+    return numFailed ? 1 : 0;
+}
@@ -0,0 +1,263 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include "irsdk_sessionstr.h"
+
+// same as the sim, see IR_MAX_CARS
+static const int MAX_CARS = 64;
+
+static const char* const g_sessionNames[] = { "PRACTICE", "QUALIFY", "WARMUP", "RACE" };
+static const char* const g_licenses[] = { "R 2.50", "D 3.10", "C 2.87", "B 3.45", "A 4.99", "P 3.02" };
+
+static int classOf( int carIdx, int numClasses )
+{
+    return numClasses > 0 ? carIdx % numClasses : 0;
+}
+
+std::string irsdk_makeSessionStr( int numCars, int numClasses, int numSessions )
+{
+    if( numCars > MAX_CARS )
+        numCars = MAX_CARS;
+    if( numClasses < 1 )
+        numClasses = 1;
+
+    char buf[2048];
+    std::string s;
+    s.reserve( 2048 + numCars * (1024 + numSessions*400) );
+
+    s += "---\n";
+    s += "WeekendInfo:\n";
+    s += " TrackName: simulator\n";
+    s += " TrackID: 1\n";
+    s += " TrackLength: 4.00 km\n";
+    s += " TrackDisplayName: Simulator Raceway\n";
+    s += " TrackDisplayShortName: Simulator\n";
+    s += " TrackConfigName: Grand Prix\n";
+    s += " TrackCity: Nowhere\n";
+    s += " TrackCountry: Nowhere\n";
+    s += " TrackNumTurns: 14\n";
+    s += " TrackWeatherType: Constant\n";
+    s += " TrackSkies: Partly Cloudy\n";
+    s += " TrackSurfaceTemp: 31.50 C\n";
+    s += " TrackAirTemp: 22.00 C\n";
+    s += " SeriesID: 1\n";
+    s += " SeasonID: 1\n";
+    s += " SessionID: 1\n";
+    s += " SubSessionID: 1\n";
+    s += " LeagueID: 0\n";
+    s += " Official: 0\n";
+    s += " RaceWeek: 0\n";
+    s += " EventType: Race\n";
+    s += " Category: Road\n";
+    s += " SimMode: full\n";
+    s += " TeamRacing: 0\n";
+    s += " NumCarClasses: ";
+    s += std::to_string( numClasses );
+    s += "\n";
+    s += " WeekendOptions:\n";
+    s += "  NumStarters: 0\n";
+    s += "  StartingGrid: 2x2 inline pole on left\n";
+    s += "  QualifyScoring: best lap\n";
+    s += "  CourseCautions: local\n";
+    s += "  StandingStart: 0\n";
+    s += "  Restarts: double file lapped cars behind\n";
+    s += "  IsFixedSetup: 0\n";
+    s += "  IncidentLimit: 17\n";
+    s += "\n";
+
+    s += "SessionInfo:\n";
+    s += " Sessions:\n";
+    for( int sess=0; sess<numSessions; ++sess )
+    {
+        const char* name = g_sessionNames[ numSessions<4 ? 4-numSessions+sess : sess%4 ];
+        snprintf( buf, sizeof(buf),
+            " - SessionNum: %d\n"
+            "   SessionLaps: unlimited\n"
+            "   SessionTime: %s\n"
+            "   SessionNumLapsToAvg: 0\n"
+            "   SessionType: %s\n"
+            "   SessionTrackRubberState: moderate usage\n"
+            "   SessionName: %s\n"
+            "   SessionSubType: \n"
+            "   SessionSkipped: 0\n"
+            "   SessionRunGroupsUsed: 0\n"
+            "   ResultsPositions:\n",
+            sess, sess+1<numSessions ? "1800.0000 sec" : "unlimited", name, name );
+        s += buf;
+
+        int classPos[MAX_CARS] = {};
+        for( int pos=0; pos<numCars; ++pos )
+        {
+            const int carIdx = (pos * 7 + sess) % numCars;
+            const float fastest = 90.0f + 0.1f * ((carIdx*37)%50);
+            snprintf( buf, sizeof(buf),
+                "   - Position: %d\n"
+                "     ClassPosition: %d\n"
+                "     CarIdx: %d\n"
+                "     Lap: %d\n"
+                "     Time: %.4f\n"
+                "     FastestLap: %d\n"
+                "     FastestTime: %.4f\n"
+                "     LastTime: %.4f\n"
+                "     LapsLed: 0\n"
+                "     LapsComplete: %d\n"
+                "     JokerLapsComplete: 0\n"
+                "     LapsDriven: %d.000\n"
+                "     Incidents: %d\n"
+                "     ReasonOutId: 0\n"
+                "     ReasonOutStr: Running\n",
+                pos+1, classPos[classOf(carIdx,numClasses)]++, carIdx, 20, 20*fastest + pos*0.5f, 5 + pos%7, fastest, fastest + 0.25f, 20, 20, pos%5 );
+            s += buf;
+        }
+        s += "   ResultsFastestLap:\n";
+        s += "   - CarIdx: 0\n";
+        s += "     FastestLap: 5\n";
+        s += "     FastestTime: 90.0000\n";
+        s += "   ResultsAverageLapTime: -1.0000\n";
+        s += "   ResultsNumCautionFlags: 0\n";
+        s += "   ResultsNumCautionLaps: 0\n";
+        s += "   ResultsNumLeadChanges: 0\n";
+        s += "   ResultsLapsComplete: -1\n";
+        s += "   ResultsOfficial: 0\n";
+        s += "\n";
+    }
+
+    if( numSessions > 1 )
+    {
+        s += "QualifyResultsInfo:\n";
+        s += " Results:\n";
+        for( int pos=0; pos<numCars; ++pos )
+        {
+            const int carIdx = (pos * 7) % numCars;
+            snprintf( buf, sizeof(buf),
+                " - Position: %d\n"
+                "   ClassPosition: %d\n"
+                "   CarIdx: %d\n"
+                "   FastestLap: 3\n"
+                "   FastestTime: %.4f\n",
+                pos, pos / numClasses, carIdx, 90.0f + 0.1f * ((carIdx*37)%50) );
+            s += buf;
+        }
+        s += "\n";
+    }
+
+    s += "CameraInfo:\n";
+    s += " Groups:\n";
+    s += " - GroupNum: 1\n";
+    s += "   GroupName: Nose\n";
+    s += "   Cameras:\n";
+    s += "   - CameraNum: 1\n";
+    s += "     CameraName: CamNose\n";
+    s += "\n";
+
+    s += "DriverInfo:\n";
+    s += " DriverCarIdx: 0\n";
+    s += " DriverUserID: 1000\n";
+    s += " PaceCarIdx: -1\n";
+    s += " DriverHeadPosX: -0.120\n";
+    s += " DriverHeadPosY: 0.350\n";
+    s += " DriverHeadPosZ: 0.600\n";
+    s += " DriverCarIdleRPM: 900.000\n";
+    s += " DriverCarRedLine: 8000.000\n";
+    s += " DriverCarEngCylinderCount: 6\n";
+    s += " DriverCarFuelKgPerLtr: 0.750\n";
+    s += " DriverCarFuelMaxLtr: 100.000\n";
+    s += " DriverCarMaxFuelPct: 1.000\n";
+    s += " DriverCarSLFirstRPM: 6500.000\n";
+    s += " DriverCarSLShiftRPM: 7600.000\n";
+    s += " DriverCarSLLastRPM: 7800.000\n";
+    s += " DriverCarSLBlinkRPM: 7900.000\n";
+    s += " DriverPitTrkPct: 0.950000\n";
+    s += " DriverCarEstLapTime: 90.0000\n";
+    s += " DriverSetupName: baseline.sto\n";
+    s += " DriverSetupIsModified: 0\n";
+    s += " DriverSetupLoadTypeName: user\n";
+    s += " DriverSetupPassedTech: 1\n";
+    s += " DriverIncidentCount: 0\n";
+    s += " Drivers:\n";
+    for( int i=0; i<numCars; ++i )
+    {
+        const int cls = classOf( i, numClasses );
+        snprintf( buf, sizeof(buf),
+            " - CarIdx: %d\n"
+            "   UserName: Driver %d\n"
+            "   AbbrevName: Driver, %d\n"
+            "   Initials: D%d\n"
+            "   UserID: %d\n"
+            "   TeamID: 0\n"
+            "   TeamName: Team %d\n"
+            "   CarNumber: \"%d\"\n"
+            "   CarNumberRaw: %d\n"
+            "   CarPath: simcar%d\n"
+            "   CarClassID: %d\n"
+            "   CarID: %d\n"
+            "   CarIsPaceCar: 0\n"
+            "   CarIsAI: 0\n"
+            "   CarIsElectric: 0\n"
+            "   CarScreenName: Simulator Car %d\n"
+            "   CarScreenNameShort: Sim %d\n"
+            "   CarClassShortName: SIM%d\n"
+            "   CarClassRelSpeed: %d\n"
+            "   CarClassLicenseLevel: 0\n"
+            "   CarClassMaxFuelPct: 1.000 %%\n"
+            "   CarClassWeightPenalty: 0.000 kg\n"
+            "   CarClassPowerAdjust: 0.000 %%\n"
+            "   CarClassDryTireSetLimit: 0 %%\n"
+            "   CarClassColor: 0x%06x\n"
+            "   CarClassEstLapTime: %.4f\n"
+            "   IRating: %d\n"
+            "   LicLevel: 18\n"
+            "   LicSubLevel: 349\n"
+            "   LicString: %s\n"
+            "   LicColor: 0x0153db\n"
+            "   IsSpectator: 0\n"
+            "   CarDesignStr: 1,ffffff,000000,ff0000\n"
+            "   HelmetDesignStr: 1,ffffff,000000,ff0000\n"
+            "   SuitDesignStr: 1,ffffff,000000,ff0000\n"
+            "   BodyType: 0\n"
+            "   FaceType: 0\n"
+            "   HelmetType: 0\n"
+            "   CarNumberDesignStr: 0,0,ffffff,777777,000000\n"
+            "   CarSponsor_1: 0\n"
+            "   CarSponsor_2: 0\n"
+            "   ClubName: Simulator Club\n"
+            "   ClubID: 1\n"
+            "   DivisionName: Division 1\n"
+            "   DivisionID: 0\n"
+            "   CurDriverIncidentCount: %d\n"
+            "   TeamIncidentCount: %d\n",
+            i, i, i, i, 1000+i, i, i+1, i+1, cls, cls+1, 100+cls, cls, cls, cls, 100-cls*10,
+            0xffda59 ^ (cls*0x2f4f1b), 90.0f + cls*8.0f, 1500 + (i*137)%3000, g_licenses[i%6], i%9, i%9 );
+        s += buf;
+    }
+    s += "\n";
+    s += "SplitTimeInfo:\n";
+    s += " Sectors:\n";
+    s += " - SectorNum: 0\n";
+    s += "   SectorStartPct: 0.000000\n";
+    s += "\n...\n";
+    return s;
+}
@@ -0,0 +1,156 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include "../irsdk/irsdk_defines.h"
+#include "irsdk_simfield.h"
+
+// same as the sim, see IR_MAX_CARS
+static const int MAX_CARS = 64;
+
+irsdkSimField::irsdkSimField( int numCars, int numClasses, int extraVars )
+    : m_numCars( numCars )
+    , m_numClasses( numClasses )
+    , m_lapTime( MAX_CARS )
+    , m_pct( MAX_CARS )
+    , m_lap( MAX_CARS, 0 )
+    , m_lastLap( MAX_CARS, -1.0f )
+    , m_bestLap( MAX_CARS, -1.0f )
+{
+    // Variables, named like the ones the sim outputs
+    m_vSessionTime    = add( "SessionTime", irsdk_double, 1, "s", "Seconds since session start" );
+    m_vSessionTick    = add( "SessionTick", irsdk_int, 1, "", "Current update number" );
+    m_vSessionState   = add( "SessionState", irsdk_int, 1, "irsdk_SessionState", "Session state" );
+    m_vSessionFlags   = add( "SessionFlags", irsdk_bitField, 1, "irsdk_Flags", "Session flags" );
+    m_vLapsRemain     = add( "SessionLapsRemainEx", irsdk_int, 1, "", "New improved laps left till session ends" );
+    m_vLapsTotal      = add( "SessionLapsTotal", irsdk_int, 1, "", "Total number of laps in session" );
+    m_vTimeRemain     = add( "SessionTimeRemain", irsdk_double, 1, "s", "Seconds left till session ends" );
+    m_vIsOnTrack      = add( "IsOnTrack", irsdk_bool, 1, "", "1=Car on track physics running with player in car" );
+    m_vIsOnTrackCar   = add( "IsOnTrackCar", irsdk_bool, 1, "", "1=Car on track physics running" );
+    m_vPlayerCarIdx   = add( "PlayerCarIdx", irsdk_int, 1, "", "Players carIdx" );
+    m_vDisplayUnits   = add( "DisplayUnits", irsdk_int, 1, "", "Default units for the user interface 0 = english 1 = metric" );
+    m_vSpeed          = add( "Speed", irsdk_float, 1, "m/s", "GPS vehicle speed" );
+    m_vRPM            = add( "RPM", irsdk_float, 1, "revs/min", "Engine rpm" );
+    m_vGear           = add( "Gear", irsdk_int, 1, "", "-1=reverse  0=neutral  1..n=current gear" );
+    m_vThrottle       = add( "Throttle", irsdk_float, 1, "%", "0=off throttle to 1=full throttle" );
+    m_vBrake          = add( "Brake", irsdk_float, 1, "%", "0=brake released to 1=max pedal force" );
+    m_vFuelLevel      = add( "FuelLevel", irsdk_float, 1, "l", "Liters of fuel remaining" );
+    m_vFuelLevelPct   = add( "FuelLevelPct", irsdk_float, 1, "%", "Percent fuel remaining" );
+    m_vLap            = add( "Lap", irsdk_int, 1, "", "Laps started count" );
+    m_vLapDistPct     = add( "LapDistPct", irsdk_float, 1, "%", "Percentage distance around lap" );
+    m_vCarIdxLap      = add( "CarIdxLap", irsdk_int, MAX_CARS, "", "Laps started by car index" );
+    m_vCarIdxLapCompl = add( "CarIdxLapCompleted", irsdk_int, MAX_CARS, "", "Laps completed by car index" );
+    m_vCarIdxLapDist  = add( "CarIdxLapDistPct", irsdk_float, MAX_CARS, "%", "Percentage distance around lap by car index" );
+    m_vCarIdxPos      = add( "CarIdxPosition", irsdk_int, MAX_CARS, "", "Cars position in race by car index" );
+    m_vCarIdxClassPos = add( "CarIdxClassPosition", irsdk_int, MAX_CARS, "", "Cars class position in race by car index" );
+    m_vCarIdxClass    = add( "CarIdxClass", irsdk_int, MAX_CARS, "", "Cars class id by car index" );
+    m_vCarIdxOnPit    = add( "CarIdxOnPitRoad", irsdk_bool, MAX_CARS, "", "On pit road between the cones by car index" );
+    m_vCarIdxSurface  = add( "CarIdxTrackSurface", irsdk_int, MAX_CARS, "irsdk_TrkLoc", "Track surface type by car index" );
+    m_vCarIdxEstTime  = add( "CarIdxEstTime", irsdk_float, MAX_CARS, "s", "Estimated time to reach current location on track" );
+    m_vCarIdxLastLap  = add( "CarIdxLastLapTime", irsdk_float, MAX_CARS, "s", "Cars last lap time" );
+    m_vCarIdxBestLap  = add( "CarIdxBestLapTime", irsdk_float, MAX_CARS, "s", "Cars best lap time" );
+    m_vClock          = add( "SimulatorClock", irsdk_double, 1, "s", "Producer steady clock when the line was written" );
+    for( int i=0; i<extraVars; ++i )
+    {
+        char name[IRSDK_MAX_STRING];
+        snprintf( name, sizeof(name), "Padding%d", i );
+        add( name, irsdk_float, 1, "", "Unused, makes the line bigger" );
+    }
+
+    for( int i=0; i<MAX_CARS; ++i ) {
+        m_lapTime[i] = 90.0f + 0.1f * ((i*37)%50);
+        m_pct[i]     = 1.0f - (float)i / numCars * 0.2f;
+    }
+}
+
+int irsdkSimField::add( const char* name, irsdk_VarType type, int count, const char* unit, const char* desc )
+{
+    irsdk_varHeader vh;
+    vh.clear();
+    vh.type  = type;
+    vh.count = count;
+    strncpy( vh.name, name, IRSDK_MAX_STRING-1 );
+    strncpy( vh.desc, desc, IRSDK_MAX_DESC-1 );
+    strncpy( vh.unit, unit, IRSDK_MAX_STRING-1 );
+    m_headers.push_back( vh );
+    return (int)m_headers.size() - 1;
+}
+
+void irsdkSimField::step( char* line, int tick, double dt )
+{
+    for( int i=0; i<m_numCars; ++i )
+    {
+        m_pct[i] += float(dt / m_lapTime[i]);
+        if( m_pct[i] >= 1.0f ) {
+            m_pct[i] -= 1.0f;
+            m_lap[i]++;
+            m_lastLap[i] = m_lapTime[i];
+            m_bestLap[i] = m_bestLap[i] < 0 ? m_lastLap[i] : std::min( m_bestLap[i], m_lastLap[i] );
+            if( i == 0 )
+                m_fuel = m_fuel > 3.0f ? m_fuel - 2.5f : 100.0f;
+        }
+    }
+
+    const float pct0 = m_pct[0];
+    *ptr<double>(line,m_vSessionTime)  = tick * dt;
+    *ptr<int>(line,m_vSessionTick)     = tick + 1;
+    *ptr<int>(line,m_vSessionState)    = irsdk_StateRacing;
+    *ptr<int>(line,m_vSessionFlags)    = irsdk_green;
+    *ptr<int>(line,m_vLapsRemain)      = IRSDK_UNLIMITED_LAPS;
+    *ptr<int>(line,m_vLapsTotal)       = IRSDK_UNLIMITED_LAPS;
+    *ptr<double>(line,m_vTimeRemain)   = IRSDK_UNLIMITED_TIME;
+    *ptr<bool>(line,m_vIsOnTrack)      = true;
+    *ptr<bool>(line,m_vIsOnTrackCar)   = true;
+    *ptr<int>(line,m_vPlayerCarIdx)    = 0;
+    *ptr<int>(line,m_vDisplayUnits)    = 1;
+    *ptr<float>(line,m_vSpeed)         = 50.0f + 20.0f * sinf( pct0 * 6.2831853f * 8 );
+    *ptr<float>(line,m_vRPM)           = 6000.0f + 1500.0f * sinf( pct0 * 6.2831853f * 8 );
+    *ptr<int>(line,m_vGear)            = 4;
+    *ptr<float>(line,m_vThrottle)      = 0.5f + 0.5f * sinf( pct0 * 6.2831853f * 8 );
+    *ptr<float>(line,m_vBrake)         = 0.0f;
+    *ptr<float>(line,m_vFuelLevel)     = m_fuel;
+    *ptr<float>(line,m_vFuelLevelPct)  = m_fuel / 100.0f;
+    *ptr<int>(line,m_vLap)             = m_lap[0];
+    *ptr<float>(line,m_vLapDistPct)    = pct0;
+    for( int i=0; i<MAX_CARS; ++i )
+    {
+        const bool onTrack = i < m_numCars;
+        ptr<int>(line,m_vCarIdxLap)[i]        = onTrack ? m_lap[i] : -1;
+        ptr<int>(line,m_vCarIdxLapCompl)[i]   = onTrack ? m_lap[i]-1 : -1;
+        ptr<float>(line,m_vCarIdxLapDist)[i]  = onTrack ? m_pct[i] : -1.0f;
+        ptr<int>(line,m_vCarIdxPos)[i]        = onTrack ? i+1 : 0;
+        ptr<int>(line,m_vCarIdxClassPos)[i]   = onTrack ? i/m_numClasses+1 : 0;
+        ptr<int>(line,m_vCarIdxClass)[i]      = onTrack ? i%m_numClasses+1 : 0;
+        ptr<bool>(line,m_vCarIdxOnPit)[i]     = false;
+        ptr<int>(line,m_vCarIdxSurface)[i]    = onTrack ? irsdk_OnTrack : irsdk_NotInWorld;
+        ptr<float>(line,m_vCarIdxEstTime)[i]  = onTrack ? m_pct[i] * m_lapTime[i] : 0.0f;
+        ptr<float>(line,m_vCarIdxLastLap)[i]  = onTrack ? m_lastLap[i] : -1.0f;
+        ptr<float>(line,m_vCarIdxBestLap)[i]  = onTrack ? m_bestLap[i] : -1.0f;
+    }
+    *ptr<double>(line,m_vClock) = std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
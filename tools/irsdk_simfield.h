@@ -0,0 +1,71 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <vector>
+
+// A field of cars going round a track, each lapping at its own constant pace,
+// written out as the variables the sim provides. Shared by the stand-in tools
+// in this directory.
+// Requires irsdk_defines.h to be included first.
+class irsdkSimField
+{
+public:
+    // extraVars are padding floats that only make the line bigger
+    irsdkSimField( int numCars, int numClasses, int extraVars=0 );
+
+    // hand these to irsdkProducer::open(), which fills in the offsets
+    irsdk_varHeader* getVarHeaders() { return m_headers.data(); }
+    int getNumVars() const { return (int)m_headers.size(); }
+
+    // move every car on by dt and write the line for tick, as laid out by irsdkProducer
+    void step( char* line, int tick, double dt );
+
+private:
+    int add( const char* name, irsdk_VarType type, int count, const char* unit="", const char* desc="" );
+
+    template<typename T> T* ptr( char* line, int idx )
+    {
+        return (T*)(line + m_headers[idx].offset);
+    }
+
+    std::vector<irsdk_varHeader> m_headers;
+    int     m_numCars;
+    int     m_numClasses;
+
+    // per car, every car laps at its own constant pace
+    std::vector<float> m_lapTime;
+    std::vector<float> m_pct;
+    std::vector<int>   m_lap;
+    std::vector<float> m_lastLap;
+    std::vector<float> m_bestLap;
+    float   m_fuel = 100.0f;
+
+    int m_vSessionTime, m_vSessionTick, m_vSessionState, m_vSessionFlags, m_vLapsRemain, m_vLapsTotal, m_vTimeRemain;
+    int m_vIsOnTrack, m_vIsOnTrackCar, m_vPlayerCarIdx, m_vDisplayUnits;
+    int m_vSpeed, m_vRPM, m_vGear, m_vThrottle, m_vBrake, m_vFuelLevel, m_vFuelLevelPct, m_vLap, m_vLapDistPct;
+    int m_vCarIdxLap, m_vCarIdxLapCompl, m_vCarIdxLapDist, m_vCarIdxPos, m_vCarIdxClassPos, m_vCarIdxClass;
+    int m_vCarIdxOnPit, m_vCarIdxSurface, m_vCarIdxEstTime, m_vCarIdxLastLap, m_vCarIdxBestLap, m_vClock;
+};
@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+// Stand-in for the sim. Writes a plausible set of variables for a field of
+// cars going round a track at a configurable tick rate, so the client side
+// can be run and load tested without iRacing.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../irsdk/irsdk_defines.h"
+#include "irsdk_producer.h"
+#include "irsdk_sessionstr.h"
+#include "irsdk_simfield.h"
+
+// same as the sim, see IR_MAX_CARS
+static const int MAX_CARS = 64;
+
+static std::atomic<bool> g_quit = false;
+
+static void onSignal( int )
+{
+    g_quit = true;
+}
+
+static void usage()
+{
+    printf( "Usage: irsdk_simulator [options]\n" );
+    printf( "  --rate <hz>         ticks per second (default 60)\n" );
+    printf( "  --cars <n>          cars on track, 1-64 (default 40)\n" );
+    printf( "  --classes <n>       car classes the field is split into (default 1)\n" );
+    printf( "  --extra-vars <n>    additional padding variables to grow the header (default 0)\n" );
+    printf( "  --seconds <s>       stop after this long, 0 runs until interrupted (default 0)\n" );
+}
+
+int main( int argc, char** argv )
+{
+    int    rate      = 60;
+    int    numCars   = 40;
+    int    numClasses = 1;
+    int    extraVars = 0;
+    double seconds   = 0;
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool hasArg = i+1 < argc;
+        if( !strcmp(argv[i],"--rate") && hasArg )
+            rate = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--cars") && hasArg )
+            numCars = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--classes") && hasArg )
+            numClasses = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--extra-vars") && hasArg )
+            extraVars = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--seconds") && hasArg )
+            seconds = atof( argv[++i] );
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if( rate < 1 || numCars < 1 || numCars > MAX_CARS || numClasses < 1 || extraVars < 0 ) {
+        usage();
+        return 1;
+    }
+
+    irsdkSimField field( numCars, numClasses, extraVars );
+
+    irsdkProducer producer;
+    const std::string sessionStr = irsdk_makeSessionStr( numCars, numClasses, 1 );
+    if( !producer.open( field.getVarHeaders(), field.getNumVars(), rate, 512*1024 ) )
+        return 1;
+    producer.setSessionStr( sessionStr.c_str(), (int)sessionStr.size() );
+
+    printf( "Simulating %d cars at %d Hz, %d variables, %d bytes per line\n", numCars, rate, field.getNumVars(), producer.getBufLen() );
+
+    signal( SIGINT, onSignal );
+    signal( SIGTERM, onSignal );
+
+    using clock = std::chrono::steady_clock;
+    const clock::duration tickLen = std::chrono::duration_cast<clock::duration>( std::chrono::duration<double>(1.0/rate) );
+    const clock::time_point start = clock::now();
+    clock::time_point next = start;
+    const double dt = 1.0 / rate;
+    long long late = 0;
+
+    while( !g_quit )
+    {
+        const double t = producer.getTickCount() * dt;
+        if( seconds > 0 && t >= seconds )
+            break;
+
+        field.step( producer.beginLine(), producer.getTickCount(), dt );
+        producer.endLine();
+
+        // Hold the rate on average, without drifting if a tick runs long
+        next += tickLen;
+        const clock::time_point now = clock::now();
+        if( next > now )
+            std::this_thread::sleep_until( next );
+        else
+            late++;
+    }
+
+    const double elapsed = std::chrono::duration<double>( clock::now() - start ).count();
+    printf( "Wrote %d ticks in %.2fs (%.1f Hz), %lld ticks late\n", producer.getTickCount(), elapsed, producer.getTickCount()/elapsed, late );
+
+    producer.close();
+    return 0;
+}
@@ -0,0 +1,689 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+// Times decoding a session string the way iracing.cpp used to (strstr to
+// each car/result, then parseYaml() for every field) against building an
+// irsdkYamlIndex once and walking it, and checks both decode the same.
+// parseYaml() itself is timed against the byte at a time parser it
+// replaced, and has to return the same for every path iRon uses.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../irsdk/yaml_parser.h"
+#include "../irsdk/yaml_index.h"
+#include "irsdk_sessionstr.h"
+
+// same as the sim, see IR_MAX_CARS
+static const int MAX_CARS = 64;
+static const int MAX_SESSIONS = 8;
+
+typedef bool (*ParseFn)( const char* data, const char* path, const char** val, int* len );
+
+// parseYaml() as it was before the scanning primitives, kept verbatim as
+// the reference the vectorized one has to agree with
+enum bytewise_state {
+	space,
+	key,
+	keysep,
+	value,
+	newline
+};
+
+static bool parseYamlBytewise(const char *data, const char* path, const char **val, int *len)
+{
+	if(data && path && val && len)
+	{
+		// make sure we set this to something
+		*val = NULL;
+		*len = 0;
+
+		int depth = 0;
+		bytewise_state state = space;
+
+		const char *keystr = NULL;
+		int keylen = 0;
+
+		const char *valuestr = NULL;
+		int valuelen = 0;
+
+		const char *pathptr = path;
+		int pathdepth = 0;
+
+		while(*data)
+		{
+			switch(*data)
+			{
+			case ' ':
+				if(state == newline)
+					state = space;
+				if(state == space)
+					depth++;
+				else if(state == key)
+					keylen++;
+				else if(state == value)
+					valuelen++;
+				break;
+			case '-':
+				if(state == newline)
+					state = space;
+				if(state == space)
+					depth++;
+				else if(state == key)
+					keylen++;
+				else if(state == value)
+					valuelen++;
+				else if(state == keysep)
+				{
+					state = value;
+					valuestr = data;
+					valuelen = 1;
+				}
+				break;
+			case ':':
+				if(state == key)
+				{
+					state = keysep;
+					keylen++;
+				}
+				else if(state == keysep)
+				{
+					state = value;
+					valuestr = data;
+				}
+				else if(state == value)
+					valuelen++;
+				break;
+			case '\n':
+			case '\r':
+				if(state != newline)
+				{
+					if(depth < pathdepth)
+					{
+						return false;
+					}
+					else if(keylen && 0 == strncmp(keystr, pathptr, keylen))
+					{
+						bool found = true;
+						//do we need to test the value?
+						if(*(pathptr+keylen) == '{')
+						{
+							//search for closing brace
+							int pathvaluelen = keylen + 1; 
+							while(*(pathptr+pathvaluelen) && *(pathptr+pathvaluelen) != '}')
+								pathvaluelen++; 
+
+							if(valuelen == pathvaluelen - (keylen+1) && 0 == strncmp(valuestr, (pathptr+keylen+1), valuelen))
+								pathptr += valuelen + 2;
+							else
+								found = false;
+						}
+
+						if(found)
+						{
+							pathptr += keylen;
+							pathdepth = depth;
+
+							if(*pathptr == '\0')
+							{
+								*val = valuestr;
+								*len = valuelen;
+								return true;
+							}
+						}
+					}
+
+					depth = 0;
+					keylen = 0;
+					valuelen = 0;
+				}
+				state = newline;
+				break;
+			default:
+				if(state == space || state == newline)
+				{
+					state = key;
+					keystr = data;
+					keylen = 0; //redundant?
+				}
+				else if(state == keysep)
+				{
+					state = value;
+					valuestr = data;
+					valuelen = 0; //redundant?
+				}
+				if(state == key)
+					keylen++;
+				if(state == value)
+					valuelen++;
+				break;
+			}
+
+			// important, increment our pointer
+			data++;
+		}
+
+	}
+	return false;
+}
+
+// Every path iracing.cpp and the overlays look up, relative to where they look them up
+static const char* const g_paths[] = {
+    "WeekendInfo:SubSessionID:", "WeekendInfo:TrackName:", "WeekendInfo:WeekendOptions:IsFixedSetup:",
+    "WeekendInfo:WeekendOptions:NumCarClasses:", "WeekendInfo:SimMode:", "WeekendInfo:NumCarClasses:",
+    "DriverInfo:DriverCarIdx:", "DriverInfo:DriverCarFuelMaxLtr:", "DriverInfo:DriverCarIdleRPM:", "DriverInfo:DriverCarRedLine:",
+    "DriverInfo:DriverCarSLFirstRPM:", "DriverInfo:DriverCarSLShiftRPM:", "DriverInfo:DriverCarSLLastRPM:", "DriverInfo:DriverCarSLBlinkRPM:",
+    "DriverInfo:Drivers:CarIdx:{5}UserName:", "DriverInfo:Drivers:CarIdx:{63}CarClassID:",
+    "UserName:", "TeamName:", "CarNumber:", "CarNumberRaw", "LicString:", "CarClassColor:", "CarClassID:", "IRating:",
+    "CarIsPaceCar:", "IsSpectator:", "CurDriverIncidentCount:", "CarClassEstLapTime:", "CarScreenName:", "CarID:",
+    "CarIdx:", "ClassPosition:", "FastestTime:", "LastTime:", "SessionNum:", "SessionName:", "SessionTime:", "SessionLaps:",
+    "SessionInfo:Sessions:SessionNum:{1}ResultsPositions:Position:{3}CarIdx:",
+};
+
+struct Decoded
+{
+    struct Result
+    {
+        int   position = 0;
+        float lastTime = 0;
+        float fastestTime = 0;
+    };
+
+    struct Car
+    {
+        std::string userName;
+        std::string teamName;
+        std::string carNumberStr;
+        std::string licenseStr;
+        std::string classColStr;
+        std::string carName;
+        int   classId = 0;
+        int   irating = 0;
+        int   isPaceCar = 0;
+        int   isSpectator = 0;
+        int   incidentCount = 0;
+        int   carID = 0;
+        float carClassEstLapTime = 0;
+        Result qualy;
+        Result sessions[MAX_SESSIONS];
+    };
+
+    int   subsessionId = 0;
+    int   numCarClasses = 0;
+    int   driverCarIdx = -1;
+    float fuelMaxLtr = 0;
+    float rpmRedline = 0;
+    Car   cars[MAX_CARS];
+
+    bool operator==( const Decoded& o ) const
+    {
+        if( subsessionId != o.subsessionId || numCarClasses != o.numCarClasses || driverCarIdx != o.driverCarIdx || fuelMaxLtr != o.fuelMaxLtr || rpmRedline != o.rpmRedline )
+            return false;
+        for( int i=0; i<MAX_CARS; ++i )
+        {
+            const Car& a = cars[i];
+            const Car& b = o.cars[i];
+            if( a.userName != b.userName || a.teamName != b.teamName || a.carNumberStr != b.carNumberStr || a.licenseStr != b.licenseStr ||
+                a.classColStr != b.classColStr || a.carName != b.carName || a.classId != b.classId || a.irating != b.irating ||
+                a.isPaceCar != b.isPaceCar || a.isSpectator != b.isSpectator || a.incidentCount != b.incidentCount || a.carID != b.carID ||
+                a.carClassEstLapTime != b.carClassEstLapTime || a.qualy.position != b.qualy.position || a.qualy.fastestTime != b.qualy.fastestTime )
+                return false;
+            for( int s=0; s<MAX_SESSIONS; ++s )
+                if( a.sessions[s].position != b.sessions[s].position || a.sessions[s].lastTime != b.sessions[s].lastTime || a.sessions[s].fastestTime != b.sessions[s].fastestTime )
+                    return false;
+        }
+        return true;
+    }
+};
+
+static void assignStr( const char* s, int count, std::string& dest )
+{
+    if( *s == '"' ) {
+        s++;
+        count--;
+    }
+    dest.assign( s, count );
+    if( !dest.empty() && dest.back() == '"' )
+        dest.pop_back();
+}
+
+//
+// The old way, one parseYaml() per field
+//
+
+static ParseFn g_parse = parseYaml;
+
+static bool legacyInt( const char* yaml, const char* path, int* dest )
+{
+    const char* s = nullptr;
+    int count = 0;
+    if( !g_parse(yaml, path, &s, &count) )
+        return false;
+    *dest = atoi( s );
+    return true;
+}
+
+static bool legacyFloat( const char* yaml, const char* path, float* dest )
+{
+    const char* s = nullptr;
+    int count = 0;
+    if( !g_parse(yaml, path, &s, &count) )
+        return false;
+    *dest = (float)atof( s );
+    return true;
+}
+
+static bool legacyStr( const char* yaml, const char* path, std::string& dest )
+{
+    const char* s = nullptr;
+    int count = 0;
+    if( !g_parse(yaml, path, &s, &count) )
+        return false;
+    assignStr( s, count, dest );
+    return true;
+}
+
+static void decodeLegacy( const char* yaml, Decoded& d )
+{
+    char path[256];
+
+    legacyInt( yaml, "WeekendInfo:SubSessionID:", &d.subsessionId );
+    legacyInt( yaml, "WeekendInfo:NumCarClasses:", &d.numCarClasses );
+
+    const char* driverInfoYaml = strstr( yaml, "DriverInfo:" );
+    legacyInt( driverInfoYaml, "DriverInfo:DriverCarIdx:", &d.driverCarIdx );
+    legacyFloat( driverInfoYaml, "DriverInfo:DriverCarFuelMaxLtr:", &d.fuelMaxLtr );
+    legacyFloat( driverInfoYaml, "DriverInfo:DriverCarRedLine:", &d.rpmRedline );
+
+    for( int carIdx=0; carIdx<MAX_CARS; ++carIdx )
+    {
+        Decoded::Car& car = d.cars[carIdx];
+
+        sprintf( path, " - CarIdx: %d", carIdx );
+        const char* carIdxYaml = strstr( driverInfoYaml, path );
+        if( !legacyStr(carIdxYaml, "UserName:", car.userName) )
+            continue;
+        legacyStr( carIdxYaml, "TeamName:", car.teamName );
+        legacyStr( carIdxYaml, "CarNumber:", car.carNumberStr );
+        legacyStr( carIdxYaml, "LicString:", car.licenseStr );
+        legacyStr( carIdxYaml, "CarClassColor:", car.classColStr );
+        legacyInt( carIdxYaml, "CarClassID:", &car.classId );
+        legacyInt( carIdxYaml, "IRating:", &car.irating );
+        legacyInt( carIdxYaml, "CarIsPaceCar:", &car.isPaceCar );
+        legacyInt( carIdxYaml, "IsSpectator:", &car.isSpectator );
+        legacyInt( carIdxYaml, "CurDriverIncidentCount:", &car.incidentCount );
+        legacyFloat( carIdxYaml, "CarClassEstLapTime:", &car.carClassEstLapTime );
+        legacyStr( carIdxYaml, "CarScreenName:", car.carName );
+        legacyInt( carIdxYaml, "CarID:", &car.carID );
+    }
+
+    const char* qualifyResultsInfoYaml = strstr( yaml, "QualifyResultsInfo:" );
+    for( int pos=0; qualifyResultsInfoYaml && pos<MAX_CARS; ++pos )
+    {
+        sprintf( path, "\n - Position: %d", pos );
+        const char* posYaml = strstr( qualifyResultsInfoYaml, path );
+        int carIdx = -1;
+        if( posYaml && legacyInt(posYaml+16, "CarIdx:", &carIdx) && carIdx >= 0 && carIdx < MAX_CARS )
+        {
+            int realPos = -1;
+            legacyInt( posYaml+16, "ClassPosition:", &realPos );
+            d.cars[carIdx].qualy.position = realPos + 1;
+            legacyFloat( posYaml+16, "FastestTime:", &d.cars[carIdx].qualy.fastestTime );
+        }
+    }
+
+    const char* sessionInfoYaml = strstr( yaml, "SessionInfo:" );
+    for( int session=0; session<MAX_SESSIONS; ++session )
+    {
+        sprintf( path, "\n - SessionNum: %d", session );
+        const char* sessionNumYaml = strstr( sessionInfoYaml, path );
+        if( !sessionNumYaml )
+            break;
+        sessionNumYaml += 16;
+
+        for( int pos=1; pos<MAX_CARS+1; ++pos )
+        {
+            sprintf( path, "\n   - Position: %d", pos );
+            const char* posYaml = strstr( sessionNumYaml, path );
+            if( !posYaml )
+                break;
+            posYaml += 18;
+
+            int carIdx = -1;
+            if( legacyInt(posYaml, "CarIdx:", &carIdx) && carIdx >= 0 && carIdx < MAX_CARS )
+            {
+                Decoded::Result& r = d.cars[carIdx].sessions[session];
+                int realPos = -1;
+                legacyInt( posYaml, "ClassPosition:", &realPos );
+                r.position = realPos + 1;
+                legacyFloat( posYaml, "LastTime:", &r.lastTime );
+                legacyFloat( posYaml, "FastestTime:", &r.fastestTime );
+            }
+        }
+    }
+}
+
+//
+// Build the index once, then walk it
+//
+
+static bool indexInt( const irsdkYamlIndex& yaml, int node, const char* path, int* dest )
+{
+    const char* s = nullptr;
+    int count = 0;
+    if( !yaml.getVal(yaml.findPath(node, path), &s, &count) )
+        return false;
+    *dest = atoi( s );
+    return true;
+}
+
+static bool indexFloat( const irsdkYamlIndex& yaml, int node, const char* path, float* dest )
+{
+    const char* s = nullptr;
+    int count = 0;
+    if( !yaml.getVal(yaml.findPath(node, path), &s, &count) )
+        return false;
+    *dest = (float)atof( s );
+    return true;
+}
+
+static bool indexStr( const irsdkYamlIndex& yaml, int node, const char* path, std::string& dest )
+{
+    const char* s = nullptr;
+    int count = 0;
+    if( !yaml.getVal(yaml.findPath(node, path), &s, &count) )
+        return false;
+    assignStr( s, count, dest );
+    return true;
+}
+
+static void decodeIndexed( irsdkYamlIndex& yaml, const char* str, Decoded& d )
+{
+    yaml.build( str );
+    const int root = yaml.getRoot();
+
+    indexInt( yaml, root, "WeekendInfo:SubSessionID:", &d.subsessionId );
+    indexInt( yaml, root, "WeekendInfo:NumCarClasses:", &d.numCarClasses );
+    indexInt( yaml, root, "DriverInfo:DriverCarIdx:", &d.driverCarIdx );
+    indexFloat( yaml, root, "DriverInfo:DriverCarFuelMaxLtr:", &d.fuelMaxLtr );
+    indexFloat( yaml, root, "DriverInfo:DriverCarRedLine:", &d.rpmRedline );
+
+    const int drivers = yaml.findPath( root, "DriverInfo:Drivers:" );
+    for( int i=0; i<yaml.getNumChildren(drivers); ++i )
+    {
+        const int item = yaml.getChild( drivers, i );
+        int carIdx = -1;
+        if( !indexInt(yaml, item, "CarIdx:", &carIdx) || carIdx < 0 || carIdx >= MAX_CARS )
+            continue;
+
+        Decoded::Car& car = d.cars[carIdx];
+        if( !indexStr(yaml, item, "UserName:", car.userName) )
+            continue;
+        indexStr( yaml, item, "TeamName:", car.teamName );
+        indexStr( yaml, item, "CarNumber:", car.carNumberStr );
+        indexStr( yaml, item, "LicString:", car.licenseStr );
+        indexStr( yaml, item, "CarClassColor:", car.classColStr );
+        indexInt( yaml, item, "CarClassID:", &car.classId );
+        indexInt( yaml, item, "IRating:", &car.irating );
+        indexInt( yaml, item, "CarIsPaceCar:", &car.isPaceCar );
+        indexInt( yaml, item, "IsSpectator:", &car.isSpectator );
+        indexInt( yaml, item, "CurDriverIncidentCount:", &car.incidentCount );
+        indexFloat( yaml, item, "CarClassEstLapTime:", &car.carClassEstLapTime );
+        indexStr( yaml, item, "CarScreenName:", car.carName );
+        indexInt( yaml, item, "CarID:", &car.carID );
+    }
+
+    const int qualifyResults = yaml.findPath( root, "QualifyResultsInfo:Results:" );
+    for( int i=0; i<yaml.getNumChildren(qualifyResults); ++i )
+    {
+        const int item = yaml.getChild( qualifyResults, i );
+        int carIdx = -1;
+        if( indexInt(yaml, item, "CarIdx:", &carIdx) && carIdx >= 0 && carIdx < MAX_CARS )
+        {
+            int realPos = -1;
+            indexInt( yaml, item, "ClassPosition:", &realPos );
+            d.cars[carIdx].qualy.position = realPos + 1;
+            indexFloat( yaml, item, "FastestTime:", &d.cars[carIdx].qualy.fastestTime );
+        }
+    }
+
+    const int sessions = yaml.findPath( root, "SessionInfo:Sessions:" );
+    for( int i=0; i<yaml.getNumChildren(sessions); ++i )
+    {
+        const int sessionItem = yaml.getChild( sessions, i );
+        int session = -1;
+        if( !indexInt(yaml, sessionItem, "SessionNum:", &session) || session < 0 || session >= MAX_SESSIONS )
+            continue;
+
+        const int results = yaml.findPath( sessionItem, "ResultsPositions:" );
+        for( int j=0; j<yaml.getNumChildren(results); ++j )
+        {
+            const int item = yaml.getChild( results, j );
+            int carIdx = -1;
+            if( indexInt(yaml, item, "CarIdx:", &carIdx) && carIdx >= 0 && carIdx < MAX_CARS )
+            {
+                Decoded::Result& r = d.cars[carIdx].sessions[session];
+                int realPos = -1;
+                indexInt( yaml, item, "ClassPosition:", &realPos );
+                r.position = realPos + 1;
+                indexFloat( yaml, item, "LastTime:", &r.lastTime );
+                indexFloat( yaml, item, "FastestTime:", &r.fastestTime );
+            }
+        }
+    }
+}
+
+static void usage()
+{
+    printf( "Usage: irsdk_yamlbench [options]\n" );
+    printf( "  --cars <n>          drivers in the generated session string, 1-64 (default 60)\n" );
+    printf( "  --classes <n>       car classes (default 3)\n" );
+    printf( "  --sessions <n>      sessions with results (default 4)\n" );
+    printf( "  --file <path>       use a session string dumped from the sim instead\n" );
+    printf( "  --iterations <n>    decodes to time per method (default 200)\n" );
+}
+
+int main( int argc, char** argv )
+{
+    int         numCars     = 60;
+    int         numClasses  = 3;
+    int         numSessions = 4;
+    int         iterations  = 200;
+    const char* file        = nullptr;
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool hasArg = i+1 < argc;
+        if( !strcmp(argv[i],"--cars") && hasArg )
+            numCars = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--classes") && hasArg )
+            numClasses = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--sessions") && hasArg )
+            numSessions = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--iterations") && hasArg )
+            iterations = atoi( argv[++i] );
+        else if( !strcmp(argv[i],"--file") && hasArg )
+            file = argv[++i];
+        else {
+            usage();
+            return 1;
+        }
+    }
+    if( numCars < 1 || numCars > MAX_CARS || numClasses < 1 || numSessions < 1 || numSessions > MAX_SESSIONS || iterations < 1 ) {
+        usage();
+        return 1;
+    }
+
+    std::string str;
+    if( file )
+    {
+        FILE* fp = fopen( file, "rb" );
+        if( !fp ) {
+            printf( "Could not open %s\n", file );
+            return 1;
+        }
+        char buf[4096];
+        size_t n;
+        while( (n = fread(buf, 1, sizeof(buf), fp)) > 0 )
+            str.append( buf, n );
+        fclose( fp );
+    }
+    else
+        str = irsdk_makeSessionStr( numCars, numClasses, numSessions );
+
+    // Same answer from both parsers for every path, from the start and from
+    // every list item, which is where the old decoder started its searches
+    std::vector<const char*> starts( 1, str.c_str() );
+    for( const char* p = strstr(str.c_str(), "- "); p; p = strstr(p+2, "- ") )
+        starts.push_back( p );
+
+    int checked = 0, mismatches = 0;
+    for( const char* start : starts )
+    {
+        for( const char* path : g_paths )
+        {
+            const char* a = nullptr;
+            const char* b = nullptr;
+            int aLen = 0, bLen = 0;
+            const bool aFound = parseYamlBytewise( start, path, &a, &aLen );
+            const bool bFound = parseYaml( start, path, &b, &bLen );
+            if( aFound != bFound || a != b || aLen != bLen ) {
+                if( !mismatches )
+                    printf( "parseYaml differs for %s at offset %d\n", path, (int)(start - str.c_str()) );
+                mismatches++;
+            }
+            checked++;
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+
+    // a path that is not there, so the whole string gets scanned
+    double scanUs[2];
+    const ParseFn parsers[2] = { parseYamlBytewise, parseYaml };
+    for( int p=0; p<2; ++p )
+    {
+        const char* val = nullptr;
+        int len = 0;
+        const clock::time_point t = clock::now();
+        for( int i=0; i<iterations; ++i )
+            parsers[p]( str.c_str(), "NoSuchSection:NoSuchKey:", &val, &len );
+        scanUs[p] = std::chrono::duration<double,std::micro>( clock::now() - t ).count() / iterations;
+    }
+
+    Decoded bytewise;
+    g_parse = parseYamlBytewise;
+    const clock::time_point t0 = clock::now();
+    for( int i=0; i<iterations; ++i ) {
+        bytewise = Decoded();
+        decodeLegacy( str.c_str(), bytewise );
+    }
+    const double bytewiseUs = std::chrono::duration<double,std::micro>( clock::now() - t0 ).count() / iterations;
+
+    Decoded legacy;
+    g_parse = parseYaml;
+    const clock::time_point t1 = clock::now();
+    for( int i=0; i<iterations; ++i ) {
+        legacy = Decoded();
+        decodeLegacy( str.c_str(), legacy );
+    }
+    const double legacyUs = std::chrono::duration<double,std::micro>( clock::now() - t1 ).count() / iterations;
+
+    irsdkYamlIndex yaml;
+    Decoded indexed;
+    const clock::time_point t2 = clock::now();
+    for( int i=0; i<iterations; ++i ) {
+        indexed = Decoded();
+        decodeIndexed( yaml, str.c_str(), indexed );
+    }
+    const double indexedUs = std::chrono::duration<double,std::micro>( clock::now() - t2 ).count() / iterations;
+
+    const clock::time_point t3 = clock::now();
+    for( int i=0; i<iterations; ++i )
+        yaml.build( str.c_str() );
+    const double buildUs = std::chrono::duration<double,std::micro>( clock::now() - t3 ).count() / iterations;
+
+    // getSessionStrVal() style queries, full paths from the start of the string,
+    // answered by parseYaml() every time or by the memo after the first time
+    std::vector<std::string> queries;
+    const char* const carFields[] = { "UserName:", "TeamName:", "CarNumber:", "LicString:", "IRating:", "CarClassID:" };
+    for( int carIdx=0; carIdx<numCars; ++carIdx )
+    {
+        for( const char* field : carFields )
+        {
+            char path[256];
+            snprintf( path, sizeof(path), "DriverInfo:Drivers:CarIdx:{%d}%s", carIdx, field );
+            queries.push_back( path );
+        }
+    }
+
+    int memoMismatches = 0;
+    irsdkYamlMemo memo;
+    for( const std::string& q : queries )
+    {
+        const char* a = nullptr;
+        const char* b = nullptr;
+        int aLen = 0, bLen = 0;
+        const bool aFound = parseYaml( str.c_str(), q.c_str(), &a, &aLen );
+        const bool bFound = memo.parse( str.c_str(), q.c_str(), &b, &bLen );
+        if( aFound != bFound || (aFound && (a != b || aLen != bLen)) )
+            memoMismatches++;
+    }
+
+    const clock::time_point t4 = clock::now();
+    for( int i=0; i<iterations; ++i )
+        for( const std::string& q : queries ) {
+            const char* val = nullptr;
+            int len = 0;
+            parseYaml( str.c_str(), q.c_str(), &val, &len );
+        }
+    const double queryUs = std::chrono::duration<double,std::micro>( clock::now() - t4 ).count() / iterations;
+
+    const clock::time_point t5 = clock::now();
+    for( int i=0; i<iterations; ++i )
+        for( const std::string& q : queries ) {
+            const char* val = nullptr;
+            int len = 0;
+            memo.parse( str.c_str(), q.c_str(), &val, &len );
+        }
+    const double memoUs = std::chrono::duration<double,std::micro>( clock::now() - t5 ).count() / iterations;
+
+    printf( "session string:     %d bytes, %d nodes\n", (int)str.size(), yaml.getNumNodes() );
+    printf( "parseYaml bytewise: %9.1f us per decode, full scan %.0f MB/s\n", bytewiseUs, str.size() / scanUs[0] );
+    printf( "parseYaml:          %9.1f us per decode, full scan %.0f MB/s, %.1fx\n", legacyUs, str.size() / scanUs[1], bytewiseUs / legacyUs );
+    printf( "irsdkYamlIndex:     %9.1f us per decode (%.1f us to build the index), %.1fx\n", indexedUs, buildUs, bytewiseUs / indexedUs );
+    printf( "path lookups:       %d checked, %d differ\n", checked, mismatches );
+    printf( "%d full path queries: parseYaml %.1f us, irsdkYamlMemo %.1f us once cached, %.0fx, %d differ\n", (int)queries.size(), queryUs, memoUs, queryUs / memoUs, memoMismatches );
+
+    if( mismatches || memoMismatches || !(bytewise == legacy) || !(legacy == indexed) ) {
+        printf( "MISMATCH between the decodes\n" );
+        return 1;
+    }
+    printf( "results identical\n" );
+    return 0;
+}